@@ -74,11 +74,21 @@ WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
 //
 #define OC_ACPI_CPU_FREQUENCY_VARIABLE_NAME  L"acpi-cpu-frequency"
 
+//
+// Non-volatile variable used to cache CPU frequency calculated from ACPI across boots.
+//
+#define OC_CPU_FREQUENCY_CACHE_VARIABLE_NAME L"cpu-frequency-cache"
+
 //
 // Variable used to mark blacklisted RTC values.
 //
 #define OC_RTC_BLACKLIST_VARIABLE_NAME       L"rtc-blacklist"
 
+//
+// Boot services only variable with the key authenticating patched kernel cache.
+//
+#define OC_KERNEL_CACHE_KEY_VARIABLE_NAME    L"kernel-cache-key"
+
 //
 // Boot prefix used instead of normal Boot in OC_VENDOR_VARIABLE_GUID
 //
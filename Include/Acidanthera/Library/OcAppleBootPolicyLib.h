@@ -173,6 +173,45 @@ OcBootPolicyGetAllApfsRecoveryFilePath (
   OUT UINTN       *NumberOfEntries
   );
 
+/**
+  Enable directory listing cache for boot file lookups.
+  While enabled, every directory probed by boot policy is read once per
+  volume, and file existence checks are answered from the listing.
+  Intended to be enabled for the duration of a boot entry scan only,
+  as filesystem changes are not tracked. Previous cache is discarded.
+**/
+VOID
+OcBootPolicyEnableDirectoryCache (
+  VOID
+  );
+
+/**
+  Disable directory listing cache and free its contents.
+**/
+VOID
+OcBootPolicyDisableDirectoryCache (
+  VOID
+  );
+
+/**
+  Check file presence via directory listing cache.
+
+  @param[in]  Device     Device handle of the volume.
+  @param[in]  FilePath   File path relative to volume root.
+  @param[out] Attribute  File attributes on success, optional.
+
+  @retval EFI_SUCCESS      File is present.
+  @retval EFI_NOT_FOUND    File is missing.
+  @retval EFI_UNSUPPORTED  Cache is disabled or cannot answer,
+                           the file must be opened normally.
+**/
+EFI_STATUS
+OcBootPolicyCachedFileExists (
+  IN  EFI_HANDLE    Device,
+  IN  CONST CHAR16  *FilePath,
+  OUT UINT64        *Attribute  OPTIONAL
+  );
+
 extern CONST CHAR16 *gAppleBootPolicyPredefinedPaths[];
 
 ///
@@ -20,6 +20,21 @@
 #include <Library/OcAppleChunklistLib.h>
 #include <Library/OcAppleRamDiskLib.h>
 
+//
+// Amount of decompressed chunks kept in memory, current and read-ahead.
+//
+#define OC_APPLE_DISK_IMAGE_CACHED_CHUNKS  2
+
+//
+// Decompressed chunk cache entry.
+//
+typedef struct {
+    CONST APPLE_DISK_IMAGE_CHUNK      *Chunk;
+    UINT8                             *Data;
+    UINTN                             DataSize;
+    BOOLEAN                           ReadAhead;
+} OC_APPLE_DISK_IMAGE_CACHED_CHUNK;
+
 //
 // Disk image context.
 //
@@ -30,6 +45,16 @@ typedef struct {
 
     UINT32                            BlockCount;
     APPLE_DISK_IMAGE_BLOCK_DATA       **Blocks;
+
+    OC_APPLE_DISK_IMAGE_CACHED_CHUNK  CachedChunks[OC_APPLE_DISK_IMAGE_CACHED_CHUNKS];
+    UINT32                            LastCachedChunk;
+    UINTN                             NextLba;
+    UINT32                            SequentialReads;
+
+    UINT32                            CacheHits;
+    UINT32                            CacheMisses;
+    UINT32                            ReadAheads;
+    UINT32                            ReadAheadHits;
 } OC_APPLE_DISK_IMAGE_CONTEXT;
 
 BOOLEAN
@@ -68,6 +93,20 @@ OcAppleDiskImageRead (
   OUT VOID                         *Buffer
   );
 
+/**
+  Decompress the chunk following the last read ahead of time.
+  Does nothing unless recent reads were sequential.
+
+  @param[in,out] Context  Disk image context.
+
+  @retval TRUE   Next chunk is available in the cache.
+  @retval FALSE  Nothing was done.
+**/
+BOOLEAN
+OcAppleDiskImageReadAhead (
+  IN OUT OC_APPLE_DISK_IMAGE_CONTEXT  *Context
+  );
+
 EFI_HANDLE
 OcAppleDiskImageInstallBlockIo (
   IN  OC_APPLE_DISK_IMAGE_CONTEXT     *Context,
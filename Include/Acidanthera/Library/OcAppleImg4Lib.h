@@ -75,6 +75,23 @@ OcAppleImg4RegisterOverride (
   IN UINT32       ImageSize
   );
 
+/**
+  Register SHA-384 digest of the image computed while reading it. This allows
+  to avoid hashing the image again during verification. The digest is only
+  used for verifying this exact buffer and must be unregistered by passing
+  NULL Image before the buffer is modified or freed.
+
+  @param[in] Image            Pointer to the image or NULL to unregister.
+  @param[in] ImageSize        Image size.
+  @param[in] Digest           Image SHA-384 digest.
+**/
+VOID
+OcAppleImg4RegisterDigest (
+  IN CONST VOID   *Image  OPTIONAL,
+  IN UINTN        ImageSize,
+  IN CONST UINT8  *Digest OPTIONAL
+  );
+
 /**
   Obtain hardware model for secure booting from the model request.
 
@@ -391,6 +391,11 @@ typedef struct {
   UINT32       Limit;
 } PATCHER_GENERIC_PATCH;
 
+//
+// Number of hash buckets for built-in kext lookups in cacheless context.
+//
+#define CACHELESS_BUILTIN_KEXT_BUCKETS  128U
+
 //
 // Context for cacheless boot (S/L/E).
 //
@@ -420,6 +425,42 @@ typedef struct {
   //
   LIST_ENTRY            BuiltInKexts;
   //
+  // Hash buckets of built-in shipping kexts by bundle identifier.
+  //
+  LIST_ENTRY            BuiltInKextsByIdentifier[CACHELESS_BUILTIN_KEXT_BUCKETS];
+  //
+  // Hash buckets of built-in shipping kexts by plist path.
+  //
+  LIST_ENTRY            BuiltInKextsByPlistPath[CACHELESS_BUILTIN_KEXT_BUCKETS];
+  //
+  // Hash buckets of built-in shipping kexts by binary path.
+  //
+  LIST_ENTRY            BuiltInKextsByBinaryPath[CACHELESS_BUILTIN_KEXT_BUCKETS];
+  //
+  // Previously saved built-in kext index or NULL.
+  //
+  VOID                  *Index;
+  //
+  // Previously saved built-in kext index size.
+  //
+  UINT32                IndexSize;
+  //
+  // UUID of the volume containing Extensions directory.
+  //
+  GUID                  IndexVolumeUuid;
+  //
+  // Digest of Extensions directory, kext and plugin metadata.
+  //
+  UINT64                IndexExtensionsDigest;
+  //
+  // Built-in kext index is used.
+  //
+  BOOLEAN               UseIndex;
+  //
+  // Built-in kext list was rebuilt and the index needs to be saved.
+  //
+  BOOLEAN               IndexOutdated;
+  //
   // Current kernel version.
   //
   UINT32                KernelVersion;
@@ -1184,6 +1225,42 @@ CachelessContextFree (
   IN OUT CACHELESS_CONTEXT    *Context
   );
 
+/**
+  Enable built-in kext index for cacheless context. The index avoids parsing
+  every Info.plist in Extensions directory when it is still valid for the volume.
+
+  @param[in,out] Context         Cacheless context.
+  @param[in]     VolumeUuid      UUID of the volume containing Extensions directory.
+  @param[in]     Index           Previously saved index, optional.
+  @param[in]     IndexSize       Previously saved index size, optional.
+
+  @return  EFI_SUCCESS on success.
+**/
+EFI_STATUS
+CachelessContextSetIndex (
+  IN OUT CACHELESS_CONTEXT    *Context,
+  IN     CONST GUID           *VolumeUuid,
+  IN     CONST VOID           *Index OPTIONAL,
+  IN     UINT32               IndexSize OPTIONAL
+  );
+
+/**
+  Get built-in kext index to be saved if it was rebuilt during this boot.
+
+  @param[in,out] Context         Cacheless context.
+  @param[out]    Index           Serialized index allocated from pool.
+  @param[out]    IndexSize       Serialized index size.
+
+  @return  EFI_SUCCESS on success.
+  @return  EFI_ALREADY_STARTED when the index is up to date or not yet built.
+**/
+EFI_STATUS
+CachelessContextGetIndex (
+  IN OUT CACHELESS_CONTEXT    *Context,
+     OUT VOID                 **Index,
+     OUT UINT32               *IndexSize
+  );
+
 /**
   Add kext to cacheless context to be injected later on.
 
@@ -1317,6 +1394,10 @@ CachelessContextHookBuiltin (
   Specifying zero for OutBufferSize will calculate the size of the
   buffer required for the decompressed mkext in OutMkextSize.
 
+  Only plists are decompressed, kext binaries are copied as is and are
+  decompressed on first access through the mkext context. The calculated
+  size reserves space for this.
+
   @param[in]     Buffer               Mkext buffer.
   @param[in]     BufferSize           Mkext buffer size.
   @param[in]     NumReservedKexts     Number of kext slots to reserve for injection.
@@ -1358,8 +1439,10 @@ MkextCheckCpuType (
   Must be freed with MkextContextFree on success.
   Note that MkextAllocSize never changes, and is to be estimated.
 
-  Mkext buffers cannot contain any compression, and should be run
-  through MkextDecompress first.
+  Mkext buffers cannot contain compressed plists, and should be run
+  through MkextDecompress first. Compressed kext binaries are decompressed
+  on first access, e.g. when patching or blocking, and are passed through
+  compressed otherwise.
 
   @param[in,out] Context            Mkext context.
   @param[in,out] Mkext              Decompressed Mkext buffer.
@@ -81,6 +81,107 @@ DecompressLZVN (
   IN  UINTN        SrcLen
   );
 
+/**
+  Incremental LZSS decompression context.
+**/
+typedef struct OC_LZSS_STREAM_ OC_LZSS_STREAM;
+
+/**
+  Incremental LZVN decompression context.
+**/
+typedef struct OC_LZVN_STREAM_ OC_LZVN_STREAM;
+
+/**
+  Start incremental LZSS decompression into a preallocated buffer.
+  The source can then be passed in arbitrary chunks with DecompressLZSSStreamFeed.
+
+  @param[out]  Dst         Destination buffer.
+  @param[in]   DstLen      Destination buffer size.
+
+  @return  Decompression context on success otherwise NULL.
+**/
+OC_LZSS_STREAM *
+DecompressLZSSStreamInit (
+  OUT UINT8   *Dst,
+  IN  UINT32  DstLen
+  );
+
+/**
+  Decompress next chunk of LZSS source.
+
+  @param[in,out]  Stream      Decompression context.
+  @param[in]      Src         Source chunk.
+  @param[in]      SrcLen      Source chunk size.
+  @param[out]     DstPos      Amount of decompressed bytes so far, optional.
+
+  @return  FALSE when the source is found to be malformed.
+**/
+BOOLEAN
+DecompressLZSSStreamFeed (
+  IN OUT OC_LZSS_STREAM  *Stream,
+  IN     CONST UINT8     *Src,
+  IN     UINT32          SrcLen,
+     OUT UINT32          *DstPos  OPTIONAL
+  );
+
+/**
+  Finish incremental LZSS decompression and free the context.
+
+  @param[in]  Stream      Decompression context.
+
+  @return  DecompressedLen.
+**/
+UINT32
+DecompressLZSSStreamFinish (
+  IN OC_LZSS_STREAM  *Stream
+  );
+
+/**
+  Start incremental LZVN decompression into a preallocated buffer.
+  The source can then be passed in arbitrary chunks with DecompressLZVNStreamFeed.
+
+  @param[out]  Dst         Destination buffer.
+  @param[in]   DstLen      Destination buffer size.
+
+  @return  Decompression context on success otherwise NULL.
+**/
+OC_LZVN_STREAM *
+DecompressLZVNStreamInit (
+  OUT UINT8  *Dst,
+  IN  UINTN  DstLen
+  );
+
+/**
+  Decompress next chunk of LZVN source.
+  Incomplete instructions at chunk end are kept until the next call.
+
+  @param[in,out]  Stream      Decompression context.
+  @param[in]      Src         Source chunk.
+  @param[in]      SrcLen      Source chunk size.
+  @param[out]     DstPos      Amount of decompressed bytes so far, optional.
+
+  @return  FALSE when the source is found to be malformed.
+**/
+BOOLEAN
+DecompressLZVNStreamFeed (
+  IN OUT OC_LZVN_STREAM  *Stream,
+  IN     CONST UINT8     *Src,
+  IN     UINTN           SrcLen,
+     OUT UINTN           *DstPos  OPTIONAL
+  );
+
+/**
+  Finish incremental LZVN decompression and free the context.
+
+  @param[in]  Stream      Decompression context.
+
+  @return  DecompressedLen.
+**/
+UINTN
+DecompressLZVNStreamFinish (
+  IN OC_LZVN_STREAM  *Stream
+  );
+
 /**
   Compress buffer with ZLIB algorithm.
 
@@ -154,4 +255,19 @@ Adler32 (
   IN UINT32       BufferLen
   );
 
+/**
+  Continues Adler32 checksum calculation.
+  Start with Adler set to 1 to get the same result as Adler32.
+  @param[in]   Adler          Checksum of preceding data.
+  @param[in]   Buffer         Source buffer.
+  @param[in]   BufferLen      Source buffer size.
+  @return  Updated checksum.
+**/
+UINT32
+Adler32Update (
+  IN UINT32       Adler,
+  IN CONST UINT8  *Buffer,
+  IN UINT32       BufferLen
+  );
+
 #endif // OC_COMPRESSION_LIB_H
@@ -304,7 +304,9 @@
 #define OC_KERNEL_SCHEME_FIELDS(_, __) \
   _(OC_STRING                   , KernelArch       ,     , OC_STRING_CONSTR ("Auto", _, __), OC_DESTR (OC_STRING)) \
   _(OC_STRING                   , KernelCache      ,     , OC_STRING_CONSTR ("Auto", _, __), OC_DESTR (OC_STRING)) \
-  _(BOOLEAN                     , FuzzyMatch       ,     , FALSE  , ())
+  _(BOOLEAN                     , CachelessIndex   ,     , FALSE  , ()) \
+  _(BOOLEAN                     , FuzzyMatch       ,     , FALSE  , ()) \
+  _(BOOLEAN                     , PrelinkedCache   ,     , FALSE  , ())
   OC_DECLARE (OC_KERNEL_SCHEME)
 
 #define OC_KERNEL_CONFIG_FIELDS(_, __) \
@@ -662,6 +664,7 @@ typedef enum {
   _(UINT32                      , ExitBootServicesDelay       ,     , 0      , ()) \
   _(UINT32                      , TscSyncTimeout              ,     , 0      , ()) \
   _(BOOLEAN                     , ActivateHpetSupport         ,     , FALSE  , ()) \
+  _(BOOLEAN                     , CacheTscFrequency           ,     , FALSE  , ()) \
   _(BOOLEAN                     , DisableSecurityPolicy       ,     , FALSE  , ()) \
   _(BOOLEAN                     , IgnoreInvalidFlexRatio      ,     , FALSE  , ()) \
   _(BOOLEAN                     , ReleaseUsbOwnership         ,     , FALSE  , ()) \
@@ -197,6 +197,22 @@ OcCpuCorrectTscSync (
   IN UINTN        Timeout
   );
 
+/**
+  Persist TSC frequency calibrated via ACPI PM timer in NVRAM, so that
+  subsequent boots on the same CPU, microcode, and ratio configuration
+  skip the calibration. When the cached frequency was used on this boot,
+  it is verified in the background and updated for the next boot if needed.
+  The cache is read before the configuration is available, so disabling it
+  takes effect on the next boot.
+
+  @param[in]  Enable    Store or verify cached frequency when TRUE, discard it
+                        and stop reading it otherwise.
+**/
+VOID
+OcCpuUpdateFrequencyCache (
+  IN BOOLEAN  Enable
+  );
+
 /**
   Converts CPUID Family and Model extracted from EAX
   CPUID (1) call to AppleFamily value. This implements
@@ -27,6 +27,26 @@ WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
 ///
 #define MACHO_ALIGN(x) ALIGN_VALUE((x), MACHO_PAGE_SIZE)
 
+///
+/// Relocation lookup index entry.
+///
+typedef struct {
+  UINT64                Address;
+  UINT32                Sequence;
+  MACH_RELOCATION_INFO  *Relocation;
+} OC_MACHO_RELOCATION_INDEX_ENTRY;
+
+///
+/// Relocation lookup index sorted by target address.  It is created lazily on
+/// the first lookup.  When Entries is NULL after initialisation, lookups fall
+/// back to scanning the relocation table.
+///
+typedef struct {
+  OC_MACHO_RELOCATION_INDEX_ENTRY  *Entries;
+  UINT32                           NumEntries;
+  BOOLEAN                          Initialized;
+} OC_MACHO_RELOCATION_INDEX;
+
 ///
 /// Context used to refer to a Mach-O.  This struct is exposed for reference
 /// only.  Members are not guaranteed to be sane.
@@ -44,6 +64,9 @@ typedef struct {
   MACH_RELOCATION_INFO  *LocalRelocations;
   MACH_RELOCATION_INFO  *ExternRelocations;
 
+  OC_MACHO_RELOCATION_INDEX  ExternRelocationIndex;
+  OC_MACHO_RELOCATION_INDEX  LocalRelocationIndex;
+
   BOOLEAN               Is32Bit;
 } OC_MACHO_CONTEXT;
 
@@ -109,6 +132,20 @@ MachoInitializeContext (
   IN  BOOLEAN           Is32Bit
   );
 
+/**
+  Frees the relocation lookup indices lazily created for the Mach-O.
+  This must be called before Context is discarded or reinitialised, or before
+  its relocation tables are modified, once relocation lookups have been
+  performed on it.
+
+  @param[in,out] Context  Context of the Mach-O.
+
+**/
+VOID
+MachoFreeRelocationIndex (
+  IN OUT OC_MACHO_CONTEXT  *Context
+  );
+
 /**
   Returns the universal Mach-O Header structure.
 
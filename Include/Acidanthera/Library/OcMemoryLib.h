@@ -266,6 +266,96 @@ OcCountFreePages (
   OUT UINTN                  *LowerMemory  OPTIONAL
   );
 
+/**
+  Sorted and merged free memory intervals of the memory map.
+**/
+typedef struct {
+  ///
+  /// Interval start address.
+  ///
+  EFI_PHYSICAL_ADDRESS  Start;
+  ///
+  /// Interval end address (not inclusive).
+  ///
+  EFI_PHYSICAL_ADDRESS  End;
+  ///
+  /// Amount of free memory in bytes in all previous intervals.
+  ///
+  UINT64                FreeBefore;
+} OC_MEMORY_INTERVAL;
+
+typedef struct {
+  ///
+  /// Intervals sorted by start address.
+  ///
+  OC_MEMORY_INTERVAL    *Intervals;
+  ///
+  /// Amount of intervals.
+  ///
+  UINTN                 Count;
+} OC_MEMORY_INTERVALS;
+
+/**
+  Build free (conventional) memory intervals from the memory map.
+  Must be freed with OcMemoryIntervalsFree on success.
+
+  @param[out]    Intervals          Free memory intervals.
+  @param[in]     MemoryMapSize      Memory map size in bytes.
+  @param[in]     MemoryMap          Memory map to inspect.
+  @param[in]     DescriptorSize     Memory map descriptor size in bytes.
+
+  @retval EFI_SUCCESS on success.
+**/
+EFI_STATUS
+OcMemoryIntervalsInit (
+  OUT OC_MEMORY_INTERVALS    *Intervals,
+  IN  UINTN                  MemoryMapSize,
+  IN  EFI_MEMORY_DESCRIPTOR  *MemoryMap,
+  IN  UINTN                  DescriptorSize
+  );
+
+/**
+  Free memory intervals.
+
+  @param[in,out] Intervals          Free memory intervals.
+**/
+VOID
+OcMemoryIntervalsFree (
+  IN OUT OC_MEMORY_INTERVALS  *Intervals
+  );
+
+/**
+  Check whether memory range is entirely free in logarithmic time.
+
+  @param[in]     Intervals          Free memory intervals.
+  @param[in]     Start              Range start address.
+  @param[in]     End                Range end address (not inclusive).
+
+  @retval TRUE when the range consists of conventional memory only.
+**/
+BOOLEAN
+OcMemoryIntervalsIsFree (
+  IN CONST OC_MEMORY_INTERVALS  *Intervals,
+  IN EFI_PHYSICAL_ADDRESS       Start,
+  IN EFI_PHYSICAL_ADDRESS       End
+  );
+
+/**
+  Calculate amount of free memory in memory range in logarithmic time.
+
+  @param[in]     Intervals          Free memory intervals.
+  @param[in]     Start              Range start address.
+  @param[in]     End                Range end address (not inclusive).
+
+  @retval Amount of conventional memory in bytes within the range.
+**/
+UINT64
+OcMemoryIntervalsFreeSize (
+  IN CONST OC_MEMORY_INTERVALS  *Intervals,
+  IN EFI_PHYSICAL_ADDRESS       Start,
+  IN EFI_PHYSICAL_ADDRESS       End
+  );
+
 /**
   Print memory attributes table if present.
 **/
@@ -64,6 +64,30 @@ OcDecodePng (
   OUT  BOOLEAN  *HasAlphaType OPTIONAL
   );
 
+/**
+  Decodes PNG image into premultiplied EFI_GRAPHICS_OUTPUT_BLT_PIXEL buffer.
+  Non-interlaced 8-bit RGB and RGBA images are decoded directly,
+  other images are decoded with OcDecodePng and converted.
+
+  @param  Buffer                 Buffer with desired png image
+  @param  Size                   Size of input image
+  @param  RawData                Output buffer with premultiplied BGRA pixels
+  @param  Width                  Image width at output
+  @param  Height                 Image height at output
+
+  @return EFI_SUCCESS            The function completed successfully.
+  @return EFI_OUT_OF_RESOURCES   There are not enough resources to init state.
+  @return EFI_INVALID_PARAMETER  Passed wrong parameter
+**/
+EFI_STATUS
+OcDecodePngPremultiplied (
+  IN   VOID     *Buffer,
+  IN   UINTN    Size,
+  OUT  VOID     **RawData,
+  OUT  UINT32   *Width,
+  OUT  UINT32   *Height
+  );
+
 /**
   Encodes raw pixel buffer into PNG image data
 
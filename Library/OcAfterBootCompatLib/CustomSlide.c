@@ -235,21 +235,17 @@ ShouldUseCustomSlideOffset (
   EFI_PHYSICAL_ADDRESS   AllocatedMapPages;
   UINTN                  MemoryMapSize;
   EFI_MEMORY_DESCRIPTOR  *MemoryMap;
-  EFI_MEMORY_DESCRIPTOR  *Desc;
   UINTN                  MapKey;
   EFI_STATUS             Status;
   UINTN                  DescriptorSize;
   UINT32                 DescriptorVersion;
-  UINTN                  Index;
   UINTN                  Slide;
-  UINTN                  NumEntries;
   UINT64                 MaxAvailableSize;
   UINT8                  FallbackSlide;
-  BOOLEAN                Supported;
   UINTN                  StartAddr;
   UINTN                  EndAddr;
-  EFI_PHYSICAL_ADDRESS   DescEndAddr;
   UINT64                 AvailableSize;
+  OC_MEMORY_INTERVALS    FreeIntervals;
 
   MaxAvailableSize = 0;
   FallbackSlide    = 0;
@@ -287,9 +283,18 @@ ShouldUseCustomSlideOffset (
 
   //
   // At this point we have a memory map that we could use to
-  // determine what slide values are allowed.
+  // determine what slide values are allowed. Index free memory once,
+  // so that every slide is checked in logarithmic time.
   //
-  NumEntries = MemoryMapSize / DescriptorSize;
+  Status = OcMemoryIntervalsInit (&FreeIntervals, MemoryMapSize, MemoryMap, DescriptorSize);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_WARN, "OCABC: Failed to index memory map for KASLR - %r\n", Status));
+    gBS->FreePages (
+      (EFI_PHYSICAL_ADDRESS)(UINTN) MemoryMap,
+      (UINTN) AllocatedMapPages
+      );
+    return FALSE;
+  }
 
   //
   // Reset valid slides to zero and find actually working ones.
@@ -297,9 +302,6 @@ ShouldUseCustomSlideOffset (
   SlideSupport->ValidSlideCount = 0;
 
   for (Slide = 0; Slide < TOTAL_SLIDE_NUM; ++Slide) {
-    Desc      = MemoryMap;
-    Supported = TRUE;
-
     GetSlideRangeForValue (
       SlideSupport->EstimatedKernelArea,
       SlideSupport->HasSandyOrIvy,
@@ -308,51 +310,10 @@ ShouldUseCustomSlideOffset (
       &EndAddr
       );
 
-    AvailableSize = 0;
-
-    for (Index = 0; Index < NumEntries; ++Index) {
-      if (Desc->NumberOfPages == 0) {
-        continue;
-      }
-
-      DescEndAddr = LAST_DESCRIPTOR_ADDR (Desc) + 1;
-
-      if ((Desc->PhysicalStart < EndAddr) && (DescEndAddr > StartAddr)) {
-        //
-        // The memory overlaps with the slide region.
-        //
-        if (Desc->Type != EfiConventionalMemory) {
-          //
-          // The memory is unusable atm.
-          //
-          Supported = FALSE;
-          break;
-        } else {
-          //
-          // The memory will be available for the kernel.
-          //
-          AvailableSize += EFI_PAGES_TO_SIZE (Desc->NumberOfPages);
-
-          if (Desc->PhysicalStart < StartAddr) {
-            //
-            // The region starts before the slide region.
-            // Subtract the memory that is located before the slide region.
-            //
-            AvailableSize -= (StartAddr - Desc->PhysicalStart);
-          }
-
-          if (DescEndAddr > EndAddr) {
-            //
-            // The region ends after the slide region.
-            // Subtract the memory that is located after the slide region.
-            //
-            AvailableSize -= (DescEndAddr - EndAddr);
-          }
-        }
-      }
-
-      Desc = NEXT_MEMORY_DESCRIPTOR (Desc, DescriptorSize);
-    }
+    //
+    // The memory will be available for the kernel.
+    //
+    AvailableSize = OcMemoryIntervalsFreeSize (&FreeIntervals, StartAddr, EndAddr);
 
     if (AvailableSize > MaxAvailableSize) {
       MaxAvailableSize = AvailableSize;
@@ -367,18 +328,16 @@ ShouldUseCustomSlideOffset (
       break;
     }
 
-    if ((StartAddr + AvailableSize) != EndAddr) {
-      //
-      // The slide region is not continuous.
-      //
-      Supported = FALSE;
-    }
-
-    if (Supported) {
+    //
+    // The slide region must be continuous and consist of free memory only.
+    //
+    if (OcMemoryIntervalsIsFree (&FreeIntervals, StartAddr, EndAddr)) {
       SlideSupport->ValidSlides[SlideSupport->ValidSlideCount++] = (UINT8) Slide;
     }
   }
 
+  OcMemoryIntervalsFree (&FreeIntervals);
+
   //
   // Okay, we are done.
   //
@@ -0,0 +1,463 @@
+/** @file
+  Copyright (C) 2026, agent. All rights reserved.
+
+  All rights reserved.
+
+  This program and the accompanying materials
+  are licensed and made available under the terms and conditions of the BSD License
+  which accompanies this distribution.  The full text of the license may be found at
+  http://opensource.org/licenses/bsd-license.php
+
+  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+**/
+
+#include <Guid/FileInfo.h>
+
+#include <Protocol/SimpleFileSystem.h>
+
+#include <Library/OcAppleBootPolicyLib.h>
+#include <Library/OcFileLib.h>
+#include <Library/OcStringLib.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/OcDebugLogLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+
+#include "BootPolicyInternal.h"
+
+typedef struct {
+  UINT64  Attribute;
+  CHAR16  *Name;
+} BOOT_POLICY_DIR_ENTRY;
+
+typedef struct {
+  LIST_ENTRY             Link;
+  EFI_HANDLE             Device;
+  CHAR16                 *Path;
+  BOOLEAN                Valid;
+  UINTN                  NumEntries;
+  BOOT_POLICY_DIR_ENTRY  *Entries;
+} BOOT_POLICY_DIR_CACHE;
+
+#define BOOT_POLICY_DIR_CACHE_FROM_LINK(This) \
+  BASE_CR ((This), BOOT_POLICY_DIR_CACHE, Link)
+
+///
+/// Initial amount of entries allocated per directory.
+///
+#define BOOT_POLICY_DIR_CACHE_MIN_ENTRIES  16
+
+STATIC BOOLEAN     mBootPolicyCacheEnabled;
+STATIC LIST_ENTRY  mBootPolicyCache = INITIALIZE_LIST_HEAD_VARIABLE (mBootPolicyCache);
+
+STATIC
+VOID
+InternalFreeDirectoryEntries (
+  IN OUT BOOT_POLICY_DIR_CACHE  *Node
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < Node->NumEntries; ++Index) {
+    FreePool (Node->Entries[Index].Name);
+  }
+
+  if (Node->Entries != NULL) {
+    FreePool (Node->Entries);
+  }
+
+  Node->Entries    = NULL;
+  Node->NumEntries = 0;
+}
+
+/**
+  Read all entries of Directory into Node.
+
+  @param[in]     Directory  Opened directory.
+  @param[in,out] Node       Cache node to fill.
+
+  @retval EFI_SUCCESS on success.
+**/
+STATIC
+EFI_STATUS
+InternalReadDirectory (
+  IN     EFI_FILE_PROTOCOL      *Directory,
+  IN OUT BOOT_POLICY_DIR_CACHE  *Node
+  )
+{
+  EFI_STATUS             Status;
+  EFI_FILE_INFO          *FileInfo;
+  UINTN                  FileInfoSize;
+  UINTN                  Capacity;
+  BOOT_POLICY_DIR_ENTRY  *Entries;
+  CHAR16                 *Name;
+
+  FileInfo = AllocatePool (SIZE_1KB);
+  if (FileInfo == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Capacity = 0;
+  Status   = Directory->SetPosition (Directory, 0);
+
+  while (!EFI_ERROR (Status)) {
+    //
+    // Apple's HFS+ driver does not adhere to the spec and will return zero for
+    // EFI_BUFFER_TOO_SMALL. EFI_FILE_INFO structures larger than 1KB are
+    // unrealistic as the filename is the only variable.
+    //
+    FileInfoSize = SIZE_1KB - sizeof (CHAR16);
+    Status = Directory->Read (Directory, &FileInfoSize, FileInfo);
+    if (EFI_ERROR (Status) || FileInfoSize == 0) {
+      break;
+    }
+
+    if (FileInfoSize <= SIZE_OF_EFI_FILE_INFO) {
+      Status = EFI_VOLUME_CORRUPTED;
+      break;
+    }
+
+    ((CHAR16 *) FileInfo)[SIZE_1KB / sizeof (CHAR16) - 1] = L'\0';
+    Name = FileInfo->FileName;
+
+    if (StrCmp (Name, L".") == 0 || StrCmp (Name, L"..") == 0) {
+      continue;
+    }
+
+    if (Node->NumEntries == Capacity) {
+      Capacity = MAX (Capacity * 2, BOOT_POLICY_DIR_CACHE_MIN_ENTRIES);
+      Entries  = ReallocatePool (
+        Node->NumEntries * sizeof (Node->Entries[0]),
+        Capacity * sizeof (Node->Entries[0]),
+        Node->Entries
+        );
+      if (Entries == NULL) {
+        Status = EFI_OUT_OF_RESOURCES;
+        break;
+      }
+      Node->Entries = Entries;
+    }
+
+    Node->Entries[Node->NumEntries].Name = AllocateCopyPool (StrSize (Name), Name);
+    if (Node->Entries[Node->NumEntries].Name == NULL) {
+      Status = EFI_OUT_OF_RESOURCES;
+      break;
+    }
+
+    Node->Entries[Node->NumEntries].Attribute = FileInfo->Attribute;
+    ++Node->NumEntries;
+  }
+
+  Directory->SetPosition (Directory, 0);
+  FreePool (FileInfo);
+
+  if (EFI_ERROR (Status)) {
+    InternalFreeDirectoryEntries (Node);
+  }
+
+  return Status;
+}
+
+/**
+  Get cached directory listing, reading it on first access.
+
+  @param[in]     Device      Device handle of the volume.
+  @param[in]     Root        Directory RelPath is relative to, optional.
+  @param[in,out] VolumeRoot  Lazily opened volume root when Root is NULL.
+  @param[in]     Path        Directory path relative to volume root.
+  @param[in]     RelPath     Directory path relative to Root.
+
+  @retval Cached directory or NULL.
+**/
+STATIC
+BOOT_POLICY_DIR_CACHE *
+InternalGetCachedDirectory (
+  IN     EFI_HANDLE         Device,
+  IN     EFI_FILE_PROTOCOL  *Root        OPTIONAL,
+  IN OUT EFI_FILE_PROTOCOL  **VolumeRoot,
+  IN     CONST CHAR16       *Path,
+  IN     CONST CHAR16       *RelPath
+  )
+{
+  EFI_STATUS                       Status;
+  LIST_ENTRY                       *Link;
+  BOOT_POLICY_DIR_CACHE            *Node;
+  EFI_SIMPLE_FILE_SYSTEM_PROTOCOL  *FileSystem;
+  EFI_FILE_PROTOCOL                *Directory;
+
+  for (
+    Link = GetFirstNode (&mBootPolicyCache);
+    !IsNull (&mBootPolicyCache, Link);
+    Link = GetNextNode (&mBootPolicyCache, Link)) {
+    Node = BOOT_POLICY_DIR_CACHE_FROM_LINK (Link);
+    if (Node->Device == Device && StrCmp (Node->Path, Path) == 0) {
+      return Node;
+    }
+  }
+
+  Node = AllocateZeroPool (sizeof (*Node));
+  if (Node == NULL) {
+    return NULL;
+  }
+
+  Node->Device = Device;
+  Node->Path   = AllocateCopyPool (StrSize (Path), Path);
+  if (Node->Path == NULL) {
+    FreePool (Node);
+    return NULL;
+  }
+
+  Status = EFI_SUCCESS;
+
+  if (Root == NULL) {
+    if (*VolumeRoot == NULL) {
+      Status = gBS->HandleProtocol (
+        Device,
+        &gEfiSimpleFileSystemProtocolGuid,
+        (VOID **) &FileSystem
+        );
+      if (!EFI_ERROR (Status)) {
+        Status = FileSystem->OpenVolume (FileSystem, VolumeRoot);
+        if (EFI_ERROR (Status)) {
+          *VolumeRoot = NULL;
+        }
+      }
+    }
+
+    Root = *VolumeRoot;
+  }
+
+  if (!EFI_ERROR (Status)) {
+    if (RelPath[0] == L'\0') {
+      Status = InternalReadDirectory (Root, Node);
+    } else {
+      Status = SafeFileOpen (Root, &Directory, RelPath, EFI_FILE_MODE_READ, 0);
+      if (!EFI_ERROR (Status)) {
+        Status = InternalReadDirectory (Directory, Node);
+        Directory->Close (Directory);
+      }
+    }
+  }
+
+  //
+  // Failed reads are cached as well to avoid retrying them during the scan.
+  //
+  Node->Valid = !EFI_ERROR (Status);
+
+  DEBUG ((
+    DEBUG_BULK_INFO,
+    "OCBP: Cached %u entries of %p:\\%s - %r\n",
+    (UINT32) Node->NumEntries,
+    Device,
+    Path,
+    Status
+    ));
+
+  InsertTailList (&mBootPolicyCache, &Node->Link);
+  return Node;
+}
+
+/**
+  Find directory entry by name.
+
+  @param[in]  Node       Cached directory.
+  @param[in]  Name       Entry name, not necessarily null-terminated.
+  @param[in]  Length     Entry name length.
+  @param[out] Attribute  Entry attributes.
+
+  @retval EFI_SUCCESS      Entry is present.
+  @retval EFI_NOT_FOUND    Entry is missing.
+  @retval EFI_UNSUPPORTED  Entry differs only in case, which is ambiguous
+                           without knowing filesystem case sensitivity.
+**/
+STATIC
+EFI_STATUS
+InternalFindDirectoryEntry (
+  IN  BOOT_POLICY_DIR_CACHE  *Node,
+  IN  CONST CHAR16           *Name,
+  IN  UINTN                  Length,
+  OUT UINT64                 *Attribute
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       Index;
+  CHAR16      *EntryName;
+
+  Status = EFI_NOT_FOUND;
+
+  for (Index = 0; Index < Node->NumEntries; ++Index) {
+    EntryName = Node->Entries[Index].Name;
+    if (StrLen (EntryName) != Length || OcStrniCmp (EntryName, Name, Length) != 0) {
+      continue;
+    }
+
+    if (StrnCmp (EntryName, Name, Length) == 0) {
+      *Attribute = Node->Entries[Index].Attribute;
+      return EFI_SUCCESS;
+    }
+
+    Status = EFI_UNSUPPORTED;
+  }
+
+  return Status;
+}
+
+EFI_STATUS
+InternalCachedFileExists (
+  IN  EFI_HANDLE         Device,
+  IN  EFI_FILE_PROTOCOL  *Root       OPTIONAL,
+  IN  CONST CHAR16       *Prefix     OPTIONAL,
+  IN  CONST CHAR16       *FileName,
+  OUT UINT64             *Attribute  OPTIONAL
+  )
+{
+  EFI_STATUS             Status;
+  EFI_FILE_PROTOCOL      *VolumeRoot;
+  BOOT_POLICY_DIR_CACHE  *Node;
+  CHAR16                 *Path;
+  UINTN                  PathSize;
+  UINTN                  PathLength;
+  UINTN                  PrefixLength;
+  UINTN                  Length;
+  UINT64                 EntryAttribute;
+
+  ASSERT (Root != NULL || Prefix == NULL);
+  ASSERT (FileName != NULL);
+
+  if (!mBootPolicyCacheEnabled) {
+    return EFI_UNSUPPORTED;
+  }
+
+  if (Prefix != NULL) {
+    while (*Prefix == L'\\') {
+      ++Prefix;
+    }
+  } else {
+    Prefix = L"";
+  }
+
+  //
+  // Path holds the directory being looked up relative to volume root,
+  // with the part after Prefix being relative to Root.
+  //
+  PathSize = StrSize (Prefix) + StrSize (FileName);
+  Path     = AllocatePool (PathSize);
+  if (Path == NULL) {
+    return EFI_UNSUPPORTED;
+  }
+
+  StrCpyS (Path, PathSize / sizeof (CHAR16), Prefix);
+  PrefixLength   = StrLen (Path);
+  PathLength     = PrefixLength;
+  VolumeRoot     = NULL;
+  EntryAttribute = EFI_FILE_DIRECTORY;
+  Status         = EFI_SUCCESS;
+
+  while (TRUE) {
+    while (*FileName == L'\\') {
+      ++FileName;
+    }
+
+    if (*FileName == L'\0') {
+      break;
+    }
+
+    //
+    // Intermediate path component is not a directory.
+    //
+    if ((EntryAttribute & EFI_FILE_DIRECTORY) == 0) {
+      Status = EFI_NOT_FOUND;
+      break;
+    }
+
+    Length = 0;
+    while (FileName[Length] != L'\0' && FileName[Length] != L'\\') {
+      ++Length;
+    }
+
+    if (FileName[0] == L'.' && (Length == 1 || (Length == 2 && FileName[1] == L'.'))) {
+      Status = EFI_UNSUPPORTED;
+      break;
+    }
+
+    Node = InternalGetCachedDirectory (
+      Device,
+      Root,
+      &VolumeRoot,
+      Path,
+      PathLength > PrefixLength ? &Path[PrefixLength + (PrefixLength > 0 ? 1 : 0)] : L""
+      );
+    if (Node == NULL || !Node->Valid) {
+      Status = EFI_UNSUPPORTED;
+      break;
+    }
+
+    Status = InternalFindDirectoryEntry (Node, FileName, Length, &EntryAttribute);
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+
+    if (PathLength > 0) {
+      Path[PathLength++] = L'\\';
+    }
+    CopyMem (&Path[PathLength], FileName, Length * sizeof (CHAR16));
+    PathLength      += Length;
+    Path[PathLength] = L'\0';
+    FileName        += Length;
+  }
+
+  if (VolumeRoot != NULL) {
+    VolumeRoot->Close (VolumeRoot);
+  }
+
+  FreePool (Path);
+
+  if (!EFI_ERROR (Status) && Attribute != NULL) {
+    *Attribute = EntryAttribute;
+  }
+
+  return Status;
+}
+
+VOID
+OcBootPolicyEnableDirectoryCache (
+  VOID
+  )
+{
+  OcBootPolicyDisableDirectoryCache ();
+  mBootPolicyCacheEnabled = TRUE;
+}
+
+VOID
+OcBootPolicyDisableDirectoryCache (
+  VOID
+  )
+{
+  BOOT_POLICY_DIR_CACHE  *Node;
+
+  mBootPolicyCacheEnabled = FALSE;
+
+  while (!IsListEmpty (&mBootPolicyCache)) {
+    Node = BOOT_POLICY_DIR_CACHE_FROM_LINK (GetFirstNode (&mBootPolicyCache));
+    RemoveEntryList (&Node->Link);
+    InternalFreeDirectoryEntries (Node);
+    FreePool (Node->Path);
+    FreePool (Node);
+  }
+}
+
+EFI_STATUS
+OcBootPolicyCachedFileExists (
+  IN  EFI_HANDLE    Device,
+  IN  CONST CHAR16  *FilePath,
+  OUT UINT64        *Attribute  OPTIONAL
+  )
+{
+  if (Device == NULL || FilePath == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  return InternalCachedFileExists (Device, NULL, NULL, FilePath, Attribute);
+}
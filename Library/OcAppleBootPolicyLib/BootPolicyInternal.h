@@ -0,0 +1,46 @@
+/** @file
+  Copyright (C) 2026, agent. All rights reserved.
+
+  All rights reserved.
+
+  This program and the accompanying materials
+  are licensed and made available under the terms and conditions of the BSD License
+  which accompanies this distribution.  The full text of the license may be found at
+  http://opensource.org/licenses/bsd-license.php
+
+  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+**/
+
+#ifndef BOOT_POLICY_INTERNAL_H
+#define BOOT_POLICY_INTERNAL_H
+
+#include <Uefi.h>
+
+#include <Protocol/SimpleFileSystem.h>
+
+/**
+  Look up file presence in the directory listing cache.
+
+  @param[in]  Device     Device handle of the volume.
+  @param[in]  Root       Directory FileName is relative to, optional.
+                         Volume root is opened on demand when NULL.
+  @param[in]  Prefix     Path of Root relative to volume root, optional.
+  @param[in]  FileName   File path relative to Root.
+  @param[out] Attribute  File attributes on success, optional.
+
+  @retval EFI_SUCCESS      File is present.
+  @retval EFI_NOT_FOUND    File is missing.
+  @retval EFI_UNSUPPORTED  Cache is disabled or cannot answer,
+                           the file must be opened normally.
+**/
+EFI_STATUS
+InternalCachedFileExists (
+  IN  EFI_HANDLE         Device,
+  IN  EFI_FILE_PROTOCOL  *Root       OPTIONAL,
+  IN  CONST CHAR16       *Prefix     OPTIONAL,
+  IN  CONST CHAR16       *FileName,
+  OUT UINT64             *Attribute  OPTIONAL
+  );
+
+#endif // BOOT_POLICY_INTERNAL_H
@@ -34,6 +34,8 @@
 #include <Library/PrintLib.h>
 #include <Library/UefiBootServicesTableLib.h>
 
+#include "BootPolicyInternal.h"
+
 typedef struct {
   EFI_HANDLE             Handle;
   GUID                   ContainerGuid;
@@ -140,7 +142,9 @@ STATIC APPLE_BOOT_POLICY_PROTOCOL mAppleBootPolicyProtocol = {
 /**
   Checks whether the given file exists or not.
 
-  @param[in] Root      The volume's opened root.
+  @param[in] Device    The volume's device handle.
+  @param[in] Root      The volume's opened root or directory.
+  @param[in] Prefix    Path of Root directory relative to volume root.
   @param[in] FileName  The path of the file to check.
 
   @return  Returned is whether the specified file exists or not.
@@ -149,13 +153,20 @@ STATIC APPLE_BOOT_POLICY_PROTOCOL mAppleBootPolicyProtocol = {
 STATIC
 EFI_STATUS
 InternalFileExists (
+  IN EFI_HANDLE       Device,
   IN EFI_FILE_HANDLE  Root,
+  IN CONST CHAR16     *Prefix  OPTIONAL,
   IN CONST CHAR16     *FileName
   )
 {
   EFI_STATUS      Status;
   EFI_FILE_HANDLE FileHandle;
 
+  Status = InternalCachedFileExists (Device, Root, Prefix, FileName, NULL);
+  if (Status != EFI_UNSUPPORTED) {
+    return Status;
+  }
+
   Status = SafeFileOpen (
     Root,
     &FileHandle,
@@ -349,7 +360,7 @@ InternalGetBooterFromBlessedSystemFolderPath (
     return Status;
   }
 
-  Status = InternalFileExists (Root, BooterPath);
+  Status = InternalFileExists (Device, Root, NULL, BooterPath);
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_BULK_INFO, "OCBP: Blessed folder %s is missing - %r\n", BooterPath, Status));
     return EFI_NOT_FOUND;
@@ -386,7 +397,9 @@ OcGetBooterFromPredefinedPathList (
       ASSERT (PathName[0] == L'\\');
     }
     Status = InternalFileExists (
+      Device,
       Root,
+      Prefix,
       Prefix != NULL ? &PathName[1] : &PathName[0]
       );
     if (!EFI_ERROR (Status)) {
@@ -503,6 +516,18 @@ InternalGetBooterFromApfsVolumePredefinedPathList (
   EFI_STATUS        Status;
   EFI_FILE_PROTOCOL *VolumeDirectoryHandle;
   EFI_FILE_INFO     *VolumeDirectoryInfo;
+  UINT64            Attribute;
+
+  //
+  // Most volumes in the container have no directory on Preboot,
+  // so consult Preboot root listing before trying to open it.
+  //
+  Status = InternalCachedFileExists (Device, PrebootRoot, NULL, VolumeDirectoryName, &Attribute);
+  if (Status == EFI_NOT_FOUND
+    || (!EFI_ERROR (Status) && (Attribute & EFI_FILE_DIRECTORY) == 0)) {
+    DEBUG ((DEBUG_BULK_INFO, "OCBP: Missing cached partition %s on preboot\n", VolumeDirectoryName));
+    return EFI_NOT_FOUND;
+  }
 
   Status = SafeFileOpen (
     PrebootRoot,
@@ -1201,6 +1226,7 @@ OcBootPolicyGetApfsRecoveryFilePath (
   EFI_FILE_PROTOCOL               *NewHandle;
 
   EFI_FILE_INFO                   *FileInfo;
+  UINT64                          Attribute;
 
   ASSERT (DevicePath != NULL);
   ASSERT (PathName != NULL);
@@ -1299,17 +1325,11 @@ OcBootPolicyGetApfsRecoveryFilePath (
       continue;
     }
 
-    Status = FileSystem->OpenVolume (FileSystem, Root);
-    if (EFI_ERROR (Status)) {
-      continue;
-    }
-
     FullPathNameSize  = sizeof (CHAR16) + StrSize (PathName);
     FullPathNameSize += GUID_STRING_LENGTH * sizeof (CHAR16);
     FullPathBuffer    = AllocateZeroPool (FullPathNameSize);
 
     if (FullPathBuffer == NULL) {
-      (*Root)->Close (*Root);
       continue;
     }
 
@@ -1325,6 +1345,23 @@ OcBootPolicyGetApfsRecoveryFilePath (
       PathName
       );
 
+    //
+    // Recovery volumes are probed for every blessed entry in the container,
+    // skip opening them when the cached listing has no such directory.
+    //
+    Status = InternalCachedFileExists (HandleBuffer[Index], NULL, NULL, FullPathBuffer, &Attribute);
+    if (Status == EFI_NOT_FOUND
+      || (!EFI_ERROR (Status) && (Attribute & EFI_FILE_DIRECTORY) == 0)) {
+      FreePool (FullPathBuffer);
+      continue;
+    }
+
+    Status = FileSystem->OpenVolume (FileSystem, Root);
+    if (EFI_ERROR (Status)) {
+      FreePool (FullPathBuffer);
+      continue;
+    }
+
     Status = SafeFileOpen (
       *Root,
       &NewHandle,
@@ -1429,6 +1466,7 @@ OcBootPolicyGetAllApfsRecoveryFilePath (
   EFI_FILE_PROTOCOL               *NewHandle;
   CHAR16                          VolumePathName[GUID_STRING_LENGTH + 1];
   EFI_FILE_INFO                   *FileInfo;
+  UINT64                          Attribute;
   APFS_VOLUME_ROOT                *ApfsRoot;
 
   ASSERT (Volumes != NULL);
@@ -1577,41 +1615,59 @@ OcBootPolicyGetAllApfsRecoveryFilePath (
           &VolumeInfo[Index3].VolumeGuid
           );
 
-        Status = SafeFileOpen (
+        Status = InternalCachedFileExists (
+          VolumeInfo[Index2].Handle,
           Root,
-          &NewHandle,
+          NULL,
           VolumePathName,
-          EFI_FILE_MODE_READ,
-          0
+          &Attribute
           );
 
-        if (EFI_ERROR (Status)) {
+        if (Status == EFI_NOT_FOUND) {
           continue;
         }
 
-        FileInfo = GetFileInfo (
-                     NewHandle,
-                     &gEfiFileInfoGuid,
-                     sizeof (*FileInfo),
-                     NULL
-                     );
-
-        NewHandle->Close (NewHandle);
-
-        if (FileInfo != NULL) {
-          if ((FileInfo->Attribute & EFI_FILE_DIRECTORY) != 0) {
-            ApfsRoot = ApfsVolumes[*NumberOfEntries];
-            ApfsRoot->Handle = VolumeInfo[Index2].Handle;
-            ApfsRoot->VolumeDirName = AllocateCopyPool (
-                                        StrSize (VolumePathName),
-                                        VolumePathName
-                                        );
-            ApfsRoot->Root = Root;
-
-            ++(*NumberOfEntries);
+        if (EFI_ERROR (Status)) {
+          Status = SafeFileOpen (
+            Root,
+            &NewHandle,
+            VolumePathName,
+            EFI_FILE_MODE_READ,
+            0
+            );
+
+          if (EFI_ERROR (Status)) {
+            continue;
+          }
+
+          FileInfo = GetFileInfo (
+                       NewHandle,
+                       &gEfiFileInfoGuid,
+                       sizeof (*FileInfo),
+                       NULL
+                       );
+
+          NewHandle->Close (NewHandle);
+
+          if (FileInfo == NULL) {
+            continue;
           }
+
+          Attribute = FileInfo->Attribute;
           FreePool (FileInfo);
         }
+
+        if ((Attribute & EFI_FILE_DIRECTORY) != 0) {
+          ApfsRoot = ApfsVolumes[*NumberOfEntries];
+          ApfsRoot->Handle = VolumeInfo[Index2].Handle;
+          ApfsRoot->VolumeDirName = AllocateCopyPool (
+                                      StrSize (VolumePathName),
+                                      VolumePathName
+                                      );
+          ApfsRoot->Root = Root;
+
+          ++(*NumberOfEntries);
+        }
       }
     }
   }
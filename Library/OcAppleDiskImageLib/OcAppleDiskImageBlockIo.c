@@ -15,6 +15,7 @@
 #include <Protocol/AppleDiskImage.h>
 #include <Protocol/AppleRamDisk.h>
 #include <Protocol/BlockIo.h>
+#include <Protocol/BlockIo2.h>
 
 #include <Library/BaseMemoryLib.h>
 #include <Library/DebugLib.h>
@@ -30,6 +31,12 @@
 
 #define DMG_FILE_PATH_LEN  (L_STR_LEN (L"DMG_.dmg") + 16 + 1)
 
+//
+// Idle time after the last read before the next chunk is decompressed,
+// in 100ns units. Every new read postpones read-ahead.
+//
+#define DMG_READ_AHEAD_DELAY  10000ULL
+
 #pragma pack(push, 1)
 
 typedef PACKED struct {
@@ -64,42 +71,56 @@ typedef PACKED struct {
     BlockIo                                               \
     )
 
+#define OC_APPLE_DISK_IMAGE_MOUNTED_DATA_FROM_BLOCK_IO2(This)  \
+  BASE_CR (                                                    \
+    (This),                                                    \
+    OC_APPLE_DISK_IMAGE_MOUNTED_DATA,                          \
+    BlockIo2                                                   \
+    )
+
 typedef struct {
   UINT32                      Signature;
 
   EFI_BLOCK_IO_PROTOCOL       BlockIo;
+  EFI_BLOCK_IO2_PROTOCOL      BlockIo2;
   EFI_BLOCK_IO_MEDIA          BlockIoMedia;
   DMG_DEVICE_PATH             DevicePath;
 
   OC_APPLE_DISK_IMAGE_CONTEXT *ImageContext;
+  EFI_EVENT                   ReadAheadEvent;
 } OC_APPLE_DISK_IMAGE_MOUNTED_DATA;
 
 STATIC
-EFI_STATUS
+VOID
 EFIAPI
-DiskImageBlockIoReset (
-  IN EFI_BLOCK_IO_PROTOCOL  *This,
-  IN BOOLEAN                ExtendedVerification
+DiskImageReadAheadNotify (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
   )
 {
-  return EFI_SUCCESS;
+  OC_APPLE_DISK_IMAGE_MOUNTED_DATA *DiskImageData;
+
+  DiskImageData = Context;
+  if (DiskImageData->Signature != OC_APPLE_DISK_IMAGE_MOUNTED_DATA_SIGNATURE) {
+    return;
+  }
+
+  OcAppleDiskImageReadAhead (DiskImageData->ImageContext);
 }
 
 STATIC
 EFI_STATUS
-EFIAPI
-DiskImageBlockIoReadBlocks (
-  IN EFI_BLOCK_IO_PROTOCOL  *This,
-  IN UINT32                 MediaId,
-  IN EFI_LBA                Lba,
-  IN UINTN                  BufferSize,
-  OUT VOID                  *Buffer
-  ) 
+DiskImageReadBlocks (
+  IN  OC_APPLE_DISK_IMAGE_MOUNTED_DATA  *DiskImageData,
+  IN  EFI_LBA                           Lba,
+  IN  UINTN                             BufferSize,
+  OUT VOID                              *Buffer
+  )
 {
-  OC_APPLE_DISK_IMAGE_MOUNTED_DATA *DiskImageData;
   BOOLEAN                          Result;
+  EFI_TPL                          OldTpl;
 
-  if ((This == NULL) || (Buffer == NULL)) {
+  if (Buffer == NULL) {
     return EFI_INVALID_PARAMETER;
   }
 
@@ -107,7 +128,6 @@ DiskImageBlockIoReadBlocks (
     return EFI_BAD_BUFFER_SIZE;
   }
 
-  DiskImageData = OC_APPLE_DISK_IMAGE_MOUNTED_DATA_FROM_THIS (This);
   if (DiskImageData->Signature == 0) {
     return EFI_UNSUPPORTED;
   }
@@ -118,12 +138,29 @@ DiskImageBlockIoReadBlocks (
     return EFI_INVALID_PARAMETER;
   }
 
+  //
+  // Block I/O is never called above TPL_CALLBACK, so raising to it
+  // serialises chunk cache access with the read-ahead event.
+  //
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+
   Result = OcAppleDiskImageRead (
              DiskImageData->ImageContext,
              (UINTN)Lba,
              BufferSize,
              Buffer
              );
+
+  if (Result && DiskImageData->ReadAheadEvent != NULL) {
+    gBS->SetTimer (
+      DiskImageData->ReadAheadEvent,
+      TimerRelative,
+      DMG_READ_AHEAD_DELAY
+      );
+  }
+
+  gBS->RestoreTPL (OldTpl);
+
   if (!Result) {
     return EFI_DEVICE_ERROR;
   }
@@ -131,6 +168,40 @@ DiskImageBlockIoReadBlocks (
   return EFI_SUCCESS;
 }
 
+STATIC
+EFI_STATUS
+EFIAPI
+DiskImageBlockIoReset (
+  IN EFI_BLOCK_IO_PROTOCOL  *This,
+  IN BOOLEAN                ExtendedVerification
+  )
+{
+  return EFI_SUCCESS;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+DiskImageBlockIoReadBlocks (
+  IN EFI_BLOCK_IO_PROTOCOL  *This,
+  IN UINT32                 MediaId,
+  IN EFI_LBA                Lba,
+  IN UINTN                  BufferSize,
+  OUT VOID                  *Buffer
+  ) 
+{
+  if (This == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  return DiskImageReadBlocks (
+           OC_APPLE_DISK_IMAGE_MOUNTED_DATA_FROM_THIS (This),
+           Lba,
+           BufferSize,
+           Buffer
+           );
+}
+
 STATIC
 EFI_STATUS
 EFIAPI
@@ -155,6 +226,86 @@ DiskImageBlockIoFlushBlocks (
   return EFI_SUCCESS;
 }
 
+STATIC
+EFI_STATUS
+EFIAPI
+DiskImageBlockIo2Reset (
+  IN EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN BOOLEAN                 ExtendedVerification
+  )
+{
+  return EFI_SUCCESS;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+DiskImageBlockIo2ReadBlocksEx (
+  IN     EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN     UINT32                  MediaId,
+  IN     EFI_LBA                 Lba,
+  IN OUT EFI_BLOCK_IO2_TOKEN     *Token,
+  IN     UINTN                   BufferSize,
+  OUT    VOID                    *Buffer
+  )
+{
+  EFI_STATUS  Status;
+
+  if (This == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Status = DiskImageReadBlocks (
+             OC_APPLE_DISK_IMAGE_MOUNTED_DATA_FROM_BLOCK_IO2 (This),
+             Lba,
+             BufferSize,
+             Buffer
+             );
+
+  //
+  // Requests complete immediately, decompression latency is hidden
+  // by read-ahead rather than by queueing.
+  //
+  if (Token != NULL && Token->Event != NULL) {
+    Token->TransactionStatus = Status;
+    gBS->SignalEvent (Token->Event);
+    return EFI_SUCCESS;
+  }
+
+  return Status;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+DiskImageBlockIo2WriteBlocksEx (
+  IN     EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN     UINT32                  MediaId,
+  IN     EFI_LBA                 Lba,
+  IN OUT EFI_BLOCK_IO2_TOKEN     *Token,
+  IN     UINTN                   BufferSize,
+  IN     VOID                    *Buffer
+  )
+{
+  return EFI_WRITE_PROTECTED;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+DiskImageBlockIo2FlushBlocksEx (
+  IN     EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN OUT EFI_BLOCK_IO2_TOKEN     *Token
+  )
+{
+  if (Token != NULL && Token->Event != NULL) {
+    Token->TransactionStatus = EFI_SUCCESS;
+    gBS->SignalEvent (Token->Event);
+  }
+
+  return EFI_SUCCESS;
+}
+
 STATIC UINT32 mDmgCounter; ///< FIXME: This should exist on a protocol basis!
 
 STATIC
@@ -237,6 +388,53 @@ STATIC CONST EFI_BLOCK_IO_PROTOCOL mDiskImageBlockIo = {
   DiskImageBlockIoFlushBlocks
 };
 
+STATIC CONST EFI_BLOCK_IO2_PROTOCOL mDiskImageBlockIo2 = {
+  NULL,
+  DiskImageBlockIo2Reset,
+  DiskImageBlockIo2ReadBlocksEx,
+  DiskImageBlockIo2WriteBlocksEx,
+  DiskImageBlockIo2FlushBlocksEx
+};
+
+STATIC
+VOID
+InternalFreeMountedData (
+  IN OC_APPLE_DISK_IMAGE_MOUNTED_DATA  *DiskImageData
+  )
+{
+  OC_APPLE_DISK_IMAGE_CONTEXT  *Context;
+
+  Context = DiskImageData->ImageContext;
+
+  DEBUG ((
+    DEBUG_INFO,
+    "OCDI: DMG chunk cache hits %u, misses %u, read-ahead hits %u of %u\n",
+    Context->CacheHits,
+    Context->CacheMisses,
+    Context->ReadAheadHits,
+    Context->ReadAheads
+    ));
+
+  if (DiskImageData->ReadAheadEvent != NULL) {
+    gBS->CloseEvent (DiskImageData->ReadAheadEvent);
+  }
+
+  FreePool (DiskImageData);
+}
+
+STATIC
+VOID
+InternalInvalidateMountedData (
+  IN OC_APPLE_DISK_IMAGE_MOUNTED_DATA  *DiskImageData
+  )
+{
+  DiskImageData->Signature = 0;
+
+  if (DiskImageData->ReadAheadEvent != NULL) {
+    gBS->SetTimer (DiskImageData->ReadAheadEvent, TimerCancel, 0);
+  }
+}
+
 EFI_HANDLE
 OcAppleDiskImageInstallBlockIo (
   IN  OC_APPLE_DISK_IMAGE_CONTEXT     *Context,
@@ -266,8 +464,14 @@ OcAppleDiskImageInstallBlockIo (
     &mDiskImageBlockIo,
     sizeof (DiskImageData->BlockIo)
     );
+  CopyMem (
+    &DiskImageData->BlockIo2,
+    &mDiskImageBlockIo2,
+    sizeof (DiskImageData->BlockIo2)
+    );
 
   DiskImageData->BlockIo.Media             = &DiskImageData->BlockIoMedia;
+  DiskImageData->BlockIo2.Media            = &DiskImageData->BlockIoMedia;
   DiskImageData->BlockIoMedia.MediaPresent = TRUE;
   DiskImageData->BlockIoMedia.ReadOnly     = TRUE;
   DiskImageData->BlockIoMedia.BlockSize    = APPLE_DISK_IMAGE_SECTOR_SIZE;
@@ -275,6 +479,21 @@ OcAppleDiskImageInstallBlockIo (
 
   InternalConstructDmgDevicePath (DiskImageData, FileSize);
 
+  //
+  // Read-ahead is optional, the image works without it.
+  //
+  Status = gBS->CreateEvent (
+                  EVT_TIMER | EVT_NOTIFY_SIGNAL,
+                  TPL_CALLBACK,
+                  DiskImageReadAheadNotify,
+                  DiskImageData,
+                  &DiskImageData->ReadAheadEvent
+                  );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_INFO, "OCDI: Failed to create read-ahead event %r\n", Status));
+    DiskImageData->ReadAheadEvent = NULL;
+  }
+
   BlockIoHandle = NULL;
   Status = gBS->InstallMultipleProtocolInterfaces (
                   &BlockIoHandle,
@@ -282,11 +501,13 @@ OcAppleDiskImageInstallBlockIo (
                   &DiskImageData->DevicePath,
                   &gEfiBlockIoProtocolGuid,
                   &DiskImageData->BlockIo,
+                  &gEfiBlockIo2ProtocolGuid,
+                  &DiskImageData->BlockIo2,
                   NULL
                   );
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_INFO, "OCDI: Failed to install protocols %r\n", Status));
-    FreePool (DiskImageData);
+    InternalFreeMountedData (DiskImageData);
     return NULL;
   }
 
@@ -302,13 +523,15 @@ OcAppleDiskImageInstallBlockIo (
                     &DiskImageData->DevicePath,
                     &gEfiBlockIoProtocolGuid,
                     &DiskImageData->BlockIo,
+                    &gEfiBlockIo2ProtocolGuid,
+                    &DiskImageData->BlockIo2,
                     NULL
                     );
     if (!EFI_ERROR (Status)) {
-      FreePool (DiskImageData);
+      InternalFreeMountedData (DiskImageData);
     } else {
       DEBUG ((DEBUG_INFO, "OCDI: Failed to uninstall protocols %r\n", Status));
-      DiskImageData->Signature = 0;
+      InternalInvalidateMountedData (DiskImageData);
     }
     return NULL;
   }
@@ -354,17 +577,19 @@ OcAppleDiskImageUninstallBlockIo (
                   BlockIoHandle,
                   &gEfiBlockIoProtocolGuid,
                   &DiskImageData->BlockIo,
+                  &gEfiBlockIo2ProtocolGuid,
+                  &DiskImageData->BlockIo2,
                   &gEfiDevicePathProtocolGuid,
                   &DiskImageData->DevicePath,
                   NULL
                   );
   if (!EFI_ERROR (Status)) {
-    FreePool (DiskImageData);
+    InternalFreeMountedData (DiskImageData);
   } else {
     DEBUG ((
       DEBUG_INFO,
       "OCDI: Failed to disconnect DMG controller or uninstal protocols\n"
       ));
-    DiskImageData->Signature = 0;
+    InternalInvalidateMountedData (DiskImageData);
   }
 }
@@ -26,6 +26,117 @@
 
 #include "OcAppleDiskImageLibInternal.h"
 
+/**
+  Obtain decompressed data of a ZLIB chunk, consulting the chunk cache.
+
+  @param[in,out] Context    Disk image context.
+  @param[in]     Chunk      ZLIB chunk to decompress.
+  @param[in]     ReadAhead  Request comes from read-ahead.
+
+  @retval Decompressed chunk data or NULL on failure.
+**/
+STATIC
+CONST UINT8 *
+InternalGetDecompressedChunk (
+  IN OUT OC_APPLE_DISK_IMAGE_CONTEXT  *Context,
+  IN     CONST APPLE_DISK_IMAGE_CHUNK *Chunk,
+  IN     BOOLEAN                      ReadAhead
+  )
+{
+  BOOLEAN                          Result;
+  UINT32                           Index;
+  OC_APPLE_DISK_IMAGE_CACHED_CHUNK *Cached;
+  UINT64                           ChunkTotalLength;
+  UINTN                            DataSize;
+  UINT8                            *ChunkDataCompressed;
+  UINTN                            OutSize;
+
+  for (Index = 0; Index < OC_APPLE_DISK_IMAGE_CACHED_CHUNKS; ++Index) {
+    Cached = &Context->CachedChunks[Index];
+    if (Cached->Chunk == Chunk) {
+      if (!ReadAhead) {
+        if (Cached->ReadAhead) {
+          Cached->ReadAhead = FALSE;
+          ++Context->ReadAheadHits;
+        }
+
+        Context->LastCachedChunk = Index;
+        ++Context->CacheHits;
+      }
+
+      return Cached->Data;
+    }
+  }
+
+  Result = OcOverflowMulU64 (
+             Chunk->SectorCount,
+             APPLE_DISK_IMAGE_SECTOR_SIZE,
+             &ChunkTotalLength
+             );
+  if (Result || OcOverflowAddU64 (ChunkTotalLength, Chunk->CompressedLength, &ChunkTotalLength)
+    || ChunkTotalLength > MAX_UINTN) {
+    return NULL;
+  }
+
+  //
+  // Evict the entry not used by the most recent read. Compressed data is
+  // stored right after decompressed data, so that the buffer is reused.
+  //
+  Index    = (Context->LastCachedChunk + 1) % OC_APPLE_DISK_IMAGE_CACHED_CHUNKS;
+  Cached   = &Context->CachedChunks[Index];
+  DataSize = (UINTN) ChunkTotalLength;
+
+  Cached->Chunk = NULL;
+  if (Cached->DataSize < DataSize) {
+    if (Cached->Data != NULL) {
+      FreePool (Cached->Data);
+    }
+
+    Cached->Data = AllocatePool (DataSize);
+    if (Cached->Data == NULL) {
+      Cached->DataSize = 0;
+      return NULL;
+    }
+
+    Cached->DataSize = DataSize;
+  }
+
+  DataSize           -= (UINTN) Chunk->CompressedLength;
+  ChunkDataCompressed = Cached->Data + DataSize;
+
+  Result = OcAppleRamDiskRead (
+             Context->ExtentTable,
+             (UINTN)Chunk->CompressedOffset,
+             (UINTN)Chunk->CompressedLength,
+             ChunkDataCompressed
+             );
+  if (!Result) {
+    return NULL;
+  }
+
+  OutSize = DecompressZLIB (
+              Cached->Data,
+              DataSize,
+              ChunkDataCompressed,
+              (UINTN)Chunk->CompressedLength
+              );
+  if (OutSize != DataSize) {
+    return NULL;
+  }
+
+  Cached->Chunk     = Chunk;
+  Cached->ReadAhead = ReadAhead;
+
+  if (ReadAhead) {
+    ++Context->ReadAheads;
+  } else {
+    Context->LastCachedChunk = Index;
+    ++Context->CacheMisses;
+  }
+
+  return Cached->Data;
+}
+
 BOOLEAN
 OcAppleDiskImageInitializeContext (
   OUT OC_APPLE_DISK_IMAGE_CONTEXT        *Context,
@@ -189,6 +300,15 @@ OcAppleDiskImageInitializeContext (
   Context->Blocks      = DmgBlocks;
   Context->SectorCount = (UINTN)SectorCount;
 
+  ZeroMem (Context->CachedChunks, sizeof (Context->CachedChunks));
+  Context->LastCachedChunk = 0;
+  Context->NextLba         = 0;
+  Context->SequentialReads = 0;
+  Context->CacheHits       = 0;
+  Context->CacheMisses     = 0;
+  Context->ReadAheads      = 0;
+  Context->ReadAheadHits   = 0;
+
   return TRUE;
 }
 
@@ -267,6 +387,13 @@ OcAppleDiskImageFreeContext (
   }
 
   FreePool (Context->Blocks);
+
+  for (Index = 0; Index < OC_APPLE_DISK_IMAGE_CACHED_CHUNKS; ++Index) {
+    if (Context->CachedChunks[Index].Data != NULL) {
+      FreePool (Context->CachedChunks[Index].Data);
+      Context->CachedChunks[Index].Data = NULL;
+    }
+  }
 }
 
 VOID
@@ -293,8 +420,7 @@ OcAppleDiskImageRead (
   UINT64                      ChunkTotalLength;
   UINT64                      ChunkLength;
   UINT64                      ChunkOffset;
-  UINT8                       *ChunkData;
-  UINT8                       *ChunkDataCompressed;
+  CONST UINT8                 *ChunkData;
 
   UINTN                       LbaCurrent;
   UINTN                       LbaOffset;
@@ -303,12 +429,18 @@ OcAppleDiskImageRead (
   UINTN                       BufferChunkSize;
   UINT8                       *BufferCurrent;
 
-  UINTN                       OutSize;
-
   ASSERT (Context != NULL);
   ASSERT (Buffer != NULL);
   ASSERT (Lba < Context->SectorCount);
 
+  if (Lba == Context->NextLba) {
+    ++Context->SequentialReads;
+  } else {
+    Context->SequentialReads = 0;
+  }
+
+  Context->NextLba = Lba + BufferSize / APPLE_DISK_IMAGE_SECTOR_SIZE;
+
   LbaCurrent          = Lba;
   RemainingBufferSize = BufferSize;
   BufferCurrent       = Buffer;
@@ -369,36 +501,12 @@ OcAppleDiskImageRead (
 
       case APPLE_DISK_IMAGE_CHUNK_TYPE_ZLIB:
       {
-        ChunkData = AllocatePool ((UINTN)(ChunkTotalLength + Chunk->CompressedLength));
+        ChunkData = InternalGetDecompressedChunk (Context, Chunk, FALSE);
         if (ChunkData == NULL) {
           return FALSE;
         }
 
-        ChunkDataCompressed = (ChunkData + (UINTN)ChunkTotalLength);
-        Result = OcAppleRamDiskRead (
-                   Context->ExtentTable,
-                   (UINTN)Chunk->CompressedOffset,
-                   (UINTN)Chunk->CompressedLength,
-                   ChunkDataCompressed
-                   );
-        if (!Result) {
-          FreePool (ChunkData);
-          return FALSE;
-        }
-
-        OutSize = DecompressZLIB (
-                    ChunkData,
-                    (UINTN)ChunkTotalLength,
-                    ChunkDataCompressed,
-                    (UINTN)Chunk->CompressedLength
-                    );
-        if (OutSize != (UINTN)ChunkTotalLength) {
-          FreePool (ChunkData);
-          return FALSE;
-        }
-
         CopyMem (BufferCurrent, (ChunkData + ChunkOffset), BufferChunkSize);
-        FreePool (ChunkData);
         break;
       }
 
@@ -420,3 +528,34 @@ OcAppleDiskImageRead (
 
   return TRUE;
 }
+
+BOOLEAN
+OcAppleDiskImageReadAhead (
+  IN OUT OC_APPLE_DISK_IMAGE_CONTEXT  *Context
+  )
+{
+  BOOLEAN                     Result;
+  APPLE_DISK_IMAGE_BLOCK_DATA *BlockData;
+  APPLE_DISK_IMAGE_CHUNK      *Chunk;
+
+  ASSERT (Context != NULL);
+
+  if (Context->SequentialReads < DMG_READ_AHEAD_THRESHOLD
+    || Context->NextLba >= Context->SectorCount) {
+    return FALSE;
+  }
+
+  Result = InternalGetBlockChunk (Context, Context->NextLba, &BlockData, &Chunk);
+  if (!Result || Chunk->Type != APPLE_DISK_IMAGE_CHUNK_TYPE_ZLIB) {
+    return FALSE;
+  }
+
+  //
+  // Only decompress chunks not cached yet, the current one is left intact.
+  //
+  if (Context->CachedChunks[Context->LastCachedChunk].Chunk == Chunk) {
+    return FALSE;
+  }
+
+  return InternalGetDecompressedChunk (Context, Chunk, TRUE) != NULL;
+}
@@ -18,6 +18,11 @@
 
 #define DMG_SECTOR_START_ABS(b, c) (((b)->SectorNumber) + ((c)->SectorNumber))
 
+//
+// Amount of back-to-back sequential reads enabling read-ahead.
+//
+#define DMG_READ_AHEAD_THRESHOLD  2
+
 #define DMG_PLIST_RESOURCE_FORK_KEY  "resource-fork"
 #define DMG_PLIST_BLOCK_LIST_KEY     "blkx"
 #define DMG_PLIST_ATTRIBUTES         "Attributes"
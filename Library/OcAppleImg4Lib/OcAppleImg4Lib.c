@@ -42,6 +42,10 @@ typedef struct OC_SB_MODEL_DESC_ {
 
 STATIC CHAR8 mCryptoDigestMethod[16] = "sha2-384";
 STATIC DERImg4Environment mEnvInfo;
+
+STATIC CONST VOID *mImageDigestBuffer;
+STATIC UINTN      mImageDigestSize;
+STATIC UINT8      mImageDigest[SHA384_DIGEST_SIZE];
 STATIC CONST CHAR8 *mModelDefault = "j137";
 ///
 /// List of model mapping to board identifiers.
@@ -268,12 +272,19 @@ OcAppleImg4Verify (
   // can be considered trusted at this point.
   //
   if (CmpResult != 0) {
-    CmpResult = SigVerifyShaHashBySize (
-      ImageBuffer,
-      ImageSize,
-      ManInfo.imageDigest,
-      ManInfo.imageDigestSize
-      );
+    if (mImageDigestBuffer != NULL
+      && mImageDigestBuffer == ImageBuffer
+      && mImageDigestSize == ImageSize
+      && ManInfo.imageDigestSize == SHA384_DIGEST_SIZE) {
+      CmpResult = CompareMem (mImageDigest, ManInfo.imageDigest, SHA384_DIGEST_SIZE);
+    } else {
+      CmpResult = SigVerifyShaHashBySize (
+        ImageBuffer,
+        ImageSize,
+        ManInfo.imageDigest,
+        ManInfo.imageDigestSize
+        );
+    }
   }
   if (CmpResult != 0) {
     return EFI_SECURITY_VIOLATION;
@@ -336,6 +347,27 @@ OcAppleImg4RegisterOverride (
   Sha384 (mOverrideDigest, Image, ImageSize);
 }
 
+VOID
+OcAppleImg4RegisterDigest (
+  IN CONST VOID   *Image  OPTIONAL,
+  IN UINTN        ImageSize,
+  IN CONST UINT8  *Digest OPTIONAL
+  )
+{
+  if (Image == NULL) {
+    mImageDigestBuffer = NULL;
+    mImageDigestSize   = 0;
+    return;
+  }
+
+  ASSERT (ImageSize > 0);
+  ASSERT (Digest != NULL);
+
+  mImageDigestBuffer = Image;
+  mImageDigestSize   = ImageSize;
+  CopyMem (mImageDigest, Digest, sizeof (mImageDigest));
+}
+
 EFI_STATUS
 OcAppleImg4BootstrapValues (
   IN CONST CHAR8   *Model,
@@ -65,6 +65,95 @@ FreeBuiltInKext (
   FreePool (BuiltinKext);
 }
 
+STATIC
+UINT32
+HashAsciiString (
+  IN CONST CHAR8  *String
+  )
+{
+  UINT32  Hash;
+
+  //
+  // FNV-1a, good enough for bundle identifiers and paths.
+  //
+  Hash = 2166136261U;
+  while (*String != '\0') {
+    Hash = (Hash ^ (UINT8) *String) * 16777619U;
+    ++String;
+  }
+
+  return Hash;
+}
+
+STATIC
+UINT32
+HashUnicodeString (
+  IN CONST CHAR16  *String
+  )
+{
+  UINT32  Hash;
+
+  Hash = 2166136261U;
+  while (*String != L'\0') {
+    Hash = (Hash ^ (UINT16) *String) * 16777619U;
+    ++String;
+  }
+
+  return Hash;
+}
+
+STATIC
+VOID
+InsertBuiltInKext (
+  IN OUT CACHELESS_CONTEXT    *Context,
+  IN OUT BUILTIN_KEXT         *BuiltinKext
+  )
+{
+  UINT32  Bucket;
+
+  ASSERT (BuiltinKext->Identifier != NULL);
+  ASSERT (BuiltinKext->PlistPath != NULL);
+
+  InsertTailList (&Context->BuiltInKexts, &BuiltinKext->Link);
+
+  Bucket = HashAsciiString (BuiltinKext->Identifier) % CACHELESS_BUILTIN_KEXT_BUCKETS;
+  InsertTailList (&Context->BuiltInKextsByIdentifier[Bucket], &BuiltinKext->IdentifierLink);
+
+  Bucket = HashUnicodeString (BuiltinKext->PlistPath) % CACHELESS_BUILTIN_KEXT_BUCKETS;
+  InsertTailList (&Context->BuiltInKextsByPlistPath[Bucket], &BuiltinKext->PlistPathLink);
+
+  if (BuiltinKext->BinaryPath != NULL) {
+    Bucket = HashUnicodeString (BuiltinKext->BinaryPath) % CACHELESS_BUILTIN_KEXT_BUCKETS;
+    InsertTailList (&Context->BuiltInKextsByBinaryPath[Bucket], &BuiltinKext->BinaryPathLink);
+  } else {
+    InitializeListHead (&BuiltinKext->BinaryPathLink);
+  }
+}
+
+STATIC
+VOID
+FreeBuiltInKexts (
+  IN OUT CACHELESS_CONTEXT    *Context
+  )
+{
+  BUILTIN_KEXT        *BuiltinKext;
+  LIST_ENTRY          *KextLink;
+  UINT32              Index;
+
+  while (!IsListEmpty (&Context->BuiltInKexts)) {
+    KextLink = GetFirstNode (&Context->BuiltInKexts);
+    BuiltinKext = GET_BUILTIN_KEXT_FROM_LINK (KextLink);
+    RemoveEntryList (KextLink);
+    FreeBuiltInKext (BuiltinKext);
+  }
+
+  for (Index = 0; Index < CACHELESS_BUILTIN_KEXT_BUCKETS; ++Index) {
+    InitializeListHead (&Context->BuiltInKextsByIdentifier[Index]);
+    InitializeListHead (&Context->BuiltInKextsByPlistPath[Index]);
+    InitializeListHead (&Context->BuiltInKextsByBinaryPath[Index]);
+  }
+}
+
 STATIC
 EFI_STATUS
 AddKextDependency (
@@ -394,7 +483,7 @@ ScanExtensions (
             }
           }
 
-          InsertTailList (&Context->BuiltInKexts, &BuiltinKext->Link);
+          InsertBuiltInKext (Context, BuiltinKext);
           DEBUG ((
             DEBUG_VERBOSE,
             "OCAK: Discovered bundle %a %s %s %u\n",
@@ -479,17 +568,20 @@ LookupBuiltinKextForIdentifier (
   )
 {
   BUILTIN_KEXT  *BuiltinKext;
+  LIST_ENTRY    *Bucket;
   LIST_ENTRY    *KextLink;
 
-  KextLink = GetFirstNode (&Context->BuiltInKexts);
-  while (!IsNull (&Context->BuiltInKexts, KextLink)) {
-    BuiltinKext = GET_BUILTIN_KEXT_FROM_LINK (KextLink);
+  Bucket = &Context->BuiltInKextsByIdentifier[HashAsciiString (Identifier) % CACHELESS_BUILTIN_KEXT_BUCKETS];
+
+  KextLink = GetFirstNode (Bucket);
+  while (!IsNull (Bucket, KextLink)) {
+    BuiltinKext = GET_BUILTIN_KEXT_FROM_IDENTIFIER_LINK (KextLink);
  
     if (AsciiStrCmp (Identifier, BuiltinKext->Identifier) == 0) {
       return BuiltinKext;
     }
 
-    KextLink = GetNextNode (&Context->BuiltInKexts, KextLink);
+    KextLink = GetNextNode (Bucket, KextLink);
   }
 
   return NULL;
@@ -503,17 +595,20 @@ LookupBuiltinKextForPlistPath (
   )
 {
   BUILTIN_KEXT  *BuiltinKext;
+  LIST_ENTRY    *Bucket;
   LIST_ENTRY    *KextLink;
 
-  KextLink = GetFirstNode (&Context->BuiltInKexts);
-  while (!IsNull (&Context->BuiltInKexts, KextLink)) {
-    BuiltinKext = GET_BUILTIN_KEXT_FROM_LINK (KextLink);
+  Bucket = &Context->BuiltInKextsByPlistPath[HashUnicodeString (PlistPath) % CACHELESS_BUILTIN_KEXT_BUCKETS];
+
+  KextLink = GetFirstNode (Bucket);
+  while (!IsNull (Bucket, KextLink)) {
+    BuiltinKext = GET_BUILTIN_KEXT_FROM_PLIST_PATH_LINK (KextLink);
  
     if (StrCmp (PlistPath, BuiltinKext->PlistPath) == 0) {
       return BuiltinKext;
     }
 
-    KextLink = GetNextNode (&Context->BuiltInKexts, KextLink);
+    KextLink = GetNextNode (Bucket, KextLink);
   }
 
   return NULL;
@@ -527,21 +622,553 @@ LookupBuiltinKextForBinaryPath (
   )
 {
   BUILTIN_KEXT  *BuiltinKext;
+  LIST_ENTRY    *Bucket;
   LIST_ENTRY    *KextLink;
 
+  Bucket = &Context->BuiltInKextsByBinaryPath[HashUnicodeString (BinaryPath) % CACHELESS_BUILTIN_KEXT_BUCKETS];
+
+  KextLink = GetFirstNode (Bucket);
+  while (!IsNull (Bucket, KextLink)) {
+    BuiltinKext = GET_BUILTIN_KEXT_FROM_BINARY_PATH_LINK (KextLink);
+ 
+    if (StrCmp (BinaryPath, BuiltinKext->BinaryPath) == 0) {
+      return BuiltinKext;
+    }
+
+    KextLink = GetNextNode (Bucket, KextLink);
+  }
+
+  return NULL;
+}
+
+STATIC
+UINT64
+DigestUpdate (
+  IN UINT64       Digest,
+  IN CONST VOID   *Data,
+  IN UINTN        DataSize
+  )
+{
+  CONST UINT8  *Walker;
+
+  Walker = Data;
+  while (DataSize > 0) {
+    Digest = MultU64x64 (Digest ^ *Walker, 0x100000001B3ULL);
+    ++Walker;
+    --DataSize;
+  }
+
+  return Digest;
+}
+
+STATIC
+UINT64
+DigestUpdateTime (
+  IN UINT64          Digest,
+  IN CONST EFI_TIME  *Time
+  )
+{
+  //
+  // Padding fields are not guaranteed to be initialised.
+  //
+  Digest = DigestUpdate (Digest, &Time->Year, sizeof (Time->Year));
+  Digest = DigestUpdate (Digest, &Time->Month, sizeof (Time->Month));
+  Digest = DigestUpdate (Digest, &Time->Day, sizeof (Time->Day));
+  Digest = DigestUpdate (Digest, &Time->Hour, sizeof (Time->Hour));
+  Digest = DigestUpdate (Digest, &Time->Minute, sizeof (Time->Minute));
+  Digest = DigestUpdate (Digest, &Time->Second, sizeof (Time->Second));
+  Digest = DigestUpdate (Digest, &Time->Nanosecond, sizeof (Time->Nanosecond));
+
+  return Digest;
+}
+
+STATIC
+EFI_STATUS
+DigestDirectory (
+  IN OUT UINT64             *Digest,
+  IN     EFI_FILE_PROTOCOL  *Directory,
+  IN     BOOLEAN            ReadBundles,
+  IN     BOOLEAN            ReadPlugins
+  );
+
+STATIC
+EFI_STATUS
+DigestSubdirectory (
+  IN OUT UINT64             *Digest,
+  IN     EFI_FILE_PROTOCOL  *Parent,
+  IN     CONST CHAR16       *FileName,
+  IN     BOOLEAN            ReadBundles,
+  IN     BOOLEAN            ReadPlugins
+  )
+{
+  EFI_STATUS          Status;
+  EFI_FILE_PROTOCOL   *Directory;
+  BOOLEAN             Found;
+
+  Status = Parent->Open (Parent, &Directory, (CHAR16 *) FileName, EFI_FILE_MODE_READ, EFI_FILE_DIRECTORY);
+  Found  = !EFI_ERROR (Status);
+  *Digest = DigestUpdate (*Digest, &Found, sizeof (Found));
+  if (!Found) {
+    return Status == EFI_NOT_FOUND ? EFI_SUCCESS : Status;
+  }
+
+  Status = DigestDirectory (Digest, Directory, ReadBundles, ReadPlugins);
+  Directory->Close (Directory);
+  return Status;
+}
+
+STATIC
+EFI_STATUS
+DigestKextBundle (
+  IN OUT UINT64             *Digest,
+  IN     EFI_FILE_PROTOCOL  *FileKext,
+  IN     BOOLEAN            ReadPlugins
+  )
+{
+  EFI_STATUS          Status;
+  EFI_FILE_PROTOCOL   *FileContents;
+  EFI_FILE_PROTOCOL   *Bundle;
+
+  //
+  // Follow the layouts accepted by ScanExtensions. Info.plist and the
+  // binary either reside in Contents and Contents/MacOS, or in the bundle root.
+  //
+  Status = FileKext->Open (FileKext, &FileContents, L"Contents", EFI_FILE_MODE_READ, EFI_FILE_DIRECTORY);
+  Bundle = EFI_ERROR (Status) ? FileKext : FileContents;
+
+  Status = DigestDirectory (Digest, Bundle, FALSE, FALSE);
+  if (!EFI_ERROR (Status) && Bundle != FileKext) {
+    Status = DigestSubdirectory (Digest, Bundle, L"MacOS", FALSE, FALSE);
+  }
+
+  if (!EFI_ERROR (Status) && ReadPlugins) {
+    Status = DigestSubdirectory (Digest, Bundle, L"PlugIns", TRUE, FALSE);
+  }
+
+  if (Bundle != FileKext) {
+    FileContents->Close (FileContents);
+  }
+
+  return Status;
+}
+
+STATIC
+EFI_STATUS
+DigestDirectory (
+  IN OUT UINT64             *Digest,
+  IN     EFI_FILE_PROTOCOL  *Directory,
+  IN     BOOLEAN            ReadBundles,
+  IN     BOOLEAN            ReadPlugins
+  )
+{
+  EFI_STATUS          Status;
+  EFI_FILE_PROTOCOL   *FileKext;
+  EFI_FILE_INFO       *FileInfo;
+  UINTN               FileInfoSize;
+
+  FileInfo = AllocatePool (SIZE_1KB);
+  if (FileInfo == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Directory->SetPosition (Directory, 0);
+
+  do {
+    //
+    // See ScanExtensions for buffer size rationale.
+    //
+    FileInfoSize = SIZE_1KB - sizeof (CHAR16);
+    Status = Directory->Read (Directory, &FileInfoSize, FileInfo);
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+
+    if (FileInfoSize > 0) {
+      *Digest = DigestUpdate (*Digest, FileInfo->FileName, StrSize (FileInfo->FileName));
+      *Digest = DigestUpdate (*Digest, &FileInfo->FileSize, sizeof (FileInfo->FileSize));
+      *Digest = DigestUpdateTime (*Digest, &FileInfo->ModificationTime);
+
+      //
+      // Directory modification times only reflect added, removed, and renamed
+      // entries, so descend into bundles to catch in-place edits of Info.plist
+      // and binaries.
+      //
+      if (ReadBundles && OcUnicodeEndsWith (FileInfo->FileName, L".kext", FALSE)) {
+        Status = Directory->Open (Directory, &FileKext, FileInfo->FileName, EFI_FILE_MODE_READ, EFI_FILE_DIRECTORY);
+        if (EFI_ERROR (Status)) {
+          Status = EFI_SUCCESS;
+          continue;
+        }
+
+        Status = DigestKextBundle (Digest, FileKext, ReadPlugins);
+        FileKext->Close (FileKext);
+        if (EFI_ERROR (Status)) {
+          break;
+        }
+      }
+    }
+  } while (FileInfoSize > 0);
+
+  Directory->SetPosition (Directory, 0);
+  FreePool (FileInfo);
+
+  return Status;
+}
+
+STATIC
+EFI_STATUS
+GetExtensionsDigest (
+  IN  EFI_FILE_PROTOCOL    *File,
+  OUT UINT64               *Digest
+  )
+{
+  EFI_STATUS          Status;
+  EFI_TIME            ModificationTime;
+
+  Status = GetFileModificationTime (File, &ModificationTime);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // Only metadata is hashed, which is much cheaper than parsing every Info.plist.
+  //
+  *Digest = DigestUpdateTime (0xCBF29CE484222325ULL, &ModificationTime);
+
+  return DigestDirectory (Digest, File, TRUE, TRUE);
+}
+
+STATIC
+BOOLEAN
+AddIndexStringSize (
+  IN     UINTN     StringSize,
+     OUT UINT16    *RecordStringSize,
+  IN OUT UINT32    *RecordSize
+  )
+{
+  if (StringSize > MAX_UINT16) {
+    return FALSE;
+  }
+
+  *RecordStringSize = (UINT16) StringSize;
+  return !OcOverflowAddU32 (*RecordSize, (UINT32) StringSize, RecordSize);
+}
+
+STATIC
+BOOLEAN
+GetBuiltInKextIndexRecord (
+  IN  BUILTIN_KEXT          *BuiltinKext,
+  OUT CACHELESS_INDEX_KEXT  *Record,
+  OUT UINT32                *RecordSize
+  )
+{
+  DEPEND_KEXT       *DependKext;
+  LIST_ENTRY        *KextLink;
+  UINT16            DependSize;
+
+  ZeroMem (Record, sizeof (*Record));
+  Record->OSBundleRequiredValue = BuiltinKext->OSBundleRequiredValue;
+  *RecordSize = sizeof (*Record);
+
+  if (!AddIndexStringSize (AsciiStrSize (BuiltinKext->Identifier), &Record->IdentifierSize, RecordSize)
+    || !AddIndexStringSize (StrSize (BuiltinKext->PlistPath), &Record->PlistPathSize, RecordSize)) {
+    return FALSE;
+  }
+
+  if (BuiltinKext->BinaryFileName != NULL
+    && !AddIndexStringSize (StrSize (BuiltinKext->BinaryFileName), &Record->BinaryFileNameSize, RecordSize)) {
+    return FALSE;
+  }
+
+  if (BuiltinKext->BinaryPath != NULL
+    && !AddIndexStringSize (StrSize (BuiltinKext->BinaryPath), &Record->BinaryPathSize, RecordSize)) {
+    return FALSE;
+  }
+
+  KextLink = GetFirstNode (&BuiltinKext->Dependencies);
+  while (!IsNull (&BuiltinKext->Dependencies, KextLink)) {
+    DependKext = GET_DEPEND_KEXT_FROM_LINK (KextLink);
+
+    if (Record->NumDependencies == MAX_UINT16
+      || OcOverflowAddU32 (*RecordSize, sizeof (DependSize), RecordSize)
+      || !AddIndexStringSize (AsciiStrSize (DependKext->Identifier), &DependSize, RecordSize)) {
+      return FALSE;
+    }
+    ++Record->NumDependencies;
+
+    KextLink = GetNextNode (&BuiltinKext->Dependencies, KextLink);
+  }
+
+  return TRUE;
+}
+
+STATIC
+EFI_STATUS
+SaveBuiltInKextIndex (
+  IN  CACHELESS_CONTEXT    *Context,
+  OUT VOID                 **Index,
+  OUT UINT32               *IndexSize
+  )
+{
+  CACHELESS_INDEX_HEADER  *Header;
+  CACHELESS_INDEX_KEXT    Record;
+  BUILTIN_KEXT            *BuiltinKext;
+  DEPEND_KEXT             *DependKext;
+  LIST_ENTRY              *KextLink;
+  LIST_ENTRY              *DependLink;
+  UINT32                  RecordSize;
+  UINT32                  NumKexts;
+  UINT16                  DependSize;
+  UINT8                   *Walker;
+
+  //
+  // Calculate index size first.
+  //
+  *IndexSize = sizeof (*Header);
+  NumKexts   = 0;
+
   KextLink = GetFirstNode (&Context->BuiltInKexts);
   while (!IsNull (&Context->BuiltInKexts, KextLink)) {
     BuiltinKext = GET_BUILTIN_KEXT_FROM_LINK (KextLink);
- 
-    if (BuiltinKext->BinaryPath != NULL
-      && StrCmp (BinaryPath, BuiltinKext->BinaryPath) == 0) {
-      return BuiltinKext;
+
+    if (!GetBuiltInKextIndexRecord (BuiltinKext, &Record, &RecordSize)
+      || OcOverflowAddU32 (*IndexSize, RecordSize, IndexSize)) {
+      return EFI_UNSUPPORTED;
     }
+    ++NumKexts;
 
     KextLink = GetNextNode (&Context->BuiltInKexts, KextLink);
   }
 
-  return NULL;
+  *Index = AllocatePool (*IndexSize);
+  if (*Index == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Header                   = *Index;
+  Header->Signature        = CACHELESS_INDEX_SIGNATURE;
+  Header->Version          = CACHELESS_INDEX_VERSION;
+  CopyGuid (&Header->VolumeUuid, &Context->IndexVolumeUuid);
+  Header->ExtensionsDigest = Context->IndexExtensionsDigest;
+  Header->Size             = *IndexSize;
+  Header->NumKexts         = NumKexts;
+
+  Walker = (UINT8 *) (Header + 1);
+
+  KextLink = GetFirstNode (&Context->BuiltInKexts);
+  while (!IsNull (&Context->BuiltInKexts, KextLink)) {
+    BuiltinKext = GET_BUILTIN_KEXT_FROM_LINK (KextLink);
+
+    GetBuiltInKextIndexRecord (BuiltinKext, &Record, &RecordSize);
+    CopyMem (Walker, &Record, sizeof (Record));
+    Walker += sizeof (Record);
+
+    CopyMem (Walker, BuiltinKext->Identifier, Record.IdentifierSize);
+    Walker += Record.IdentifierSize;
+    CopyMem (Walker, BuiltinKext->PlistPath, Record.PlistPathSize);
+    Walker += Record.PlistPathSize;
+    if (BuiltinKext->BinaryFileName != NULL) {
+      CopyMem (Walker, BuiltinKext->BinaryFileName, Record.BinaryFileNameSize);
+      Walker += Record.BinaryFileNameSize;
+    }
+    if (BuiltinKext->BinaryPath != NULL) {
+      CopyMem (Walker, BuiltinKext->BinaryPath, Record.BinaryPathSize);
+      Walker += Record.BinaryPathSize;
+    }
+
+    DependLink = GetFirstNode (&BuiltinKext->Dependencies);
+    while (!IsNull (&BuiltinKext->Dependencies, DependLink)) {
+      DependKext = GET_DEPEND_KEXT_FROM_LINK (DependLink);
+
+      DependSize = (UINT16) AsciiStrSize (DependKext->Identifier);
+      CopyMem (Walker, &DependSize, sizeof (DependSize));
+      Walker += sizeof (DependSize);
+      CopyMem (Walker, DependKext->Identifier, DependSize);
+      Walker += DependSize;
+
+      DependLink = GetNextNode (&BuiltinKext->Dependencies, DependLink);
+    }
+
+    KextLink = GetNextNode (&Context->BuiltInKexts, KextLink);
+  }
+
+  ASSERT (Walker == (UINT8 *) *Index + *IndexSize);
+
+  return EFI_SUCCESS;
+}
+
+STATIC
+VOID *
+ReadIndexString (
+  IN OUT CONST UINT8    **Walker,
+  IN OUT UINT32         *Remaining,
+  IN     UINT32         Size,
+  IN     BOOLEAN        Unicode
+  )
+{
+  VOID  *String;
+
+  if (Size == 0 || Size > *Remaining || (Unicode && Size % sizeof (CHAR16) != 0)) {
+    return NULL;
+  }
+
+  //
+  // Copying also ensures the strings are properly aligned.
+  //
+  String = AllocateCopyPool (Size, *Walker);
+  if (String == NULL) {
+    return NULL;
+  }
+
+  if ((Unicode && ((CHAR16 *) String)[Size / sizeof (CHAR16) - 1] != L'\0')
+    || (!Unicode && ((CHAR8 *) String)[Size - 1] != '\0')) {
+    FreePool (String);
+    return NULL;
+  }
+
+  *Walker    += Size;
+  *Remaining -= Size;
+  return String;
+}
+
+STATIC
+EFI_STATUS
+LoadBuiltInKextIndexKext (
+  IN OUT CACHELESS_CONTEXT    *Context,
+  IN OUT CONST UINT8          **Walker,
+  IN OUT UINT32               *Remaining
+  )
+{
+  EFI_STATUS              Status;
+  CACHELESS_INDEX_KEXT    Record;
+  BUILTIN_KEXT            *BuiltinKext;
+  CHAR8                   *DependIdentifier;
+  UINT16                  DependSize;
+  UINT32                  Index;
+
+  if (*Remaining < sizeof (Record)) {
+    return EFI_VOLUME_CORRUPTED;
+  }
+
+  CopyMem (&Record, *Walker, sizeof (Record));
+  *Walker    += sizeof (Record);
+  *Remaining -= sizeof (Record);
+
+  if (Record.OSBundleRequiredValue > KEXT_OSBUNDLE_REQUIRED_VALID
+    || Record.Reserved != 0) {
+    return EFI_VOLUME_CORRUPTED;
+  }
+
+  BuiltinKext = AllocateZeroPool (sizeof (*BuiltinKext));
+  if (BuiltinKext == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+  BuiltinKext->Signature             = BUILTIN_KEXT_SIGNATURE;
+  BuiltinKext->OSBundleRequiredValue = Record.OSBundleRequiredValue;
+  InitializeListHead (&BuiltinKext->Dependencies);
+
+  BuiltinKext->Identifier = ReadIndexString (Walker, Remaining, Record.IdentifierSize, FALSE);
+  BuiltinKext->PlistPath  = ReadIndexString (Walker, Remaining, Record.PlistPathSize, TRUE);
+  if (BuiltinKext->Identifier == NULL || BuiltinKext->PlistPath == NULL) {
+    FreeBuiltInKext (BuiltinKext);
+    return EFI_VOLUME_CORRUPTED;
+  }
+
+  if (Record.BinaryFileNameSize > 0) {
+    BuiltinKext->BinaryFileName = ReadIndexString (Walker, Remaining, Record.BinaryFileNameSize, TRUE);
+    if (BuiltinKext->BinaryFileName == NULL) {
+      FreeBuiltInKext (BuiltinKext);
+      return EFI_VOLUME_CORRUPTED;
+    }
+  }
+
+  if (Record.BinaryPathSize > 0) {
+    BuiltinKext->BinaryPath = ReadIndexString (Walker, Remaining, Record.BinaryPathSize, TRUE);
+    if (BuiltinKext->BinaryPath == NULL) {
+      FreeBuiltInKext (BuiltinKext);
+      return EFI_VOLUME_CORRUPTED;
+    }
+  }
+
+  for (Index = 0; Index < Record.NumDependencies; ++Index) {
+    if (*Remaining < sizeof (DependSize)) {
+      FreeBuiltInKext (BuiltinKext);
+      return EFI_VOLUME_CORRUPTED;
+    }
+
+    CopyMem (&DependSize, *Walker, sizeof (DependSize));
+    *Walker    += sizeof (DependSize);
+    *Remaining -= sizeof (DependSize);
+
+    DependIdentifier = ReadIndexString (Walker, Remaining, DependSize, FALSE);
+    if (DependIdentifier == NULL) {
+      FreeBuiltInKext (BuiltinKext);
+      return EFI_VOLUME_CORRUPTED;
+    }
+
+    Status = AddKextDependency (&BuiltinKext->Dependencies, DependIdentifier);
+    FreePool (DependIdentifier);
+    if (EFI_ERROR (Status)) {
+      FreeBuiltInKext (BuiltinKext);
+      return Status;
+    }
+  }
+
+  InsertBuiltInKext (Context, BuiltinKext);
+  return EFI_SUCCESS;
+}
+
+STATIC
+EFI_STATUS
+LoadBuiltInKextIndex (
+  IN OUT CACHELESS_CONTEXT    *Context
+  )
+{
+  EFI_STATUS                    Status;
+  CONST CACHELESS_INDEX_HEADER  *Header;
+  CONST UINT8                   *Walker;
+  UINT32                        Remaining;
+  UINT32                        Index;
+
+  if (Context->Index == NULL) {
+    return EFI_NOT_FOUND;
+  }
+
+  Header = Context->Index;
+  if (Context->IndexSize < sizeof (*Header)
+    || Header->Signature != CACHELESS_INDEX_SIGNATURE
+    || Header->Version != CACHELESS_INDEX_VERSION
+    || Header->Size != Context->IndexSize) {
+    Status = EFI_VOLUME_CORRUPTED;
+  } else if (!CompareGuid (&Header->VolumeUuid, &Context->IndexVolumeUuid)
+    || Header->ExtensionsDigest != Context->IndexExtensionsDigest) {
+    Status = EFI_NOT_FOUND;
+  } else {
+    Walker    = (CONST UINT8 *) (Header + 1);
+    Remaining = Context->IndexSize - sizeof (*Header);
+    Status    = EFI_SUCCESS;
+
+    for (Index = 0; Index < Header->NumKexts && !EFI_ERROR (Status); ++Index) {
+      Status = LoadBuiltInKextIndexKext (Context, &Walker, &Remaining);
+    }
+
+    if (!EFI_ERROR (Status) && Remaining != 0) {
+      Status = EFI_VOLUME_CORRUPTED;
+    }
+
+    if (EFI_ERROR (Status)) {
+      FreeBuiltInKexts (Context);
+    }
+  }
+
+  //
+  // The index is no longer needed after it has been consumed.
+  //
+  FreePool (Context->Index);
+  Context->Index     = NULL;
+  Context->IndexSize = 0;
+
+  return Status;
 }
 
 STATIC
@@ -684,6 +1311,8 @@ CachelessContextInit (
   IN     BOOLEAN              Is32Bit
   )
 {
+  UINT32  Index;
+
   ASSERT (Context != NULL);
   ASSERT (FileName != NULL);
   ASSERT (ExtensionsDir != NULL);
@@ -700,6 +1329,12 @@ CachelessContextInit (
   InitializeListHead (&Context->PatchedKexts);
   InitializeListHead (&Context->BuiltInKexts);
 
+  for (Index = 0; Index < CACHELESS_BUILTIN_KEXT_BUCKETS; ++Index) {
+    InitializeListHead (&Context->BuiltInKextsByIdentifier[Index]);
+    InitializeListHead (&Context->BuiltInKextsByPlistPath[Index]);
+    InitializeListHead (&Context->BuiltInKextsByBinaryPath[Index]);
+  }
+
   return EFI_SUCCESS;
 }
 
@@ -711,7 +1346,6 @@ CachelessContextFree (
   CACHELESS_KEXT      *CachelessKext;
   PATCHED_KEXT        *PatchedKext;
   KEXT_PATCH          *KextPatch;
-  BUILTIN_KEXT        *BuiltinKext;
   LIST_ENTRY          *KextLink;
   LIST_ENTRY          *PatchLink;
 
@@ -750,26 +1384,81 @@ CachelessContextFree (
     FreePool (PatchedKext);
   }
 
-  while (!IsListEmpty (&Context->BuiltInKexts)) {
-    KextLink = GetFirstNode (&Context->BuiltInKexts);
-    BuiltinKext = GET_BUILTIN_KEXT_FROM_LINK (KextLink);
-    RemoveEntryList (KextLink);
+  FreeBuiltInKexts (Context);
 
-    if (BuiltinKext->PlistPath != NULL) {
-      FreePool (BuiltinKext->PlistPath);
-    }
-    if (BuiltinKext->Identifier != NULL) {
-      FreePool (BuiltinKext->Identifier);
-    }
-    if (BuiltinKext->BinaryFileName != NULL) {
-      FreePool (BuiltinKext->BinaryFileName);
-    }
-    FreePool (BuiltinKext);
+  if (Context->Index != NULL) {
+    FreePool (Context->Index);
   }
   
   ZeroMem (Context, sizeof (*Context));
 }
 
+EFI_STATUS
+CachelessContextSetIndex (
+  IN OUT CACHELESS_CONTEXT    *Context,
+  IN     CONST GUID           *VolumeUuid,
+  IN     CONST VOID           *Index OPTIONAL,
+  IN     UINT32               IndexSize OPTIONAL
+  )
+{
+  EFI_STATUS          Status;
+
+  ASSERT (Context != NULL);
+  ASSERT (VolumeUuid != NULL);
+  ASSERT (Index != NULL || IndexSize == 0);
+
+  if (Context->BuiltInKextsValid) {
+    return EFI_ALREADY_STARTED;
+  }
+
+  Status = GetExtensionsDigest (Context->ExtensionsDir, &Context->IndexExtensionsDigest);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  if (Context->Index != NULL) {
+    FreePool (Context->Index);
+    Context->Index     = NULL;
+    Context->IndexSize = 0;
+  }
+
+  if (IndexSize > 0) {
+    Context->Index = AllocateCopyPool (IndexSize, Index);
+    if (Context->Index == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+    Context->IndexSize = IndexSize;
+  }
+
+  CopyGuid (&Context->IndexVolumeUuid, VolumeUuid);
+  Context->UseIndex = TRUE;
+
+  return EFI_SUCCESS;
+}
+
+EFI_STATUS
+CachelessContextGetIndex (
+  IN OUT CACHELESS_CONTEXT    *Context,
+     OUT VOID                 **Index,
+     OUT UINT32               *IndexSize
+  )
+{
+  ASSERT (Context != NULL);
+  ASSERT (Index != NULL);
+  ASSERT (IndexSize != NULL);
+
+  if (!Context->IndexOutdated) {
+    return EFI_ALREADY_STARTED;
+  }
+
+  //
+  // Only try once, failures here are not expected to go away.
+  //
+  Context->IndexOutdated = FALSE;
+
+  return SaveBuiltInKextIndex (Context, Index, IndexSize);
+}
+
 EFI_STATUS
 CachelessContextAddKext (
   IN OUT CACHELESS_CONTEXT    *Context,
@@ -1339,10 +2028,21 @@ CachelessContextHookBuiltin (
 
     //
     // Build list of kexts in system Extensions directory.
+    // Prefer the saved index when it still matches the directory.
     //
-    Status = ScanExtensions (Context, Context->ExtensionsDir, Context->ExtensionsDirFileName, TRUE);
+    Status = EFI_NOT_FOUND;
+    if (Context->UseIndex) {
+      Status = LoadBuiltInKextIndex (Context);
+      DEBUG ((DEBUG_INFO, "OCAK: Built-in kext index load - %r\n", Status));
+    }
+
     if (EFI_ERROR (Status)) {
-      return Status;
+      Status = ScanExtensions (Context, Context->ExtensionsDir, Context->ExtensionsDirFileName, TRUE);
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+
+      Context->IndexOutdated = Context->UseIndex;
     }
 
     //
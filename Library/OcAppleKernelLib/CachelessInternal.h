@@ -33,6 +33,78 @@ enum {
   KEXT_OSBUNDLE_REQUIRED_VALID
 };
 
+//
+// Built-in kext index file signature and version.
+//
+#define CACHELESS_INDEX_SIGNATURE  SIGNATURE_32 ('O', 'c', 'S', 'i')
+#define CACHELESS_INDEX_VERSION    1U
+
+//
+// Built-in kext index header. Kext records immediately follow.
+//
+typedef PACKED struct {
+  //
+  // Must be CACHELESS_INDEX_SIGNATURE.
+  //
+  UINT32              Signature;
+  //
+  // Must be CACHELESS_INDEX_VERSION.
+  //
+  UINT32              Version;
+  //
+  // UUID of the volume the index was built for.
+  //
+  GUID                VolumeUuid;
+  //
+  // Digest of Extensions directory, kext and plugin metadata.
+  //
+  UINT64              ExtensionsDigest;
+  //
+  // Total index size including this header.
+  //
+  UINT32              Size;
+  //
+  // Number of kext records.
+  //
+  UINT32              NumKexts;
+} CACHELESS_INDEX_HEADER;
+
+//
+// Built-in kext index record. Followed by the null-terminated identifier,
+// plist path, binary file name, and binary path strings, in this order,
+// and then by NumDependencies size-prefixed dependency identifiers.
+//
+typedef PACKED struct {
+  //
+  // Identifier size in bytes including the terminator.
+  //
+  UINT16              IdentifierSize;
+  //
+  // Plist path size in bytes including the terminator.
+  //
+  UINT16              PlistPathSize;
+  //
+  // Binary file name size in bytes including the terminator, or 0.
+  //
+  UINT16              BinaryFileNameSize;
+  //
+  // Binary path size in bytes including the terminator, or 0.
+  //
+  UINT16              BinaryPathSize;
+  //
+  // Number of dependencies.
+  //
+  UINT16              NumDependencies;
+  //
+  // OSBundleRequired value.
+  //
+  UINT8               OSBundleRequiredValue;
+  //
+  // Reserved, must be zero.
+  //
+  UINT8               Reserved;
+} CACHELESS_INDEX_KEXT;
+
 //
 // Kext dependency.
 //
@@ -154,6 +226,19 @@ typedef struct {
   //
   LIST_ENTRY          Link;
   //
+  // Link for identifier hash bucket (CACHELESS_CONTEXT -> BuiltInKextsByIdentifier).
+  //
+  LIST_ENTRY          IdentifierLink;
+  //
+  // Link for plist path hash bucket (CACHELESS_CONTEXT -> BuiltInKextsByPlistPath).
+  //
+  LIST_ENTRY          PlistPathLink;
+  //
+  // Link for binary path hash bucket (CACHELESS_CONTEXT -> BuiltInKextsByBinaryPath).
+  // Not inserted when the kext has no binary.
+  //
+  LIST_ENTRY          BinaryPathLink;
+  //
   // Plist path.
   //
   CHAR16              *PlistPath;
@@ -277,4 +362,43 @@ typedef struct {
     BUILTIN_KEXT_SIGNATURE                \
     ))
 
+/**
+  Gets the next element in identifier hash bucket of BUILTIN_KEXT.
+
+  @param[in] This  The current ListEntry.
+**/
+#define GET_BUILTIN_KEXT_FROM_IDENTIFIER_LINK(This)  \
+  (CR (                                              \
+    (This),                                          \
+    BUILTIN_KEXT,                                    \
+    IdentifierLink,                                  \
+    BUILTIN_KEXT_SIGNATURE                           \
+    ))
+
+/**
+  Gets the next element in plist path hash bucket of BUILTIN_KEXT.
+
+  @param[in] This  The current ListEntry.
+**/
+#define GET_BUILTIN_KEXT_FROM_PLIST_PATH_LINK(This)  \
+  (CR (                                              \
+    (This),                                          \
+    BUILTIN_KEXT,                                    \
+    PlistPathLink,                                   \
+    BUILTIN_KEXT_SIGNATURE                           \
+    ))
+
+/**
+  Gets the next element in binary path hash bucket of BUILTIN_KEXT.
+
+  @param[in] This  The current ListEntry.
+**/
+#define GET_BUILTIN_KEXT_FROM_BINARY_PATH_LINK(This)  \
+  (CR (                                               \
+    (This),                                           \
+    BUILTIN_KEXT,                                     \
+    BinaryPathLink,                                   \
+    BUILTIN_KEXT_SIGNATURE                            \
+    ))
+
 #endif
@@ -31,6 +31,12 @@
 //
 #define KERNEL_HEADER_SIZE (EFI_PAGE_SIZE * 2)
 
+//
+// Compressed kernels are read and decompressed in chunks of this size,
+// so that the data is still in cache when it is decoded.
+//
+#define KERNEL_COMPRESSED_CHUNK_SIZE SIZE_256KB
+
 STATIC SHA384_CONTEXT mKernelDigestContext;
 STATIC UINT32         mKernelDigestPosition;
 STATIC BOOLEAN        mNeedKernelDigest;
@@ -206,6 +212,15 @@ ParseCompressedHeader (
   UINT32            CompressedSize;
   UINT32            DecompressedSize;
   UINT32            DecompressedHash;
+  UINT32            ChunkSize;
+  UINT32            ReadSize;
+  UINT32            DecompressedPos;
+  UINT32            HashedPos;
+  UINT32            Hash;
+  UINTN             LzvnPos;
+  OC_LZVN_STREAM    *LzvnStream;
+  OC_LZSS_STREAM    *LzssStream;
+  BOOLEAN           Result;
 
   CompHeader       = (MACH_COMP_HEADER *)*Buffer;
   CompressionType  = CompHeader->Compression;
@@ -223,42 +238,100 @@ ParseCompressedHeader (
     return KernelSize;
   }
 
+  if (CompressionType != MACH_COMPRESSED_BINARY_INVERT_LZVN
+    && CompressionType != MACH_COMPRESSED_BINARY_INVERT_LZSS) {
+    DEBUG ((DEBUG_INFO, "OCAK: Comp kernel unsupported compression %08X at %08X\n", CompressionType, Offset));
+    return KernelSize;
+  }
+
   Status = ReplaceBuffer (DecompressedSize, Buffer, AllocatedSize, ReservedSize);
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_INFO, "OCAK: Decomp kernel (%u bytes) cannot be allocated at %08X\n", DecompressedSize, Offset));
     return KernelSize;
   }
 
-  CompressedBuffer = AllocatePool (CompressedSize);
+  ChunkSize        = MIN (CompressedSize, KERNEL_COMPRESSED_CHUNK_SIZE);
+  CompressedBuffer = AllocatePool (ChunkSize);
   if (CompressedBuffer == NULL) {
-    DEBUG ((DEBUG_INFO, "OCAK: Comp kernel (%u bytes) cannot be allocated at %08X\n", CompressedSize, Offset));
-    return KernelSize;
-  }
-
-  Status = KernelGetFileData (File, Offset + sizeof (MACH_COMP_HEADER), CompressedSize, CompressedBuffer);
-  if (EFI_ERROR (Status)) {
-    DEBUG ((DEBUG_INFO, "OCAK: Comp kernel (%u bytes) cannot be read at %08X\n", CompressedSize, Offset));
-    FreePool (CompressedBuffer);
+    DEBUG ((DEBUG_INFO, "OCAK: Comp kernel chunk (%u bytes) cannot be allocated at %08X\n", ChunkSize, Offset));
     return KernelSize;
   }
 
+  LzvnStream = NULL;
+  LzssStream = NULL;
   if (CompressionType == MACH_COMPRESSED_BINARY_INVERT_LZVN) {
-    KernelSize = (UINT32)DecompressLZVN (*Buffer, DecompressedSize, CompressedBuffer, CompressedSize);
-  } else if (CompressionType == MACH_COMPRESSED_BINARY_INVERT_LZSS) {
-    KernelSize = (UINT32)DecompressLZSS (*Buffer, DecompressedSize, CompressedBuffer, CompressedSize);
+    LzvnStream = DecompressLZVNStreamInit (*Buffer, DecompressedSize);
+    Result     = LzvnStream != NULL;
+  } else {
+    LzssStream = DecompressLZSSStreamInit (*Buffer, DecompressedSize);
+    Result     = LzssStream != NULL;
   }
 
-  if (KernelSize != DecompressedSize) {
-    KernelSize = 0;
+  if (!Result) {
+    DEBUG ((DEBUG_INFO, "OCAK: Comp kernel decompression cannot be started at %08X\n", Offset));
+    FreePool (CompressedBuffer);
+    return KernelSize;
   }
 
   //
-  // TODO: implement adler32 hash verification.
+  // Decompress every chunk right after it is read instead of reading the whole
+  // compressed image first. The checksum is calculated over freshly decompressed
+  // data for the same reason.
   //
-  (VOID) DecompressedHash;
+  DecompressedPos = 0;
+  HashedPos       = 0;
+  Hash            = 1;
+  ReadSize        = 0;
+
+  while (ReadSize < CompressedSize) {
+    ChunkSize = MIN (CompressedSize - ReadSize, KERNEL_COMPRESSED_CHUNK_SIZE);
+
+    Status = KernelGetFileData (
+      File,
+      Offset + sizeof (MACH_COMP_HEADER) + ReadSize,
+      ChunkSize,
+      CompressedBuffer
+      );
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_INFO, "OCAK: Comp kernel (%u bytes) cannot be read at %08X\n", CompressedSize, Offset + ReadSize));
+      break;
+    }
+
+    ReadSize += ChunkSize;
+
+    if (LzvnStream != NULL) {
+      Result          = DecompressLZVNStreamFeed (LzvnStream, CompressedBuffer, ChunkSize, &LzvnPos);
+      DecompressedPos = (UINT32) LzvnPos;
+    } else {
+      Result = DecompressLZSSStreamFeed (LzssStream, CompressedBuffer, ChunkSize, &DecompressedPos);
+    }
+
+    if (!Result) {
+      DEBUG ((DEBUG_INFO, "OCAK: Comp kernel is malformed at %08X\n", Offset + ReadSize));
+      break;
+    }
+
+    Hash      = Adler32Update (Hash, *Buffer + HashedPos, DecompressedPos - HashedPos);
+    HashedPos = DecompressedPos;
+  }
+
+  if (LzvnStream != NULL) {
+    KernelSize = (UINT32) DecompressLZVNStreamFinish (LzvnStream);
+  } else {
+    KernelSize = DecompressLZSSStreamFinish (LzssStream);
+  }
 
   FreePool (CompressedBuffer);
 
+  if (ReadSize != CompressedSize || !Result || KernelSize != DecompressedSize) {
+    return 0;
+  }
+
+  if (Hash != DecompressedHash) {
+    DEBUG ((DEBUG_INFO, "OCAK: Comp kernel hash mismatch %08X vs %08X at %08X\n", Hash, DecompressedHash, Offset));
+    return 0;
+  }
+
   return KernelSize;
 }
 
@@ -1729,6 +1729,10 @@ InternalPrelinkKext (
   // Create and patch the KEXT's VTables.
   //
   Result = InternalPatchByVtables (Context, Kext);
+  //
+  // Relocation lookups are done, the tables are modified below.
+  //
+  MachoFreeRelocationIndex (MachoContext);
   if (!Result) {
     DEBUG ((DEBUG_INFO, "OCAK: Vtable patching failed for kext %a\n", Kext->Identifier));
     return EFI_LOAD_ERROR;
@@ -255,6 +255,119 @@ InsertCachedMkextKext (
   return MkextKext;
 }
 
+STATIC
+BOOLEAN
+DecompressMkextV1Binary (
+  IN OUT MKEXT_CONTEXT      *Context,
+  IN     UINT32             Index,
+     OUT UINT32             *BinOffset,
+     OUT UINT32             *BinSize
+  )
+{
+  MKEXT_V1_KEXT_FILE  *Binary;
+  UINT32              SrcOffset;
+  UINT32              CompSize;
+  UINT32              FullSize;
+  UINT32              FullSizeAligned;
+  UINT32              DstOffset;
+  UINT32              Tmp;
+
+  Binary          = &Context->MkextHeader->V1.Kexts[Index].Binary;
+  SrcOffset       = SwapBytes32 (Binary->Offset);
+  CompSize        = SwapBytes32 (Binary->CompressedSize);
+  FullSize        = SwapBytes32 (Binary->FullSize);
+  FullSizeAligned = MKEXT_ALIGN (FullSize);
+
+  //
+  // Binary is decompressed to the end of mkext, original data is left unused.
+  //
+  DstOffset = Context->MkextSize;
+  if (FullSize == 0
+    || FullSizeAligned < FullSize
+    || OcOverflowAddU32 (SrcOffset, CompSize, &Tmp)
+    || Tmp > Context->MkextSize
+    || OcOverflowAddU32 (DstOffset, FullSizeAligned, &Tmp)
+    || Tmp > Context->MkextAllocSize) {
+    return FALSE;
+  }
+
+  if (DecompressLZSS (
+    &Context->Mkext[DstOffset],
+    FullSize,
+    &Context->Mkext[SrcOffset],
+    CompSize
+    ) != FullSize) {
+    return FALSE;
+  }
+
+  Binary->Offset          = SwapBytes32 (DstOffset);
+  Binary->CompressedSize  = 0;
+  Context->MkextSize      = Tmp;
+
+  *BinOffset  = DstOffset;
+  *BinSize    = FullSize;
+  return TRUE;
+}
+
+STATIC
+BOOLEAN
+DecompressMkextV2Binary (
+  IN OUT MKEXT_CONTEXT      *Context,
+  IN     UINT32             EntryOffset,
+  IN     XML_NODE           *BundleExecutable,
+     OUT CHAR8              *BinOffsetStr,
+     OUT UINT32             *BinOffset,
+     OUT UINT32             *BinSize
+  )
+{
+  MKEXT_V2_FILE_ENTRY *SrcEntry;
+  MKEXT_V2_FILE_ENTRY *DstEntry;
+  UINT32              CompSize;
+  UINT32              FullSize;
+  UINT32              FullSizeAligned;
+  UINT32              DstOffset;
+  UINT32              Tmp;
+
+  SrcEntry        = (MKEXT_V2_FILE_ENTRY *) &Context->Mkext[EntryOffset];
+  CompSize        = SwapBytes32 (SrcEntry->CompressedSize);
+  FullSize        = SwapBytes32 (SrcEntry->FullSize);
+  FullSizeAligned = MKEXT_ALIGN (FullSize);
+
+  //
+  // Binary is decompressed to the current plist location, like injected kexts,
+  // original data is left unused. Plist is exported later from its own copy.
+  //
+  DstOffset = Context->MkextInfoOffset;
+  if (FullSize == 0
+    || FullSizeAligned < FullSize
+    || OcOverflowTriAddU32 (EntryOffset, sizeof (MKEXT_V2_FILE_ENTRY), CompSize, &Tmp)
+    || Tmp > Context->MkextInfoOffset
+    || OcOverflowTriAddU32 (DstOffset, sizeof (MKEXT_V2_FILE_ENTRY), FullSizeAligned, &Tmp)
+    || Tmp >= Context->MkextAllocSize
+    || !AsciiUint64ToLowerHex (BinOffsetStr, KEXT_OFFSET_STR_LEN, DstOffset)) {
+    return FALSE;
+  }
+
+  DstEntry = (MKEXT_V2_FILE_ENTRY *) &Context->Mkext[DstOffset];
+  if (DecompressZLIB (
+    DstEntry->Data,
+    FullSize,
+    SrcEntry->Data,
+    CompSize
+    ) != FullSize) {
+    return FALSE;
+  }
+
+  DstEntry->CompressedSize  = 0;
+  DstEntry->FullSize        = SwapBytes32 (FullSize);
+  XmlNodeChangeContent (BundleExecutable, BinOffsetStr);
+  Context->MkextInfoOffset  = Tmp;
+
+  *BinOffset  = DstOffset + OFFSET_OF (MKEXT_V2_FILE_ENTRY, Data);
+  *BinSize    = FullSize;
+  return TRUE;
+}
+
 MKEXT_KEXT *
 InternalCachedMkextKext (
   IN OUT MKEXT_CONTEXT      *Context,
@@ -285,8 +398,10 @@ InternalCachedMkextKext (
   XML_NODE            *PlistBundleKeyValue;
 
   CONST CHAR8         *KextIdentifier;
+  XML_NODE            *KextExecutable;
   UINT32              KextBinOffset;
   UINT32              KextBinSize;
+  UINT32              KextBinStoredSize;
 
   MkextHeader = Context->MkextHeader;
 
@@ -315,25 +430,29 @@ InternalCachedMkextKext (
   if (Context->MkextVersion == MKEXT_VERSION_V1) {
     for (Index = 0; Index < Context->NumKexts; Index++) {
       //
-      // Do not cache binaryless or compressed kexts.
+      // Do not cache binaryless kexts or kexts with compressed plists.
+      // Compressed binaries are decompressed once found.
       //
       if (MkextHeader->V1.Kexts[Index].Plist.CompressedSize != 0
-        || MkextHeader->V1.Kexts[Index].Binary.CompressedSize != 0
         || MkextHeader->V1.Kexts[Index].Binary.Offset == 0) {
         continue;
       }
 
-      PlistOffset   = SwapBytes32 (MkextHeader->V1.Kexts[Index].Plist.Offset);
-      PlistSize     = SwapBytes32 (MkextHeader->V1.Kexts[Index].Plist.FullSize);
-      KextBinOffset = SwapBytes32 (MkextHeader->V1.Kexts[Index].Binary.Offset);
-      KextBinSize   = SwapBytes32 (MkextHeader->V1.Kexts[Index].Binary.FullSize);
+      PlistOffset       = SwapBytes32 (MkextHeader->V1.Kexts[Index].Plist.Offset);
+      PlistSize         = SwapBytes32 (MkextHeader->V1.Kexts[Index].Plist.FullSize);
+      KextBinOffset     = SwapBytes32 (MkextHeader->V1.Kexts[Index].Binary.Offset);
+      KextBinSize       = SwapBytes32 (MkextHeader->V1.Kexts[Index].Binary.FullSize);
+      KextBinStoredSize = SwapBytes32 (MkextHeader->V1.Kexts[Index].Binary.CompressedSize);
+      if (KextBinStoredSize == 0) {
+        KextBinStoredSize = KextBinSize;
+      }
 
       //
       // Verify plist and binary are within bounds.
       //
       if (OcOverflowAddU32 (PlistOffset, PlistSize, &PlistOffsetSize)
         || PlistOffsetSize > Context->MkextSize
-        || OcOverflowAddU32 (KextBinOffset, KextBinSize, &BinOffsetSize)
+        || OcOverflowAddU32 (KextBinOffset, KextBinStoredSize, &BinOffsetSize)
         || BinOffsetSize > Context->MkextSize) {
         return NULL;
       }
@@ -382,7 +501,13 @@ InternalCachedMkextKext (
     //
     // Bundle was not found, or invalid.
     //
-    if (!IsKextMatch) {
+    if (!IsKextMatch || Index == Context->NumKexts) {
+      return NULL;
+    }
+
+    if (MkextHeader->V1.Kexts[Index].Binary.CompressedSize != 0
+      && !DecompressMkextV1Binary (Context, Index, &KextBinOffset, &KextBinSize)) {
+      DEBUG ((DEBUG_INFO, "OCAK: Failed to decompress %a in mkext\n", Identifier));
       return NULL;
     }
 
@@ -391,6 +516,7 @@ InternalCachedMkextKext (
   //
   } else if (Context->MkextVersion == MKEXT_VERSION_V2) {
     KextIdentifier  = NULL;
+    KextExecutable  = NULL;
     KextBinOffset   = 0;
 
     //
@@ -421,6 +547,7 @@ InternalCachedMkextKext (
           if (!PlistIntegerValue (PlistBundleKeyValue, &KextBinOffset, sizeof (KextBinOffset), TRUE)) {
             return NULL;
           }
+          KextExecutable = PlistBundleKeyValue;
         }
       }
 
@@ -433,6 +560,7 @@ InternalCachedMkextKext (
       }
 
       KextIdentifier  = NULL;
+      KextExecutable  = NULL;
       KextBinOffset   = 0;
     }
 
@@ -445,11 +573,32 @@ InternalCachedMkextKext (
 
     //
     // Parse v2 binary header.
-    // We cannot support compressed binaries.
+    // Compressed binaries are decompressed once found, which requires
+    // offset string storage that lives as long as the cached kext.
     //
     MkextV2FileEntry = (MKEXT_V2_FILE_ENTRY *) &Context->Mkext[KextBinOffset];
     if (MkextV2FileEntry->CompressedSize != 0) {
-      return NULL;
+      MkextKext = InsertCachedMkextKext (Context, Identifier, 0, 0);
+      if (MkextKext == NULL) {
+        return NULL;
+      }
+
+      if (!DecompressMkextV2Binary (
+        Context,
+        KextBinOffset,
+        KextExecutable,
+        MkextKext->BinaryOffsetStr,
+        &MkextKext->BinaryOffset,
+        &MkextKext->BinarySize
+        )) {
+        DEBUG ((DEBUG_INFO, "OCAK: Failed to decompress %a in mkext\n", Identifier));
+        RemoveEntryList (&MkextKext->Link);
+        FreePool (MkextKext->Identifier);
+        FreePool (MkextKext);
+        return NULL;
+      }
+
+      return MkextKext;
     }
     KextBinOffset += OFFSET_OF (MKEXT_V2_FILE_ENTRY, Data);
     KextBinSize   = SwapBytes32 (MkextV2FileEntry->FullSize);
@@ -503,6 +652,9 @@ MkextDecompress (
   UINT32                BinCompSize;
   UINT32                BinFullSize;
   UINT32                BinFullSizeAligned;
+  UINT32                BinStoredSize;
+  UINT32                BinStoredSizeAligned;
+  UINT32                BinReservedSize;
 
   UINT8                 *PlistBuffer;
   XML_DOCUMENT          *PlistXml;
@@ -580,16 +732,29 @@ MkextDecompress (
     }
 
     //
-    // Process plists and binaries if present, decompressing as needed.
+    // Process plists and binaries if present.
+    // Plists are always decompressed, as they are needed for bundle lookup.
+    // Compressed binaries are copied as is and only decompressed on first
+    // access through the mkext context, space for which is reserved here.
     //
     for (Index = 0; Index < NumKexts; Index++) {
       PlistFullSize         = SwapBytes32 (MkextHeader->V1.Kexts[Index].Plist.FullSize);
       BinFullSize           = SwapBytes32 (MkextHeader->V1.Kexts[Index].Binary.FullSize);
+      BinCompSize           = SwapBytes32 (MkextHeader->V1.Kexts[Index].Binary.CompressedSize);
       PlistFullSizeAligned  = MKEXT_ALIGN (PlistFullSize);
       BinFullSizeAligned    = MKEXT_ALIGN (BinFullSize);
 
+      if (BinFullSize == 0) {
+        BinCompSize = 0;
+      }
+
+      BinStoredSize         = BinCompSize > 0 ? BinCompSize : BinFullSize;
+      BinStoredSizeAligned  = MKEXT_ALIGN (BinStoredSize);
+      BinReservedSize       = BinCompSize > 0 ? BinFullSizeAligned : 0;
+
       if (PlistFullSizeAligned < PlistFullSize
-        || BinFullSizeAligned < BinFullSize) {
+        || BinFullSizeAligned < BinFullSize
+        || BinStoredSizeAligned < BinStoredSize) {
         return EFI_INVALID_PARAMETER;
       }
 
@@ -600,9 +765,8 @@ MkextDecompress (
         PlistOffset     = SwapBytes32 (MkextHeader->V1.Kexts[Index].Plist.Offset);
         PlistCompSize   = SwapBytes32 (MkextHeader->V1.Kexts[Index].Plist.CompressedSize);
         BinOffset       = SwapBytes32 (MkextHeader->V1.Kexts[Index].Binary.Offset);
-        BinCompSize     = SwapBytes32 (MkextHeader->V1.Kexts[Index].Binary.CompressedSize);
 
-        if (OcOverflowTriAddU32 (CurrentOffset, PlistFullSizeAligned, BinFullSizeAligned, &Tmp)) {
+        if (OcOverflowTriAddU32 (CurrentOffset, PlistFullSizeAligned, BinStoredSizeAligned, &Tmp)) {
           return EFI_INVALID_PARAMETER;
         }
         if (Tmp > OutBufferSize) {
@@ -639,46 +803,34 @@ MkextDecompress (
 
         if (BinFullSize > 0) {
           //
-          // Compressed size == 0 means no compression.
+          // Binary is copied as is, compressed size == 0 means no compression.
           //
-          if (BinCompSize > 0) {
-            if (OcOverflowAddU32 (BinOffset, BinCompSize, &Tmp)
-              || Tmp > MkextSize
-              || DecompressLZSS (
-                &OutBuffer[CurrentOffset],
-                BinFullSize,
-                &((UINT8 *) Buffer)[BinOffset],
-                BinCompSize
-              ) != BinFullSize) {
-              return EFI_INVALID_PARAMETER;
-            }
-          } else {
-            if (OcOverflowAddU32 (BinOffset, BinFullSize, &Tmp)
-              || Tmp > MkextSize) {
-              return EFI_INVALID_PARAMETER;
-            }
-            CopyMem (&OutBuffer[CurrentOffset], &Buffer[BinOffset], BinFullSize);
+          if (OcOverflowAddU32 (BinOffset, BinStoredSize, &Tmp)
+            || Tmp > MkextSize) {
+            return EFI_INVALID_PARAMETER;
           }
+          CopyMem (&OutBuffer[CurrentOffset], &Buffer[BinOffset], BinStoredSize);
 
           MkextHeaderOut->V1.Kexts[Index].Binary.Offset           = SwapBytes32 (CurrentOffset);
-          MkextHeaderOut->V1.Kexts[Index].Binary.CompressedSize   = 0;
+          MkextHeaderOut->V1.Kexts[Index].Binary.CompressedSize   = SwapBytes32 (BinCompSize);
           MkextHeaderOut->V1.Kexts[Index].Binary.FullSize         = SwapBytes32 (BinFullSize);
           MkextHeaderOut->V1.Kexts[Index].Binary.ModifiedSeconds  = MkextHeader->V1.Kexts[Index].Binary.ModifiedSeconds;
-          CurrentOffset                                           += BinFullSizeAligned;
+          CurrentOffset                                           += BinStoredSizeAligned;
         } else {
           ZeroMem (&MkextHeaderOut->V1.Kexts[Index].Binary, sizeof (MKEXT_V1_KEXT_FILE));
         }
 
       } else {
         //
-        // Calculate size only.
+        // Calculate size only, including space for decompressing the binary later.
         //
         if (OcOverflowTriAddU32 (
           CurrentOffset,
           PlistFullSizeAligned,
-          BinFullSizeAligned,
+          BinStoredSizeAligned,
           &CurrentOffset
-          )) {
+          )
+          || OcOverflowAddU32 (CurrentOffset, BinReservedSize, &CurrentOffset)) {
           return EFI_INVALID_PARAMETER;
         }
       }
@@ -776,8 +928,12 @@ MkextDecompress (
           BinCompSize           = SwapBytes32 (MkextExecutableEntry->CompressedSize);
           BinFullSize           = SwapBytes32 (MkextExecutableEntry->FullSize);
           BinFullSizeAligned    = MKEXT_ALIGN (BinFullSize);
+          BinStoredSize         = BinCompSize > 0 ? BinCompSize : BinFullSize;
+          BinStoredSizeAligned  = MKEXT_ALIGN (BinStoredSize);
 
-          if (OcOverflowTriAddU32 (CurrentOffset, sizeof (MKEXT_V2_FILE_ENTRY), BinFullSizeAligned, &NewOffset)) {
+          if (BinFullSizeAligned < BinFullSize
+            || BinStoredSizeAligned < BinStoredSize
+            || OcOverflowTriAddU32 (CurrentOffset, sizeof (MKEXT_V2_FILE_ENTRY), BinStoredSizeAligned, &NewOffset)) {
             XmlDocumentFree (PlistXml);
             FreePool (PlistBuffer);
             if (Decompress) {
@@ -786,6 +942,17 @@ MkextDecompress (
             return EFI_INVALID_PARAMETER;
           }
 
+          //
+          // When calculating size only, reserve space for decompressing the binary later.
+          //
+          if (!Decompress
+            && BinCompSize > 0
+            && OcOverflowTriAddU32 (NewOffset, sizeof (MKEXT_V2_FILE_ENTRY), BinFullSizeAligned, &NewOffset)) {
+            XmlDocumentFree (PlistXml);
+            FreePool (PlistBuffer);
+            return EFI_INVALID_PARAMETER;
+          }
+
           if (Decompress) {
             if (NewOffset > OutBufferSize) {
               XmlDocumentFree (PlistXml);
@@ -794,38 +961,24 @@ MkextDecompress (
               return EFI_BUFFER_TOO_SMALL;
             }
 
-            MkextOutExecutableEntry                 = (MKEXT_V2_FILE_ENTRY *) &OutBuffer[CurrentOffset];
-            MkextOutExecutableEntry->CompressedSize = 0;
-            MkextOutExecutableEntry->FullSize       = SwapBytes32 (BinFullSize);
-
             //
-            // Compressed size == 0 means no compression.
+            // Binary is copied as is, compressed size == 0 means no compression.
+            // Compressed binaries are only decompressed on first access through
+            // the mkext context.
             //
-            if (BinCompSize > 0) {
-              if (OcOverflowAddU32 (BinOffset, BinCompSize, &Tmp)
-                || Tmp > MkextSize - sizeof (MKEXT_V2_FILE_ENTRY)
-                || DecompressZLIB (
-                  MkextOutExecutableEntry->Data,
-                  BinFullSize,
-                  MkextExecutableEntry->Data,
-                  BinCompSize
-                ) != BinFullSize) {
-                XmlDocumentFree (PlistXml);
-                FreePool (PlistBuffer);
-                FreePool (BinaryOffsetStrings);
-                return EFI_INVALID_PARAMETER;
-              }
-            } else {
-              if (OcOverflowAddU32 (BinOffset, BinFullSize, &Tmp)
-                || Tmp > MkextSize - sizeof (MKEXT_V2_FILE_ENTRY)) {
-                XmlDocumentFree (PlistXml);
-                FreePool (PlistBuffer);
-                FreePool (BinaryOffsetStrings);
-                return EFI_INVALID_PARAMETER;
-              }
-              CopyMem (MkextOutExecutableEntry->Data, MkextExecutableEntry->Data, BinFullSize);
+            if (OcOverflowAddU32 (BinOffset, BinStoredSize, &Tmp)
+              || Tmp > MkextSize - sizeof (MKEXT_V2_FILE_ENTRY)) {
+              XmlDocumentFree (PlistXml);
+              FreePool (PlistBuffer);
+              FreePool (BinaryOffsetStrings);
+              return EFI_INVALID_PARAMETER;
             }
 
+            MkextOutExecutableEntry                 = (MKEXT_V2_FILE_ENTRY *) &OutBuffer[CurrentOffset];
+            MkextOutExecutableEntry->CompressedSize = SwapBytes32 (BinCompSize);
+            MkextOutExecutableEntry->FullSize       = SwapBytes32 (BinFullSize);
+            CopyMem (MkextOutExecutableEntry->Data, MkextExecutableEntry->Data, BinStoredSize);
+
             if (!AsciiUint64ToLowerHex (
               &BinaryOffsetStrings[Index * KEXT_OFFSET_STR_LEN],
               KEXT_OFFSET_STR_LEN,
@@ -864,6 +1017,7 @@ MkextDecompress (
       //
       // Account for plist, future plist expansion for each bundle, 
       //   and additional headers for future kext injection.
+      // Space for decompressing binaries was accounted above.
       //
       PlistFullSize = SwapBytes32 (MkextHeader->V2.PlistFullSize);
       if (OcOverflowAddU32 (CurrentOffset, PlistFullSize, &CurrentOffset)
@@ -946,7 +1100,7 @@ MkextContextInit (
   //
   // Assumptions:
   //    Kexts are aligned to 8 bytes.
-  //    Patching or blocking requires kexts to be decompressed.
+  //    Plists are decompressed, binaries are decompressed on first access.
   //    Plist (for v2) is at end of mkext.
   //    Mkext is big-endian per XNU requirements.
   //
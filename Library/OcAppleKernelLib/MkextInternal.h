@@ -18,6 +18,8 @@
 
 #include <Library/OcAppleKernelLib.h>
 
+#include "PrelinkedInternal.h"
+
 //
 // Cached mkext kext.
 //
@@ -42,6 +44,10 @@ typedef struct {
   // Size of binary in mkext.
   //
   UINT32              BinarySize;
+  //
+  // Binary offset string referenced by mkext v2 plist after decompression.
+  //
+  CHAR8               BinaryOffsetStr[KEXT_OFFSET_STR_LEN];
 } MKEXT_KEXT;
 
 //
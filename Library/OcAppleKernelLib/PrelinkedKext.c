@@ -657,6 +657,8 @@ InternalFreePrelinkedKext (
     Kext->LinkedVtables = NULL;
   }
 
+  MachoFreeRelocationIndex (&Kext->Context.MachContext);
+
   FreePool (Kext);
 }
 
@@ -31,6 +31,7 @@
 
 CHAR16 *
 InternalGetAppleDiskLabel (
+  IN  EFI_HANDLE                       Device,
   IN  EFI_SIMPLE_FILE_SYSTEM_PROTOCOL  *FileSystem,
   IN  CONST CHAR16                     *BootDirectoryName,
   IN  CONST CHAR16                     *LabelFilename
@@ -52,6 +53,11 @@ InternalGetAppleDiskLabel (
   UnicodeSPrint (DiskLabelPath, DiskLabelPathSize, L"%s%s", BootDirectoryName, LabelFilename);
   DEBUG ((DEBUG_INFO, "OCB: Trying to get label from %s\n", DiskLabelPath));
 
+  if (OcBootPolicyCachedFileExists (Device, DiskLabelPath, NULL) == EFI_NOT_FOUND) {
+    FreePool (DiskLabelPath);
+    return NULL;
+  }
+
   AsciiDiskLabel = (CHAR8 *) ReadFile (FileSystem, DiskLabelPath, &DiskLabelLength, OC_MAX_VOLUME_LABEL_SIZE);
   FreePool (DiskLabelPath);
 
@@ -570,9 +576,9 @@ InternalDescribeBootEntry (
   //
   // Try to use APFS-style label or legacy HFS one.
   //
-  BootEntry->Name = InternalGetAppleDiskLabel (FileSystem, BootDirectoryName, L".contentDetails");
+  BootEntry->Name = InternalGetAppleDiskLabel (Device, FileSystem, BootDirectoryName, L".contentDetails");
   if (BootEntry->Name == NULL) {
-    BootEntry->Name = InternalGetAppleDiskLabel (FileSystem, BootDirectoryName, L".disk_label.contentDetails");
+    BootEntry->Name = InternalGetAppleDiskLabel (Device, FileSystem, BootDirectoryName, L".disk_label.contentDetails");
   }
 
   //
@@ -595,7 +601,10 @@ InternalDescribeBootEntry (
   //
   if (BootEntry->Type == OC_BOOT_UNKNOWN && BootEntry->IsGeneric) {
     DEBUG ((DEBUG_INFO, "OCB: Trying to detect Microsoft BCD\n"));
-    Status = ReadFileSize (FileSystem, L"\\EFI\\Microsoft\\Boot\\BCD", &BcdSize);
+    Status = OcBootPolicyCachedFileExists (Device, L"\\EFI\\Microsoft\\Boot\\BCD", NULL);
+    if (Status != EFI_NOT_FOUND) {
+      Status = ReadFileSize (FileSystem, L"\\EFI\\Microsoft\\Boot\\BCD", &BcdSize);
+    }
     if (!EFI_ERROR (Status)) {
       BootEntry->Type = OC_BOOT_WINDOWS;
     }
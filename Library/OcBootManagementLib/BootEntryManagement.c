@@ -1722,8 +1722,9 @@ OcSetDefaultBootRecovery (
   return EFI_NOT_FOUND;
 }
 
+STATIC
 OC_BOOT_CONTEXT *
-OcScanForBootEntries (
+InternalScanForBootEntries (
   IN  OC_PICKER_CONTEXT  *Context
   )
 {
@@ -1850,7 +1851,25 @@ OcScanForBootEntries (
 }
 
 OC_BOOT_CONTEXT *
-OcScanForDefaultBootEntry (
+OcScanForBootEntries (
+  IN  OC_PICKER_CONTEXT  *Context
+  )
+{
+  OC_BOOT_CONTEXT  *BootContext;
+
+  //
+  // Share directory listings between policy, recovery and label lookups.
+  //
+  OcBootPolicyEnableDirectoryCache ();
+  BootContext = InternalScanForBootEntries (Context);
+  OcBootPolicyDisableDirectoryCache ();
+
+  return BootContext;
+}
+
+STATIC
+OC_BOOT_CONTEXT *
+InternalScanForDefaultBootEntry (
   IN  OC_PICKER_CONTEXT  *Context
   )
 {
@@ -1988,6 +2007,23 @@ OcScanForDefaultBootEntry (
   return BootContext;
 }
 
+OC_BOOT_CONTEXT *
+OcScanForDefaultBootEntry (
+  IN  OC_PICKER_CONTEXT  *Context
+  )
+{
+  OC_BOOT_CONTEXT  *BootContext;
+
+  //
+  // Share directory listings between policy, recovery and label lookups.
+  //
+  OcBootPolicyEnableDirectoryCache ();
+  BootContext = InternalScanForDefaultBootEntry (Context);
+  OcBootPolicyDisableDirectoryCache ();
+
+  return BootContext;
+}
+
 OC_BOOT_ENTRY  **
 OcEnumerateEntries (
   IN  OC_BOOT_CONTEXT  *BootContext
@@ -97,6 +97,7 @@ InternalUnloadDmg (
 
 CHAR16 *
 InternalGetAppleDiskLabel (
+  IN  EFI_HANDLE                       Device,
   IN  EFI_SIMPLE_FILE_SYSTEM_PROTOCOL  *FileSystem,
   IN  CONST CHAR16                     *BootDirectoryName,
   IN  CONST CHAR16                     *LabelFilename
@@ -14,6 +14,8 @@
 
 #include "BootManagementInternal.h"
 
+#include <Protocol/AppleImg4Verification.h>
+#include <Protocol/AppleSecureBoot.h>
 #include <Protocol/DevicePath.h>
 #include <Protocol/LoadedImage.h>
 #include <Protocol/SimpleFileSystem.h>
@@ -28,8 +30,10 @@
 #include <Library/OcDebugLogLib.h>
 #include <Library/DevicePathLib.h>
 #include <Library/MemoryAllocationLib.h>
+#include <Library/OcAppleImg4Lib.h>
 #include <Library/OcAppleSecureBootLib.h>
 #include <Library/OcBootManagementLib.h>
+#include <Library/OcCryptoLib.h>
 #include <Library/OcDevicePathLib.h>
 #include <Library/OcFileLib.h>
 #include <Library/OcMachoLib.h>
@@ -49,6 +53,11 @@
   #error Unsupported architecture.
 #endif
 
+//
+// Image read granularity when hashing, matches GetFileData read portions.
+//
+#define OC_IMAGE_LOADER_CHUNK_SIZE  BASE_1MB
+
 STATIC EFI_GUID mOcLoadedImageProtocolGuid = {
   0x1f3c963d, 0xf9dc, 0x4537, { 0xbb, 0x06, 0xd8, 0x08, 0x46, 0x4a, 0x85, 0x2e }
 };
@@ -78,18 +87,51 @@ STATIC OC_IMAGE_LOADER_CONFIGURE mImageLoaderConfigure;
 STATIC UINT32                    mImageLoaderCaps;
 STATIC BOOLEAN                   mImageLoaderEnabled;
 
+/**
+  Check whether Apple Secure Boot is going to verify loaded images
+  and thus needs their digest.
+
+  @retval TRUE when image digest is needed.
+**/
+STATIC
+BOOLEAN
+InternalNeedImageDigest (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  APPLE_SECURE_BOOT_PROTOCOL  *SecureBoot;
+  UINT8                       Policy;
+
+  if (!mImageLoaderEnabled) {
+    return FALSE;
+  }
+
+  SecureBoot = OcAppleSecureBootGetProtocol ();
+  Status = SecureBoot->GetPolicy (
+    SecureBoot,
+    &Policy
+    );
+
+  return !EFI_ERROR (Status) && Policy != AppleImg4SbModeDisabled;
+}
+
 STATIC
 EFI_STATUS
 InternalEfiLoadImageFile (
   IN  EFI_DEVICE_PATH_PROTOCOL  *DevicePath,
   OUT UINTN                     *FileSize,
-  OUT VOID                      **FileBuffer
+  OUT VOID                      **FileBuffer,
+  OUT UINT8                     *Digest  OPTIONAL
   )
 {
   EFI_STATUS         Status;
   EFI_FILE_PROTOCOL  *File;
-  VOID               *Buffer;
+  UINT8              *Buffer;
   UINT32             Size;
+  UINT32             Position;
+  UINT32             ChunkSize;
+  SHA384_CONTEXT     Context;
 
   Status = OcOpenFileByDevicePath (
     &DevicePath,
@@ -116,16 +158,41 @@ InternalEfiLoadImageFile (
     return EFI_OUT_OF_RESOURCES;
   }
 
-  Status = GetFileData (
-    File,
-    0,
-    Size,
-    Buffer
-    );
-  if (EFI_ERROR (Status)) {
-    FreePool (Buffer);
-    File->Close (File);
-    return EFI_DEVICE_ERROR;
+  //
+  // Hash the image while reading it, so that each chunk is hashed
+  // while it is still in cache and the image is not traversed again
+  // during verification.
+  //
+  if (Digest != NULL) {
+    Sha384Init (&Context);
+    ChunkSize = OC_IMAGE_LOADER_CHUNK_SIZE;
+  } else {
+    ChunkSize = Size;
+  }
+
+  for (Position = 0; Position < Size; Position += ChunkSize) {
+    ChunkSize = MIN (Size - Position, ChunkSize);
+    Status = GetFileData (
+      File,
+      Position,
+      ChunkSize,
+      &Buffer[Position]
+      );
+    if (EFI_ERROR (Status)) {
+      FreePool (Buffer);
+      File->Close (File);
+      return EFI_DEVICE_ERROR;
+    }
+
+    if (Digest != NULL) {
+      Sha384Update (&Context, &Buffer[Position], ChunkSize);
+    }
+  }
+
+  File->Close (File);
+
+  if (Digest != NULL) {
+    Sha384Final (&Context, Digest);
   }
 
   *FileBuffer = Buffer;
@@ -690,6 +757,8 @@ InternalEfiLoadImage (
   EFI_STATUS                 Status;
   VOID                       *AllocatedBuffer;
   UINT32                     RealSize;
+  BOOLEAN                    HasDigest;
+  UINT8                      Digest[SHA384_DIGEST_SIZE];
 
   if (ParentImageHandle == NULL || ImageHandle == NULL) {
     return EFI_INVALID_PARAMETER;
@@ -704,13 +773,17 @@ InternalEfiLoadImage (
   }
 
   AllocatedBuffer = NULL;
+  HasDigest       = FALSE;
   if (SourceBuffer == NULL) {
+    HasDigest = InternalNeedImageDigest ();
     Status = InternalEfiLoadImageFile (
       DevicePath,
       &SourceSize,
-      &SourceBuffer
+      &SourceBuffer,
+      HasDigest ? Digest : NULL
       );
     if (EFI_ERROR (Status)) {
+      HasDigest = FALSE;
       Status = InternalEfiLoadImageProtocol (
         DevicePath,
         BootPolicy == FALSE,
@@ -725,11 +798,19 @@ InternalEfiLoadImage (
   }
 
   if (DevicePath != NULL && SourceBuffer != NULL && mImageLoaderEnabled) {
+    if (HasDigest) {
+      OcAppleImg4RegisterDigest (SourceBuffer, SourceSize, Digest);
+    }
+
     SecureBootStatus = OcAppleSecureBootVerify (
       DevicePath,
       SourceBuffer,
       SourceSize
       );
+
+    if (HasDigest) {
+      OcAppleImg4RegisterDigest (NULL, 0, NULL);
+    }
   } else {
     SecureBootStatus = EFI_UNSUPPORTED;
   }
@@ -14,6 +14,102 @@
 
 #include <Library/OcCompressionLib.h>
 
+/**
+  RLE24 channel decoding state.
+**/
+typedef struct {
+  //
+  // Next control byte.
+  //
+  CONST UINT8  *Src;
+  //
+  // Channel value for the current pixel, advanced by Step after each pixel.
+  //
+  CONST UINT8  *Value;
+  UINT32       Step;
+  //
+  // Pixels left in the current sequence.
+  //
+  UINT32       Count;
+  //
+  // Value of the current repeat sequence.
+  //
+  UINT8        Repeat;
+} RLE24_CHANNEL;
+
+/**
+  Start next RLE24 sequence of the channel. The sequence must be validated.
+
+  @param[in,out]  Channel  Channel decoding state.
+**/
+STATIC
+VOID
+InternalRle24NextSequence (
+  IN OUT RLE24_CHANNEL  *Channel
+  )
+{
+  UINT8  ControlValue;
+
+  ControlValue = *Channel->Src++;
+  if (ControlValue & BIT7) {
+    Channel->Count  = ControlValue - 125U;
+    Channel->Repeat = *Channel->Src++;
+    Channel->Value  = &Channel->Repeat;
+    Channel->Step   = 0;
+  } else {
+    Channel->Count  = ControlValue + 1U;
+    Channel->Value  = Channel->Src;
+    Channel->Step   = 1;
+    Channel->Src   += Channel->Count;
+  }
+}
+
+/**
+  Multiply 0x00RRGGBB colour by alpha, exactly matching (C * Alpha) / 255
+  for every channel. Red and blue are processed together in 16-bit lanes.
+
+  @param[in]  Color  Colour value.
+  @param[in]  Alpha  Alpha value.
+
+  @return  Premultiplied 0xAARRGGBB pixel.
+**/
+STATIC
+UINT32
+InternalPremultiplyPixel (
+  IN UINT32  Color,
+  IN UINT32  Alpha
+  )
+{
+  UINT32  RedBlue;
+  UINT32  Green;
+
+  RedBlue = (Color & 0x00FF00FFU) * Alpha;
+  RedBlue = ((RedBlue + 0x00010001U + ((RedBlue >> 8U) & 0x00FF00FFU)) >> 8U) & 0x00FF00FFU;
+  Green   = ((Color >> 8U) & 0xFFU) * Alpha;
+  Green   = (Green + 1U + (Green >> 8U)) >> 8U;
+
+  return RedBlue | (Green << 8U) | (Alpha << 24U);
+}
+
+/**
+  Store 0xAARRGGBB pixel as BGRA.
+
+  @param[out]  Dst    Destination pixel.
+  @param[in]   Pixel  Pixel value.
+**/
+STATIC
+VOID
+InternalStorePixel (
+  OUT UINT8   *Dst,
+  IN  UINT32  Pixel
+  )
+{
+  Dst[0] = (UINT8) Pixel;
+  Dst[1] = (UINT8) (Pixel >> 8U);
+  Dst[2] = (UINT8) (Pixel >> 16U);
+  Dst[3] = (UINT8) (Pixel >> 24U);
+}
+
 UINT32
 DecompressMaskedRLE24 (
   OUT UINT8   *Dst,
@@ -38,13 +134,21 @@ DecompressMaskedRLE24 (
   // suit by calling it RLE24 just as others do.
   //
 
-  UINT8  *SrcEnd;
-  UINT8  *SrcLast;
-  UINT8  *DstCur;
-  UINT8  *DstEnd;
-  UINT8  ControlValue;
-  UINT8  DstValue;
-  UINT8  RunIndex;
+  UINT8          *SrcEnd;
+  UINT8          *SrcLast;
+  UINT8          *DstCur;
+  UINT8          *MaskEnd;
+  UINT8          ControlValue;
+  UINT8          Alpha;
+  UINT32         Remaining;
+  UINT32         Count;
+  UINT32         Color;
+  UINT32         Pixel;
+  UINT32         RunIndex;
+  RLE24_CHANNEL  Channels[3];
+  RLE24_CHANNEL  *Red;
+  RLE24_CHANNEL  *Green;
+  RLE24_CHANNEL  *Blue;
 
   if (SrcLen < 2 || MaskLen != DstLen / sizeof (UINT32)) {
     return 0;
@@ -54,85 +158,127 @@ DecompressMaskedRLE24 (
   SrcLast = SrcEnd - 1;
 
   //
-  // Run over all channels.
+  // Validate all channels and find where each of them starts, so that
+  // they can be decoded together into BGRA pixels in one pass.
+  // Only control bytes are read here.
   //
   for (RunIndex = 0; RunIndex < 3 && Src < SrcLast; ++RunIndex) {
-    //
-    // The resulting image is in BGRA format.
-    //
-    DstCur = Dst + 2 - RunIndex;
-    DstEnd = DstCur + MaskLen * sizeof (UINT32);
+    Channels[RunIndex].Src   = Src;
+    Channels[RunIndex].Count = 0;
+    Remaining                = MaskLen;
 
     //
     // Iterate as long as we have enough control values.
     //
-    while (Src < SrcLast && DstCur < DstEnd) {
-      //
-      // Process repeat sequences.
-      //
+    while (Src < SrcLast && Remaining > 0) {
       ControlValue = *Src++;
       if (ControlValue & BIT7) {
         ControlValue -= 125;
-        DstValue      = *Src++;
+        ++Src;
 
         //
         // Early exit on not enough bytes to fill.
         //
-        if ((UINT32) (DstEnd - DstCur) < ControlValue * sizeof (UINT32)) {
+        if (Remaining < ControlValue) {
           return 0;
         }
-
-        while (ControlValue > 0) {
-          *DstCur = DstValue;
-          DstCur += sizeof (UINT32);
-          --ControlValue;
-        }
       } else {
         ++ControlValue;
 
         //
         // Early exit on not enough bytes to read or fill.
         //
-        if ((UINT32) (SrcEnd - Src) < ControlValue || (UINT32) (DstEnd - DstCur) < ControlValue * sizeof (UINT32)) {
+        if ((UINT32) (SrcEnd - Src) < ControlValue || Remaining < ControlValue) {
           return 0;
         }
 
-        while (ControlValue > 0) {
-          *DstCur = *Src++;
-          DstCur += sizeof (UINT32);
-          --ControlValue;
-        }
+        Src += ControlValue;
       }
+
+      Remaining -= ControlValue;
     }
 
     //
     // We failed fill the current run, abort.
     //
-    if (DstCur != DstEnd) {
+    if (Remaining != 0) {
       return 0;
     }
   }
 
   //
-  // Add mask to the resulting BGRA image.
+  // Channels missing from a truncated source keep destination contents.
   //
-  if (Premultiply) {
-    DstCur = Dst;
-    SrcEnd = Mask + MaskLen;
-    while (Mask < SrcEnd) {
-      DstValue  = *Mask++;
-      DstCur[0] = (UINT8) ((DstCur[0] * DstValue) / 0xFF);
-      DstCur[1] = (UINT8) ((DstCur[1] * DstValue) / 0xFF);
-      DstCur[2] = (UINT8) ((DstCur[2] * DstValue) / 0xFF);
-      DstCur[3] = DstValue;
-      DstCur   += sizeof (UINT32);
+  for (; RunIndex < 3; ++RunIndex) {
+    Channels[RunIndex].Value = Dst + 2 - RunIndex;
+    Channels[RunIndex].Step  = sizeof (UINT32);
+    Channels[RunIndex].Count = MAX_UINT32;
+  }
+
+  Red     = &Channels[0];
+  Green   = &Channels[1];
+  Blue    = &Channels[2];
+  DstCur  = Dst;
+  MaskEnd = Mask + MaskLen;
+
+  while (Mask < MaskEnd) {
+    //
+    // Process the longest span, in which no channel changes its sequence.
+    //
+    Count = (UINT32) (MaskEnd - Mask);
+    for (RunIndex = 0; RunIndex < 3; ++RunIndex) {
+      if (Channels[RunIndex].Count == 0) {
+        InternalRle24NextSequence (&Channels[RunIndex]);
+      }
+
+      Count = MIN (Count, Channels[RunIndex].Count);
     }
-  } else {
-    DstCur = Dst + 3;
-    SrcEnd = Mask + MaskLen;
-    while (Mask < SrcEnd) {
-      *DstCur = *Mask++;
-      DstCur += sizeof (UINT32);
+
+    Red->Count   -= Count;
+    Green->Count -= Count;
+    Blue->Count  -= Count;
+
+    if ((Red->Step | Green->Step | Blue->Step) == 0) {
+      //
+      // Solid colour fill, only alpha changes. Icons mostly consist
+      // of such spans with large areas of constant alpha.
+      //
+      Color = Blue->Repeat | ((UINT32) Green->Repeat << 8U) | ((UINT32) Red->Repeat << 16U);
+      Alpha = *Mask;
+      Pixel = Premultiply ? InternalPremultiplyPixel (Color, Alpha) : Color | ((UINT32) Alpha << 24U);
+
+      while (Count > 0) {
+        if (*Mask != Alpha) {
+          Alpha = *Mask;
+          Pixel = Premultiply ? InternalPremultiplyPixel (Color, Alpha) : Color | ((UINT32) Alpha << 24U);
+        }
+
+        InternalStorePixel (DstCur, Pixel);
+        DstCur += sizeof (UINT32);
+        ++Mask;
+        --Count;
+      }
+    } else {
+      //
+      // Raw sequence in at least one channel, repeated channels do not advance.
+      //
+      while (Count > 0) {
+        Color = *Blue->Value | ((UINT32) *Green->Value << 8U) | ((UINT32) *Red->Value << 16U);
+        Blue->Value  += Blue->Step;
+        Green->Value += Green->Step;
+        Red->Value   += Red->Step;
+
+        if (Premultiply) {
+          Pixel = InternalPremultiplyPixel (Color, *Mask);
+        } else {
+          Pixel = Color | ((UINT32) *Mask << 24U);
+        }
+
+        InternalStorePixel (DstCur, Pixel);
+        DstCur += sizeof (UINT32);
+        ++Mask;
+        --Count;
+      }
     }
   }
 
@@ -137,6 +137,141 @@ u_int32_t decompress_lzss(
     return (u_int32_t)(dst - dststart);
 }
 
+/*
+ * Incremental decoder state. Tokens may be split across source chunks,
+ * so the position within the current token is kept in stage.
+ */
+enum {
+    LZSS_STAGE_TOKEN,
+    LZSS_STAGE_LITERAL,
+    LZSS_STAGE_MATCH_LOW,
+    LZSS_STAGE_MATCH_HIGH
+};
+
+struct OC_LZSS_STREAM_ {
+    /* ring buffer of size N, with extra F-1 bytes to aid string comparison */
+    u_int8_t text_buf[N + F - 1];
+    u_int8_t * dststart;
+    u_int8_t * dst;
+    u_int8_t * dstend;
+    unsigned int flags;
+    int r;
+    int i;
+    int stage;
+};
+
+/*******************************************************************************
+*******************************************************************************/
+OC_LZSS_STREAM * decompress_lzss_stream_init(
+    u_int8_t       * dst,
+    u_int32_t        dstlen)
+{
+    OC_LZSS_STREAM * sp;
+
+    if (dstlen > OC_COMPRESSION_MAX_LENGTH) {
+        return NULL;
+    }
+
+    sp = malloc(sizeof(*sp));
+    if (sp == NULL) {
+        return NULL;
+    }
+
+    memset(sp->text_buf, ' ', N - F);
+    sp->dststart = dst;
+    sp->dst = dst;
+    sp->dstend = dst + dstlen;
+    sp->flags = 0;
+    sp->r = N - F;
+    sp->i = 0;
+    sp->stage = LZSS_STAGE_TOKEN;
+
+    return sp;
+}
+
+/*******************************************************************************
+*******************************************************************************/
+BOOLEAN decompress_lzss_stream_feed(
+    OC_LZSS_STREAM * sp,
+    const u_int8_t * src,
+    u_int32_t        srclen,
+    u_int32_t      * dstpos)
+{
+    u_int8_t * text_buf = sp->text_buf;
+    u_int8_t * dst = sp->dst;
+    const u_int8_t * dstend = sp->dstend;
+    const u_int8_t * srcend = src + srclen;
+    unsigned int flags = sp->flags;
+    int  r = sp->r;
+    int  i = sp->i;
+    int  stage = sp->stage;
+    int  j, k;
+    u_int8_t c;
+
+    /*
+     * Same as decompress_lzss, except that running out of source in the
+     * middle of a token only suspends decoding until the next chunk.
+     */
+    while (src < srcend && dst < dstend) {
+        switch (stage) {
+            case LZSS_STAGE_TOKEN:
+                if (((flags >>= 1) & 0x100) == 0) {
+                    flags = *src++ | 0xFF00;  /* uses higher byte cleverly */
+                }   /* to count eight */
+                stage = (flags & 1) ? LZSS_STAGE_LITERAL : LZSS_STAGE_MATCH_LOW;
+                break;
+            case LZSS_STAGE_LITERAL:
+                c = *src++;
+                *dst++ = c;
+                text_buf[r++] = c;
+                r &= (N - 1);
+                stage = LZSS_STAGE_TOKEN;
+                break;
+            case LZSS_STAGE_MATCH_LOW:
+                i = *src++;
+                stage = LZSS_STAGE_MATCH_HIGH;
+                break;
+            default:
+                j = *src++;
+                i |= ((j & 0xF0) << 4);
+                j  =  (j & 0x0F) + THRESHOLD;
+                for (k = 0; k <= j; k++) {
+                    c = text_buf[(i + k) & (N - 1)];
+                    if (dst < dstend) *dst++ = c; else break;
+                    text_buf[r++] = c;
+                    r &= (N - 1);
+                }
+                stage = LZSS_STAGE_TOKEN;
+                break;
+        }
+    }
+
+    sp->dst = dst;
+    sp->flags = flags;
+    sp->r = r;
+    sp->i = i;
+    sp->stage = stage;
+
+    if (dstpos != NULL) {
+        *dstpos = (u_int32_t)(dst - sp->dststart);
+    }
+
+    /* Every byte sequence is a valid LZSS stream. */
+    return TRUE;
+}
+
+/*******************************************************************************
+*******************************************************************************/
+u_int32_t decompress_lzss_stream_finish(
+    OC_LZSS_STREAM * sp)
+{
+    u_int32_t dstlen;
+
+    dstlen = (u_int32_t)(sp->dst - sp->dststart);
+    free(sp);
+    return dstlen;
+}
+
 /*
  * initialize state, mostly the trees
  *
@@ -843,3 +843,117 @@ size_t lzvn_decode_buffer(unsigned char *dst, size_t dst_size,
   // This is how much we decompressed
   return dstate.dst - dst;
 }
+
+//  Incremental decoding. lzvn_decode already stops at the last complete
+//  instruction when the source is truncated, so only the incomplete tail
+//  of every chunk needs to be kept. The longest instruction is lrg_l with
+//  two opcode bytes and 271 literal bytes, and the decoder also needs the
+//  first byte of the next opcode, so a tail this long that still cannot be
+//  decoded means the source is invalid.
+#define LZVN_STREAM_PENDING_SIZE 512
+
+struct OC_LZVN_STREAM_ {
+  lzvn_decoder_state state;
+  // Incomplete instruction bytes carried over from the previous chunk
+  unsigned char pending[LZVN_STREAM_PENDING_SIZE];
+  size_t pending_len;
+  // Set once the source was found to be invalid
+  int failed;
+};
+
+OC_LZVN_STREAM *lzvn_decode_stream_init(unsigned char *dst,
+                                        size_t dst_size) {
+  OC_LZVN_STREAM *stream;
+
+  if (dst_size > OC_COMPRESSION_MAX_LENGTH) {
+    return NULL;
+  }
+
+  stream = AllocateZeroPool(sizeof(*stream));
+  if (stream == NULL) {
+    return NULL;
+  }
+
+  stream->state.dst_begin = dst;
+  stream->state.dst = dst;
+  stream->state.dst_end = dst + dst_size;
+
+  return stream;
+}
+
+BOOLEAN lzvn_decode_stream_feed(OC_LZVN_STREAM *stream,
+                                const unsigned char *src, size_t src_size,
+                                size_t *dst_pos) {
+  lzvn_decoder_state *state = &stream->state;
+  size_t take;
+  size_t used;
+  size_t old_len;
+
+  //  Finish the instruction split between the previous chunk and this one.
+  //  The tail is topped up from the new chunk until the decoder gets past
+  //  the carried bytes, after which the rest is decoded in place.
+  while (stream->pending_len > 0 && src_size > 0 && !stream->failed
+    && !state->end_of_stream && state->dst < state->dst_end) {
+    old_len = stream->pending_len;
+    take = LZVN_STREAM_PENDING_SIZE - old_len;
+    if (take > src_size)
+      take = src_size;
+    memcpy(&stream->pending[old_len], src, take);
+    stream->pending_len += take;
+    src += take;
+    src_size -= take;
+
+    state->src = stream->pending;
+    state->src_end = stream->pending + stream->pending_len;
+    lzvn_decode(state);
+    used = state->src - stream->pending;
+
+    if (used >= old_len) {
+      //  Everything left in pending came from this chunk, continue there.
+      src -= stream->pending_len - used;
+      src_size += stream->pending_len - used;
+      stream->pending_len = 0;
+    } else if (used == 0 && stream->pending_len == LZVN_STREAM_PENDING_SIZE) {
+      stream->failed = 1;
+    } else {
+      memmove(stream->pending, &stream->pending[used],
+              stream->pending_len - used);
+      stream->pending_len -= used;
+    }
+  }
+
+  if (stream->pending_len == 0 && src_size > 0 && !stream->failed
+    && !state->end_of_stream && state->dst < state->dst_end) {
+    state->src = src;
+    state->src_end = src + src_size;
+    lzvn_decode(state);
+    used = state->src - src;
+
+    if (!state->end_of_stream && state->dst < state->dst_end) {
+      if (src_size - used >= LZVN_STREAM_PENDING_SIZE) {
+        stream->failed = 1;
+      } else {
+        memcpy(stream->pending, src + used, src_size - used);
+        stream->pending_len = src_size - used;
+      }
+    }
+  }
+
+  //  The chunk is gone after we return.
+  state->src = NULL;
+  state->src_end = NULL;
+
+  if (dst_pos != NULL) {
+    *dst_pos = state->dst - state->dst_begin;
+  }
+
+  return !stream->failed;
+}
+
+size_t lzvn_decode_stream_finish(OC_LZVN_STREAM *stream) {
+  size_t dst_len;
+
+  dst_len = stream->state.dst - stream->state.dst_begin;
+  FreePool(stream);
+  return dst_len;
+}
@@ -16,9 +16,13 @@
 #define LZVN_H
 
 #include <Library/BaseMemoryLib.h>
+#include <Library/MemoryAllocationLib.h>
 #include <Library/OcCompressionLib.h>
 
 #define lzvn_decode_buffer DecompressLZVN
+#define lzvn_decode_stream_init DecompressLZVNStreamInit
+#define lzvn_decode_stream_feed DecompressLZVNStreamFeed
+#define lzvn_decode_stream_finish DecompressLZVNStreamFinish
 
 #ifdef EFIUSER
 #include <stdint.h>
@@ -53,8 +57,13 @@ typedef UINTN uintmax_t;
 #undef memcpy
 #endif
 
+#ifdef memmove
+#undef memmove
+#endif
+
 #define memset(Dst, Value, Size) SetMem ((Dst), (Size), (UINT8)(Value))
 #define memcpy(Dst, Src, Size) CopyMem ((Dst), (Src), (Size))
+#define memmove(Dst, Src, Size) CopyMem ((Dst), (Src), (Size))
 
 #endif
 
@@ -8,6 +8,14 @@
 #include "inflate.h"
 #include "inffast.h"
 
+#include <Library/BaseLib.h>
+
+#ifdef INFLATE_FAST_WIDE
+typedef UINT64 z_hold_t;
+#else
+typedef unsigned long z_hold_t;
+#endif
+
 #ifdef ASMINF
 #  pragma message("Assembler code may have bugs -- use at your own risk")
 #else
@@ -23,8 +31,8 @@
    Entry assumptions:
 
         state->mode == LEN
-        strm->avail_in >= 6
-        strm->avail_out >= 258
+        strm->avail_in >= INFLATE_FAST_MIN_INPUT
+        strm->avail_out >= INFLATE_FAST_MIN_OUTPUT
         start >= strm->avail_out
         state->bits < 8
 
@@ -46,6 +54,15 @@
       bytes, which is the maximum length that can be coded.  inflate_fast()
       requires strm->avail_out >= 258 for each loop to avoid checking for
       output space.
+
+    - EDIT (agent): With INFLATE_FAST_WIDE the bit buffer is refilled to at
+      least 56 bits with a single unaligned 8-byte load, so a length/distance
+      pair is decoded without further refills.  Bits above the valid count
+      may hold the next input bits, they are masked out on return.  Matches
+      at least 8 bytes back are copied in 8-byte words, writing up to 7 bytes
+      past the match end.  Longer matches with shorter distances repeat with
+      any multiple of the distance once the first few bytes are copied, so
+      the nearest multiple of at least 8 is used instead.
  */
 void ZLIB_INTERNAL inflate_fast(strm, start)
 z_streamp strm;
@@ -64,7 +81,7 @@ unsigned start;         /* inflate()'s starting value for strm->avail_out */
     unsigned whave;             /* valid bytes in the window */
     unsigned wnext;             /* window write index */
     unsigned char FAR *window;  /* allocated sliding window, if wsize != 0 */
-    unsigned long hold;         /* local strm->hold */
+    z_hold_t hold;              /* local strm->hold */
     unsigned bits;              /* local strm->bits */
     code const FAR *lcode;      /* local strm->lencode */
     code const FAR *dcode;      /* local strm->distcode */
@@ -76,14 +93,18 @@ unsigned start;         /* inflate()'s starting value for strm->avail_out */
     unsigned len;               /* match length, unused bytes */
     unsigned dist;              /* match distance */
     unsigned char FAR *from;    /* where to copy match from */
+#ifdef INFLATE_FAST_WIDE
+    unsigned char FAR *mend;    /* end of match being copied */
+    unsigned wdist;             /* match distance repeated to 8 or more */
+#endif
 
     /* copy state to local variables */
     state = (struct inflate_state FAR *)strm->state;
     in = strm->next_in;
-    last = in + (strm->avail_in - 5);
+    last = in + (strm->avail_in - (INFLATE_FAST_MIN_INPUT - 1));
     out = strm->next_out;
     beg = out - (start - strm->avail_out);
-    end = out + (strm->avail_out - 257);
+    end = out + (strm->avail_out - (INFLATE_FAST_MIN_OUTPUT - 1));
 #ifdef INFLATE_STRICT
     dmax = state->dmax;
 #endif
@@ -101,12 +122,20 @@ unsigned start;         /* inflate()'s starting value for strm->avail_out */
     /* decode literals and length/distances until end-of-block or not enough
        input data or output space */
     do {
+#ifdef INFLATE_FAST_WIDE
+        if (bits < 48) {
+            hold |= ReadUnaligned64 ((CONST UINT64 *) in) << bits;
+            in += (63 - bits) >> 3;
+            bits |= 56;
+        }
+#else
         if (bits < 15) {
             hold += (unsigned long)(*in++) << bits;
             bits += 8;
             hold += (unsigned long)(*in++) << bits;
             bits += 8;
         }
+#endif
         here = lcode + (hold & lmask);
       dolen:
         op = (unsigned)(here->bits);
@@ -250,6 +279,31 @@ unsigned start;         /* inflate()'s starting value for strm->avail_out */
                 }
                 else {
                     from = out - dist;          /* copy direct from output */
+#ifdef INFLATE_FAST_WIDE
+                    if (dist < 8 && len > 8) {  /* repeat short patterns */
+                        wdist = dist;
+                        do {
+                            wdist += dist;
+                        } while (wdist < 8);
+                        op = wdist - dist;
+                        len -= op;
+                        do {
+                            *out++ = *from++;
+                        } while (--op);
+                        from = out - wdist;
+                    }
+                    if (from + 8 <= out) {
+                        mend = out + len;
+                        do {
+                            WriteUnaligned64 ((UINT64 *) out,
+                                ReadUnaligned64 ((CONST UINT64 *) from));
+                            out += 8;
+                            from += 8;
+                        } while (out < mend);
+                        out = mend;
+                        continue;
+                    }
+#endif
                     do {                        /* minimum length is three */
                         *out++ = *from++;
                         *out++ = *from++;
@@ -298,9 +352,12 @@ unsigned start;         /* inflate()'s starting value for strm->avail_out */
     /* update state and return */
     strm->next_in = in;
     strm->next_out = out;
-    strm->avail_in = (unsigned)(in < last ? 5 + (last - in) : 5 - (in - last));
+    strm->avail_in = (unsigned)(in < last ?
+                                (INFLATE_FAST_MIN_INPUT - 1) + (last - in) :
+                                (INFLATE_FAST_MIN_INPUT - 1) - (in - last));
     strm->avail_out = (unsigned)(out < end ?
-                                 257 + (end - out) : 257 - (out - end));
+                                 (INFLATE_FAST_MIN_OUTPUT - 1) + (end - out) :
+                                 (INFLATE_FAST_MIN_OUTPUT - 1) - (out - end));
     state->hold = hold;
     state->bits = bits;
     return;
@@ -8,4 +8,19 @@
    subject to change. Applications should only use zlib.h.
  */
 
+/*
+ * EDIT (agent): 64-bit targets refill the bit buffer with unaligned 8-byte
+ *                 loads and copy matches in 8-byte words, which may read and
+ *                 write a few bytes past what is consumed or produced.
+ *                 Callers must provide extra input and output slack.
+ */
+#ifdef MDE_CPU_X64
+#  define INFLATE_FAST_WIDE
+#  define INFLATE_FAST_MIN_INPUT  8
+#  define INFLATE_FAST_MIN_OUTPUT 265
+#else
+#  define INFLATE_FAST_MIN_INPUT  6
+#  define INFLATE_FAST_MIN_OUTPUT 258
+#endif
+
 void ZLIB_INTERNAL inflate_fast OF((z_streamp strm, unsigned start));
@@ -84,3 +84,13 @@ Adler32 (
 {
   return adler32 (1, Buffer, BufferLen);
 }
+
+UINT32
+Adler32Update (
+  IN UINT32       Adler,
+  IN CONST UINT8  *Buffer,
+  IN UINT32       BufferLen
+  )
+{
+  return adler32 (Adler, Buffer, BufferLen);
+}
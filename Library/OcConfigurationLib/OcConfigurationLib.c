@@ -369,9 +369,11 @@ mKernelQuirksSchema[] = {
 STATIC
 OC_SCHEMA
 mKernelSchemeSchema[] = {
+  OC_SCHEMA_BOOLEAN_IN ("CachelessIndex",     OC_GLOBAL_CONFIG, Kernel.Scheme.CachelessIndex),
   OC_SCHEMA_BOOLEAN_IN ("FuzzyMatch",         OC_GLOBAL_CONFIG, Kernel.Scheme.FuzzyMatch),
   OC_SCHEMA_STRING_IN  ("KernelArch",         OC_GLOBAL_CONFIG, Kernel.Scheme.KernelArch),
   OC_SCHEMA_STRING_IN  ("KernelCache",        OC_GLOBAL_CONFIG, Kernel.Scheme.KernelCache),
+  OC_SCHEMA_BOOLEAN_IN ("PrelinkedCache",     OC_GLOBAL_CONFIG, Kernel.Scheme.PrelinkedCache),
 };
 
 STATIC
@@ -667,6 +669,7 @@ STATIC
 OC_SCHEMA
 mUefiQuirksSchema[] = {
   OC_SCHEMA_BOOLEAN_IN ("ActivateHpetSupport",    OC_GLOBAL_CONFIG, Uefi.Quirks.ActivateHpetSupport),
+  OC_SCHEMA_BOOLEAN_IN ("CacheTscFrequency",      OC_GLOBAL_CONFIG, Uefi.Quirks.CacheTscFrequency),
   OC_SCHEMA_BOOLEAN_IN ("DisableSecurityPolicy",  OC_GLOBAL_CONFIG, Uefi.Quirks.DisableSecurityPolicy),
   OC_SCHEMA_INTEGER_IN ("ExitBootServicesDelay",  OC_GLOBAL_CONFIG, Uefi.Quirks.ExitBootServicesDelay),
   OC_SCHEMA_BOOLEAN_IN ("IgnoreInvalidFlexRatio", OC_GLOBAL_CONFIG, Uefi.Quirks.IgnoreInvalidFlexRatio),
@@ -168,9 +168,23 @@ STATIC UINT32 mConsoleGopMode;
 STATIC UINT8  mFontScale;
 STATIC EFI_GRAPHICS_OUTPUT_BLT_PIXEL_UNION mBackgroundColor;
 STATIC EFI_GRAPHICS_OUTPUT_BLT_PIXEL_UNION mForegroundColor;
-STATIC EFI_GRAPHICS_OUTPUT_BLT_PIXEL_UNION *mCharacterBuffer;
+STATIC EFI_GRAPHICS_OUTPUT_BLT_PIXEL_UNION *mGlyphCache;
+STATIC EFI_GRAPHICS_OUTPUT_BLT_PIXEL_UNION *mLineBuffer;
+STATIC UINTN  mLineBufferStart;
+STATIC UINTN  mLineBufferLength;
 STATIC EFI_CONSOLE_CONTROL_SCREEN_MODE     mConsoleMode = EfiConsoleControlScreenText;
 
+///
+/// Glyph cache index 0 is reserved for the blank glyph.
+///
+#define GLYPH_BLANK_INDEX  0
+#define GLYPH_COUNT        (ISO_CHAR_MAX - ISO_CHAR_MIN + 2)
+
+///
+/// Glyphs rendered with current font scale and colours. Invalidated on colour change.
+///
+STATIC BOOLEAN mGlyphCacheValid[GLYPH_COUNT];
+
 #define SCR_PADD           1
 #define TGT_CHAR_WIDTH     ((UINTN)(ISO_CHAR_WIDTH) * mFontScale)
 #define TGT_CHAR_HEIGHT    ((UINTN)(ISO_CHAR_HEIGHT) * mFontScale)
@@ -183,37 +197,45 @@ STATIC EFI_CONSOLE_CONTROL_SCREEN_MODE     mConsoleMode = EfiConsoleControlScree
 #define TGT_CURSOR_HEIGHT  (mFontScale)
 
 /**
-  Render character onscreen.
+  Get glyph rendered with current font scale and colours.
 
   @param[in]  Char  Character code.
-  @param[in]  PosX  Character X position.
-  @param[in]  PosY  Character Y position.
+
+  @return  Glyph of TGT_CHAR_WIDTH x TGT_CHAR_HEIGHT pixels.
 **/
 STATIC
-VOID
-RenderChar (
-  IN CHAR16   Char,
-  IN UINTN    PosX,
-  IN UINTN    PosY
+EFI_GRAPHICS_OUTPUT_BLT_PIXEL_UNION *
+GetGlyph (
+  IN CHAR16   Char
   )
 {
   UINT32  *DstBuffer;
   UINT8   *SrcBuffer;
+  UINTN   GlyphIndex;
   UINT32  Line;
   UINT32  Index;
   UINT32  Index2;
   UINT8   Mask;
 
-  DstBuffer = &mCharacterBuffer[0].Raw;
-
   if ((Char >= 0 && Char < ISO_CHAR_MIN) || Char == ' ' || Char == CHAR_TAB || Char == 0x7F) {
-    SetMem32 (DstBuffer, TGT_CHAR_AREA * sizeof (DstBuffer[0]), mBackgroundColor.Raw);
+    GlyphIndex = GLYPH_BLANK_INDEX;
   } else {
-
     if (Char < 0 || Char > ISO_CHAR_MAX) {
       Char = L'_';
     }
 
+    GlyphIndex = Char - ISO_CHAR_MIN + 1;
+  }
+
+  DstBuffer = &mGlyphCache[GlyphIndex * TGT_CHAR_AREA].Raw;
+
+  if (mGlyphCacheValid[GlyphIndex]) {
+    return (EFI_GRAPHICS_OUTPUT_BLT_PIXEL_UNION *) DstBuffer;
+  }
+
+  if (GlyphIndex == GLYPH_BLANK_INDEX) {
+    SetMem32 (DstBuffer, TGT_CHAR_AREA * sizeof (DstBuffer[0]), mBackgroundColor.Raw);
+  } else {
     SrcBuffer = mIsoFontData + ((Char - ISO_CHAR_MIN) * (ISO_CHAR_HEIGHT - 2));
 
     SetMem32 (DstBuffer, TGT_CHAR_WIDTH * mFontScale * sizeof (DstBuffer[0]), mBackgroundColor.Raw);
@@ -239,9 +261,28 @@ RenderChar (
     SetMem32 (DstBuffer, TGT_CHAR_WIDTH * mFontScale * sizeof (DstBuffer[0]), mBackgroundColor.Raw);
   }
 
+  mGlyphCacheValid[GlyphIndex] = TRUE;
+  return &mGlyphCache[GlyphIndex * TGT_CHAR_AREA];
+}
+
+/**
+  Render character onscreen.
+
+  @param[in]  Char  Character code.
+  @param[in]  PosX  Character X position.
+  @param[in]  PosY  Character Y position.
+**/
+STATIC
+VOID
+RenderChar (
+  IN CHAR16   Char,
+  IN UINTN    PosX,
+  IN UINTN    PosY
+  )
+{
   mGraphicsOutput->Blt (
     mGraphicsOutput,
-    &mCharacterBuffer[0].Pixel,
+    &GetGlyph (Char)->Pixel,
     EfiBltBufferToVideo,
     0,
     0,
@@ -253,6 +294,71 @@ RenderChar (
     );
 }
 
+/**
+  Append character to the pending line segment.
+  Characters must be consecutive and on the same row till the next flush.
+
+  @param[in]  Char  Character code.
+  @param[in]  PosX  Character X position.
+**/
+STATIC
+VOID
+BufferChar (
+  IN CHAR16   Char,
+  IN UINTN    PosX
+  )
+{
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL_UNION  *Glyph;
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL_UNION  *DstBuffer;
+  UINTN                                Line;
+
+  if (mLineBufferLength == 0) {
+    mLineBufferStart = PosX;
+  }
+
+  Glyph     = GetGlyph (Char);
+  DstBuffer = &mLineBuffer[mLineBufferLength * TGT_CHAR_WIDTH];
+
+  for (Line = 0; Line < TGT_CHAR_HEIGHT; ++Line) {
+    CopyMem (DstBuffer, Glyph, TGT_CHAR_WIDTH * sizeof (DstBuffer[0]));
+    DstBuffer += mConsoleWidth * TGT_CHAR_WIDTH;
+    Glyph     += TGT_CHAR_WIDTH;
+  }
+
+  ++mLineBufferLength;
+}
+
+/**
+  Render pending line segment onscreen with a single blit.
+
+  @param[in]  PosY  Character Y position.
+**/
+STATIC
+VOID
+FlushLine (
+  IN UINTN    PosY
+  )
+{
+  if (mLineBufferLength == 0) {
+    return;
+  }
+
+  mGraphicsOutput->Blt (
+    mGraphicsOutput,
+    &mLineBuffer[0].Pixel,
+    EfiBltBufferToVideo,
+    0,
+    0,
+    TGT_PADD_WIDTH  + mLineBufferStart * TGT_CHAR_WIDTH,
+    TGT_PADD_HEIGHT + PosY * TGT_CHAR_HEIGHT,
+    mLineBufferLength * TGT_CHAR_WIDTH,
+    TGT_CHAR_HEIGHT,
+    mConsoleWidth * TGT_CHAR_WIDTH * sizeof (mLineBuffer[0])
+    );
+
+  mLineBufferLength = 0;
+}
+
 /**
   Swap cursor visibility onscreen.
 
@@ -370,18 +476,33 @@ RenderResync (
     return EFI_LOAD_ERROR;
   }
 
-  if (mCharacterBuffer != NULL) {
-    FreePool (mCharacterBuffer);
+  if (mGlyphCache != NULL) {
+    FreePool (mGlyphCache);
+  }
+
+  if (mLineBuffer != NULL) {
+    FreePool (mLineBuffer);
+    mLineBuffer = NULL;
   }
 
-  mCharacterBuffer = AllocatePool (TGT_CHAR_AREA * sizeof (mCharacterBuffer[0]));
-  if (mCharacterBuffer == NULL) {
+  ZeroMem (mGlyphCacheValid, sizeof (mGlyphCacheValid));
+  mGlyphCache = AllocatePool (GLYPH_COUNT * TGT_CHAR_AREA * sizeof (mGlyphCache[0]));
+  if (mGlyphCache == NULL) {
     return EFI_OUT_OF_RESOURCES;
   }
 
-  mConsoleGopMode          = mGraphicsOutput->Mode->Mode;
   mConsoleWidth            = (Info->HorizontalResolution / TGT_CHAR_WIDTH)  - 2 * SCR_PADD;
   mConsoleHeight           = (Info->VerticalResolution   / TGT_CHAR_HEIGHT) - 2 * SCR_PADD;
+
+  mLineBufferLength = 0;
+  mLineBuffer = AllocatePool (mConsoleWidth * TGT_CHAR_AREA * sizeof (mLineBuffer[0]));
+  if (mLineBuffer == NULL) {
+    FreePool (mGlyphCache);
+    mGlyphCache = NULL;
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  mConsoleGopMode          = mGraphicsOutput->Mode->Mode;
   mConsoleMaxPosX          = 0;
   mConsoleMaxPosY          = 0;
 
@@ -437,6 +558,7 @@ AsciiTextResetEx (
   This->Mode->Attribute    = ARRAY_SIZE (mGraphicsEfiColors) / 2 - 1;
   mBackgroundColor.Raw     = mGraphicsEfiColors[0];
   mForegroundColor.Raw     = mGraphicsEfiColors[ARRAY_SIZE (mGraphicsEfiColors) / 2 - 1];
+  ZeroMem (mGlyphCacheValid, sizeof (mGlyphCacheValid));
 
   Status = RenderResync (This);
   gBS->RestoreTPL (OldTpl);
@@ -507,6 +629,16 @@ AsciiTextOutputString (
   FlushCursor (This->Mode->CursorVisible, This->Mode->CursorColumn, This->Mode->CursorRow);
 
   for (Index = 0; String[Index] != '\0'; ++Index) {
+    //
+    // Printable characters are composed into a line segment, which is
+    // rendered once the cursor leaves the current row or jumps back.
+    //
+    if (String[Index] == CHAR_CARRIAGE_RETURN
+      || String[Index] == CHAR_BACKSPACE
+      || String[Index] == CHAR_LINEFEED) {
+      FlushLine (This->Mode->CursorRow);
+    }
+
     //
     // Carriage return should just move the cursor back.
     //
@@ -544,14 +676,19 @@ AsciiTextOutputString (
     //
     // Render normal symbol and decide on next cursor position.
     //
-    RenderChar (String[Index], This->Mode->CursorColumn, This->Mode->CursorRow);
+    BufferChar (String[Index], This->Mode->CursorColumn);
     if ((UINTN) This->Mode->CursorColumn < mConsoleWidth - 1) {
       //
       // Continues on the same line.
       //
       ++This->Mode->CursorColumn;
       mConsoleMaxPosX = MAX (mConsoleMaxPosX, (UINTN) This->Mode->CursorColumn);
-    } else if ((UINTN) This->Mode->CursorRow < mConsoleHeight - 1) {
+      continue;
+    }
+
+    FlushLine (This->Mode->CursorRow);
+
+    if ((UINTN) This->Mode->CursorRow < mConsoleHeight - 1) {
       //
       // New line without scroll.
       //
@@ -567,6 +704,7 @@ AsciiTextOutputString (
     }
   }
 
+  FlushLine (This->Mode->CursorRow);
   FlushCursor (This->Mode->CursorVisible, This->Mode->CursorColumn, This->Mode->CursorRow);
 
   mPrivateColumn = (UINTN) This->Mode->CursorColumn;
@@ -703,6 +841,7 @@ AsciiTextSetAttribute (
     mForegroundColor.Raw  = mGraphicsEfiColors[FgColor];
     mBackgroundColor.Raw  = mGraphicsEfiColors[BgColor];
     This->Mode->Attribute = (UINT32) Attribute;
+    ZeroMem (mGlyphCacheValid, sizeof (mGlyphCacheValid));
 
     FlushCursor (This->Mode->CursorVisible, mPrivateColumn, mPrivateRow);
   }
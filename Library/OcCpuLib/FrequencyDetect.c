@@ -33,6 +33,7 @@
 #include <Library/UefiRuntimeServicesTableLib.h>
 #include <IndustryStandard/ProcessorInfo.h>
 #include <Register/Msr.h>
+#include <Register/Intel/Msr/NehalemMsr.h>
 
 #include "OcCpuInternals.h"
 
@@ -121,6 +122,331 @@ InternalGetPmTimerAddr (
   return TimerAddr;
 }
 
+//
+// TSC frequency cache loaded from NVRAM, valid when mTscFrequencyCached is set.
+//
+STATIC OC_CPU_FREQUENCY_CACHE  mTscFrequencyCache;
+STATIC BOOLEAN                 mTscFrequencyCached;
+
+//
+// Set by OcCpuUpdateFrequencyCache when the cache is disabled in the
+// configuration. Consumers running before the configuration is read
+// still use the cache, which is removed for the next boot.
+//
+STATIC BOOLEAN                 mTscFrequencyCacheDisabled;
+
+//
+// TSC frequency obtained via ACPI PM timer in this module and the time
+// spent on its calibration in microseconds.
+//
+STATIC UINT64  mTscCalibratedFrequency;
+STATIC UINT32  mTscCalibrationTime;
+
+//
+// Background verification state for cached TSC frequency.
+//
+STATIC EFI_EVENT  mTscVerifyEvent;
+STATIC UINT16     mTscVerifyTimerAddr;
+STATIC UINT32     mTscVerifyAcpiTick;
+STATIC UINT64     mTscVerifyAcpiTicks;
+STATIC UINT64     mTscVerifyTsc;
+STATIC UINT32     mTscVerifySamples;
+
+/**
+  Obtain the key identifying current CPU configuration for TSC frequency cache.
+
+  @param[out] Cache  Cache structure with key fields filled in.
+**/
+STATIC
+VOID
+InternalGetFrequencyCacheKey (
+  OUT OC_CPU_FREQUENCY_CACHE  *Cache
+  )
+{
+  UINT32                  CpuVendor;
+  CPUID_VERSION_INFO_EAX  CpuidVerEax;
+  CPUID_VERSION_INFO_ECX  CpuidVerEcx;
+  UINT8                   Model;
+
+  ZeroMem (Cache, sizeof (*Cache));
+  Cache->Version = OC_CPU_FREQUENCY_CACHE_VERSION;
+
+  AsmCpuid (CPUID_SIGNATURE, NULL, &CpuVendor, NULL, NULL);
+  AsmCpuid (CPUID_VERSION_INFO, &CpuidVerEax.Uint32, NULL, &CpuidVerEcx.Uint32, NULL);
+
+  Cache->Signature = CpuidVerEax.Uint32;
+
+  //
+  // Microcode revision and ratio MSRs are not reliable under hypervisors.
+  //
+  if (CpuidVerEcx.Bits.NotUsed != 0) {
+    return;
+  }
+
+  //
+  // On AMD family 10h and newer use P-state 0 definition, which holds
+  // the frequency and divisor IDs of the highest performance state.
+  // Unlike the current P-state it does not change at runtime.
+  //
+  if (CpuVendor == CPUID_VENDOR_AMD) {
+    if (CpuidVerEax.Bits.FamilyId == AMD_CPU_FAMILY && CpuidVerEax.Bits.ExtendedFamilyId > 0) {
+      Cache->RatioMsr = AsmReadMsr64 (K10_PSTATE_STATUS);
+    }
+    return;
+  }
+
+  if (CpuVendor != CPUID_VENDOR_INTEL) {
+    return;
+  }
+
+  Cache->MicrocodeRevision = AsmReadIntelMicrocodeRevision ();
+
+  Model = (UINT8) CpuidVerEax.Bits.Model | (UINT8) (CpuidVerEax.Bits.ExtendedModelId << 4U);
+  if (CpuidVerEax.Bits.FamilyId == 6 && Model >= CPU_MODEL_NEHALEM) {
+    Cache->RatioMsr = AsmReadMsr64 (MSR_NEHALEM_PLATFORM_INFO);
+  }
+}
+
+/**
+  Load TSC frequency from NVRAM cache if it matches current CPU configuration.
+
+  @retval  Cached TSC frequency or 0.
+**/
+STATIC
+UINT64
+InternalLoadCachedTSCFrequency (
+  VOID
+  )
+{
+  OC_CPU_FREQUENCY_CACHE  Key;
+  UINTN                   VariableSize;
+  EFI_STATUS              Status;
+
+  if (mTscFrequencyCacheDisabled) {
+    return 0;
+  }
+
+  if (mTscFrequencyCached) {
+    return mTscFrequencyCache.TscFrequency;
+  }
+
+  VariableSize = sizeof (mTscFrequencyCache);
+  Status = gRT->GetVariable (
+    OC_CPU_FREQUENCY_CACHE_VARIABLE_NAME,
+    &gOcVendorVariableGuid,
+    NULL,
+    &VariableSize,
+    &mTscFrequencyCache
+    );
+  if (EFI_ERROR (Status) || VariableSize != sizeof (mTscFrequencyCache)) {
+    return 0;
+  }
+
+  InternalGetFrequencyCacheKey (&Key);
+
+  if (mTscFrequencyCache.Version != Key.Version
+    || mTscFrequencyCache.Signature != Key.Signature
+    || mTscFrequencyCache.MicrocodeRevision != Key.MicrocodeRevision
+    || mTscFrequencyCache.RatioMsr != Key.RatioMsr
+    || mTscFrequencyCache.TscFrequency == 0) {
+    DEBUG ((
+      DEBUG_INFO,
+      "OCCPU: Ignoring cached TSC frequency for %08X/%X/%016LX, current %08X/%X/%016LX\n",
+      mTscFrequencyCache.Signature,
+      mTscFrequencyCache.MicrocodeRevision,
+      mTscFrequencyCache.RatioMsr,
+      Key.Signature,
+      Key.MicrocodeRevision,
+      Key.RatioMsr
+      ));
+    return 0;
+  }
+
+  mTscFrequencyCached = TRUE;
+
+  DEBUG ((
+    DEBUG_INFO,
+    "OCCPU: Using cached TSC frequency %Lu Hz, saved %u us of calibration\n",
+    mTscFrequencyCache.TscFrequency,
+    mTscFrequencyCache.CalibrationTime
+    ));
+
+  return mTscFrequencyCache.TscFrequency;
+}
+
+/**
+  Store TSC frequency in NVRAM cache for current CPU configuration.
+
+  @param[in] TscFrequency     TSC frequency to store.
+  @param[in] CalibrationTime  Time spent on calibration in microseconds.
+
+  @retval EFI_SUCCESS on success.
+**/
+STATIC
+EFI_STATUS
+InternalStoreCachedTSCFrequency (
+  IN UINT64  TscFrequency,
+  IN UINT32  CalibrationTime
+  )
+{
+  OC_CPU_FREQUENCY_CACHE  Cache;
+
+  InternalGetFrequencyCacheKey (&Cache);
+  Cache.TscFrequency    = TscFrequency;
+  Cache.CalibrationTime = CalibrationTime;
+
+  return gRT->SetVariable (
+    OC_CPU_FREQUENCY_CACHE_VARIABLE_NAME,
+    &gOcVendorVariableGuid,
+    EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_BOOTSERVICE_ACCESS,
+    sizeof (Cache),
+    &Cache
+    );
+}
+
+/**
+  Sample ACPI PM timer and TSC together.
+
+  @param[out] AcpiTick  ACPI PM timer value.
+  @param[out] Tsc       TSC value.
+**/
+STATIC
+VOID
+InternalSampleTicks (
+  OUT UINT32  *AcpiTick,
+  OUT UINT64  *Tsc
+  )
+{
+  BOOLEAN  HasInterrupts;
+
+  HasInterrupts = SaveAndDisableInterrupts ();
+  *AcpiTick     = IoRead32 (mTscVerifyTimerAddr);
+  *Tsc          = AsmReadTsc ();
+  if (HasInterrupts) {
+    EnableInterrupts ();
+  }
+}
+
+/**
+  Accumulate ACPI PM timer and TSC ticks for cached TSC frequency verification,
+  and update the cache once enough time has passed.
+
+  @param[in] Event    Timer event.
+  @param[in] Context  Unused.
+**/
+STATIC
+VOID
+EFIAPI
+InternalVerifyCachedTSCFrequency (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  UINT32      AcpiTick;
+  UINT64      Tsc;
+  UINT64      TscFrequency;
+  UINT64      Difference;
+  EFI_STATUS  Status;
+
+  InternalSampleTicks (&AcpiTick, &Tsc);
+
+  //
+  // Sampling period is shorter than 24-bit timer overflow period, thus masking
+  // the difference handles overflow for both 24-bit and 32-bit timers.
+  //
+  mTscVerifyAcpiTicks += (AcpiTick - mTscVerifyAcpiTick) & 0x00FFFFFFU;
+  mTscVerifyAcpiTick   = AcpiTick;
+
+  ++mTscVerifySamples;
+  if (mTscVerifySamples < OC_CPU_FREQUENCY_VERIFY_SAMPLES) {
+    return;
+  }
+
+  gBS->CloseEvent (mTscVerifyEvent);
+  mTscVerifyEvent = NULL;
+
+  if (mTscVerifyAcpiTicks == 0 || mTscVerifyAcpiTicks > MAX_UINT32) {
+    DEBUG ((DEBUG_INFO, "OCCPU: Cannot verify cached TSC frequency, ACPI ticks %Lu\n", mTscVerifyAcpiTicks));
+    return;
+  }
+
+  TscFrequency = MultThenDivU64x64x32 (
+    Tsc - mTscVerifyTsc,
+    V_ACPI_TMR_FREQUENCY,
+    (UINT32) mTscVerifyAcpiTicks,
+    NULL
+    );
+
+  if (TscFrequency > mTscFrequencyCache.TscFrequency) {
+    Difference = TscFrequency - mTscFrequencyCache.TscFrequency;
+  } else {
+    Difference = mTscFrequencyCache.TscFrequency - TscFrequency;
+  }
+
+  if (Difference <= OC_CPU_FREQUENCY_CACHE_TOLERANCE) {
+    DEBUG ((
+      DEBUG_INFO,
+      "OCCPU: Verified cached TSC frequency %Lu Hz against %Lu Hz\n",
+      mTscFrequencyCache.TscFrequency,
+      TscFrequency
+      ));
+    return;
+  }
+
+  Status = InternalStoreCachedTSCFrequency (TscFrequency, mTscFrequencyCache.CalibrationTime);
+
+  DEBUG ((
+    DEBUG_INFO,
+    "OCCPU: Cached TSC frequency %Lu Hz is off from %Lu Hz, updating for next boot - %r\n",
+    mTscFrequencyCache.TscFrequency,
+    TscFrequency,
+    Status
+    ));
+}
+
+/**
+  Start background verification of cached TSC frequency.
+**/
+STATIC
+VOID
+InternalStartCachedTSCFrequencyVerification (
+  VOID
+  )
+{
+  EFI_STATUS  Status;
+
+  if (mTscVerifyEvent != NULL) {
+    return;
+  }
+
+  mTscVerifyTimerAddr = (UINT16) InternalGetPmTimerAddr (NULL);
+  if (mTscVerifyTimerAddr == 0) {
+    return;
+  }
+
+  Status = gBS->CreateEvent (
+    EVT_TIMER | EVT_NOTIFY_SIGNAL,
+    TPL_CALLBACK,
+    InternalVerifyCachedTSCFrequency,
+    NULL,
+    &mTscVerifyEvent
+    );
+  if (EFI_ERROR (Status)) {
+    mTscVerifyEvent = NULL;
+    return;
+  }
+
+  mTscVerifyAcpiTicks = 0;
+  mTscVerifySamples   = 0;
+  InternalSampleTicks (&mTscVerifyAcpiTick, &mTscVerifyTsc);
+
+  Status = gBS->SetTimer (mTscVerifyEvent, TimerPeriodic, OC_CPU_FREQUENCY_VERIFY_PERIOD);
+  if (EFI_ERROR (Status)) {
+    gBS->CloseEvent (mTscVerifyEvent);
+    mTscVerifyEvent = NULL;
+  }
+}
+
 UINT64
 InternalCalculateTSCFromPMTimer (
   IN BOOLEAN  Recalculate
@@ -136,6 +462,7 @@ InternalCalculateTSCFromPMTimer (
   UINT16      TimerAddr;
   UINTN       VariableSize;
   UINT64      TscTicksDelta;
+  UINT64      TscStart;
   UINT32      AcpiTick0;
   UINT32      AcpiTick1;
   UINT32      AcpiTicksDelta;
@@ -172,12 +499,21 @@ InternalCalculateTSCFromPMTimer (
   }
 
   if (TSCFrequency == 0) {
-    TimerAddr       = (UINT16) InternalGetPmTimerAddr (NULL);
+    //
+    // Frequency persisted from previous boots takes precedence even when
+    // recalculating, as avoiding the calibration is its whole purpose.
+    //
+    TSCFrequency = InternalLoadCachedTSCFrequency ();
+    TimerAddr    = 0;
+    if (TSCFrequency == 0) {
+      TimerAddr = (UINT16) InternalGetPmTimerAddr (NULL);
+    }
 
     if (TimerAddr != 0) {
       //
       // Check that timer is advancing (it does not on some virtual machines).
       //
+      TscStart  = AsmReadTsc ();
       AcpiTick0 = IoRead32 (TimerAddr);
       gBS->Stall (500);
       AcpiTick1 = IoRead32 (TimerAddr);
@@ -207,6 +543,14 @@ InternalCalculateTSCFromPMTimer (
         TSCFrequency = DivU64x32 (
           MultU64x32 (TscTicksDelta, V_ACPI_TMR_FREQUENCY), AcpiTicksDelta
           );
+
+        if (TSCFrequency != 0) {
+          mTscCalibrationTime = (UINT32) DivU64x64Remainder (
+            MultU64x32 (AsmReadTsc () - TscStart, 1000000),
+            TSCFrequency,
+            NULL
+            );
+        }
       }
     }
 
@@ -226,9 +570,76 @@ InternalCalculateTSCFromPMTimer (
     }
   }
 
+  mTscCalibratedFrequency = TSCFrequency;
+
   return TSCFrequency;
 }
 
+VOID
+OcCpuUpdateFrequencyCache (
+  IN BOOLEAN  Enable
+  )
+{
+  EFI_STATUS  Status;
+  UINT32      CalibrationTime;
+
+  if ((AsmReadCs () & 3U) == 3) {
+    return;
+  }
+
+  if (!Enable) {
+    //
+    // Values already handed out on this boot cannot be taken back,
+    // but later calibrations in this module must not use the cache.
+    //
+    mTscFrequencyCacheDisabled = TRUE;
+    mTscFrequencyCached        = FALSE;
+
+    Status = gRT->SetVariable (
+      OC_CPU_FREQUENCY_CACHE_VARIABLE_NAME,
+      &gOcVendorVariableGuid,
+      EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_BOOTSERVICE_ACCESS,
+      0,
+      NULL
+      );
+    if (!EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_INFO, "OCCPU: Discarded cached TSC frequency\n"));
+    }
+    return;
+  }
+
+  if (mTscFrequencyCached) {
+    InternalStartCachedTSCFrequencyVerification ();
+    return;
+  }
+
+  //
+  // Nothing to cache when ACPI PM timer was not needed for this CPU.
+  //
+  if (mTscCalibratedFrequency == 0) {
+    return;
+  }
+
+  //
+  // Frequency may have been calibrated by another module and shared via
+  // volatile variable, assume full calibration time in this case.
+  //
+  CalibrationTime = mTscCalibrationTime;
+  if (CalibrationTime == 0) {
+    CalibrationTime = OC_CPU_FREQUENCY_CALIBRATION_TIME;
+  }
+
+  Status = InternalStoreCachedTSCFrequency (mTscCalibratedFrequency, CalibrationTime);
+
+  DEBUG ((
+    DEBUG_INFO,
+    "OCCPU: Cached TSC frequency %Lu Hz, calibration took %u us - %r\n",
+    mTscCalibratedFrequency,
+    CalibrationTime,
+    Status
+    ));
+}
+
 STATIC
 UINT64
 InternalSelectAppleFsbFrequency (
@@ -23,6 +23,45 @@
 //
 #define OC_CPU_FREQUENCY_TOLERANCE 50000000LL // 50 Mhz
 
+//
+// Tolerance within which cached TSC frequency is considered valid
+// after background verification.
+//
+#define OC_CPU_FREQUENCY_CACHE_TOLERANCE 1000000LL // 1 Mhz
+
+//
+// Cached TSC frequency structure version.
+//
+#define OC_CPU_FREQUENCY_CACHE_VERSION 2
+
+//
+// Background verification of cached TSC frequency samples ACPI PM timer
+// every 500 ms (well below 24-bit timer overflow period of ~4.6 s) for 2 s.
+//
+#define OC_CPU_FREQUENCY_VERIFY_PERIOD   5000000ULL
+#define OC_CPU_FREQUENCY_VERIFY_SAMPLES  4
+
+//
+// Nominal ACPI PM timer calibration time in microseconds:
+// 500 us timer advance check and 100 ms measurement.
+//
+#define OC_CPU_FREQUENCY_CALIBRATION_TIME  100500U
+
+/**
+  TSC frequency calibrated via ACPI PM timer persisted in NVRAM.
+  Signature, MicrocodeRevision, and RatioMsr form the key identifying
+  the CPU configuration the frequency was measured on. RatioMsr holds
+  MSR_PLATFORM_INFO on Intel and P-state 0 definition on AMD.
+**/
+typedef struct {
+  UINT32  Version;
+  UINT32  Signature;
+  UINT32  MicrocodeRevision;
+  UINT32  CalibrationTime;
+  UINT64  RatioMsr;
+  UINT64  TscFrequency;
+} OC_CPU_FREQUENCY_CACHE;
+
 /**
   Internal CPU synchronisation structure.
 **/
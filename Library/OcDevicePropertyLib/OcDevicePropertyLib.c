@@ -43,12 +43,20 @@
     DEVICE_PATH_PROPERTY_DATA_SIGNATURE       \
     )
 
+//
+// Number of device path hash buckets, device property count is normally small.
+//
+#define DEVICE_PATH_PROPERTY_NODE_BUCKETS  64
+
 // DEVICE_PATH_PROPERTY_DATABASE
 typedef struct {
   UINTN                                      Signature;
   LIST_ENTRY                                 Nodes;
   EFI_DEVICE_PATH_PROPERTY_DATABASE_PROTOCOL Protocol;
   BOOLEAN                                    Modified;
+  LIST_ENTRY                                 NodeBuckets[DEVICE_PATH_PROPERTY_NODE_BUCKETS];
+  EFI_DEVICE_PATH_PROPERTY_BUFFER            *Buffer;
+  UINTN                                      BufferSize;
 } DEVICE_PATH_PROPERTY_DATA;
 
 #define APPLE_PATH_PROPERTIES_VARIABLE_NAME    L"AAPL,PathProperties"
@@ -68,8 +76,18 @@ typedef struct {
       )                                        \
     ))
 
+#define PROPERTY_NODE_FROM_HASH_LINK(Entry)    \
+  ((EFI_DEVICE_PATH_PROPERTY_NODE *)(          \
+    CR (                                       \
+      Entry,                                   \
+      EFI_DEVICE_PATH_PROPERTY_NODE_HDR,       \
+      HashLink,                                \
+      EFI_DEVICE_PATH_PROPERTY_NODE_SIGNATURE  \
+      )                                        \
+    ))
+
 #define EFI_DEVICE_PATH_PROPERTY_NODE_SIZE(Node)  \
-  (sizeof (EFI_DEVICE_PATH_PROPERTY_BUFFER_NODE_HDR) + GetDevicePathSize (&(Node)->DevicePath))
+  (sizeof (EFI_DEVICE_PATH_PROPERTY_BUFFER_NODE_HDR) + (Node)->Hdr.DevicePathSize)
 
 // EFI_DEVICE_PATH_PROPERTY_NODE_HDR
 typedef struct {
@@ -77,6 +95,9 @@ typedef struct {
   LIST_ENTRY Link;                ///<
   UINTN      NumberOfProperties;  ///<
   LIST_ENTRY Properties;          ///<
+  LIST_ENTRY HashLink;            ///<
+  UINT32     Hash;                ///<
+  UINTN      DevicePathSize;      ///<
 } EFI_DEVICE_PATH_PROPERTY_NODE_HDR;
 
 // DEVICE_PATH_PROPERTY_NODE
@@ -115,6 +136,7 @@ typedef struct {
   LIST_ENTRY                    Link;       ///<
   EFI_DEVICE_PATH_PROPERTY_DATA *Name;      ///<
   EFI_DEVICE_PATH_PROPERTY_DATA *Value;     ///<
+  UINT32                        NameHash;   ///<
 } EFI_DEVICE_PATH_PROPERTY;
 
 // TODO: Move to own header
@@ -129,30 +151,102 @@ typedef struct {
 
 EFI_GUID mAppleThunderboltNativeHostInterfaceProtocolGuid = APPLE_THUNDERBOLT_NATIVE_HOST_INTERFACE_PROTOCOL_GUID;
 
+// InternalHashData
+STATIC
+UINT32
+InternalHashData (
+  IN CONST VOID  *Data,
+  IN UINTN       Size
+  )
+{
+  CONST UINT8  *Bytes;
+  UINT32       Hash;
+
+  //
+  // FNV-1a, good enough for device paths and property names.
+  //
+  Bytes = Data;
+  Hash  = 2166136261U;
+  while (Size > 0) {
+    Hash = (Hash ^ *Bytes) * 16777619U;
+    ++Bytes;
+    --Size;
+  }
+
+  return Hash;
+}
+
+// InternalHashName
+STATIC
+UINT32
+InternalHashName (
+  IN CONST CHAR16  *Name
+  )
+{
+  UINT32  Hash;
+
+  Hash = 2166136261U;
+  while (*Name != L'\0') {
+    Hash = (Hash ^ (UINT16) *Name) * 16777619U;
+    ++Name;
+  }
+
+  return Hash;
+}
+
+// InternalInvalidatePropertyBuffer
+STATIC
+VOID
+InternalInvalidatePropertyBuffer (
+  IN DEVICE_PATH_PROPERTY_DATA  *DevicePathPropertyData
+  )
+{
+  if (DevicePathPropertyData->Buffer != NULL) {
+    FreePool (DevicePathPropertyData->Buffer);
+    DevicePathPropertyData->Buffer     = NULL;
+    DevicePathPropertyData->BufferSize = 0;
+  }
+}
+
 // InternalGetPropertyNode
 STATIC
 EFI_DEVICE_PATH_PROPERTY_NODE *
 InternalGetPropertyNode (
-  IN DEVICE_PATH_PROPERTY_DATA  *DevicePathPropertyData,
-  IN EFI_DEVICE_PATH_PROTOCOL   *DevicePath
+  IN  DEVICE_PATH_PROPERTY_DATA  *DevicePathPropertyData,
+  IN  EFI_DEVICE_PATH_PROTOCOL   *DevicePath,
+  OUT UINT32                     *Hash OPTIONAL,
+  OUT UINTN                      *Size OPTIONAL
   )
 {
-  LIST_ENTRY  *Node;
-  UINTN       DevicePathSize;
-  UINTN       DevicePathSize2;
+  LIST_ENTRY                     *Bucket;
+  LIST_ENTRY                     *Link;
+  EFI_DEVICE_PATH_PROPERTY_NODE  *Node;
+  UINTN                          DevicePathSize;
+  UINT32                         DevicePathHash;
 
-  Node = GetFirstNode (&DevicePathPropertyData->Nodes);
   DevicePathSize = GetDevicePathSize (DevicePath);
+  DevicePathHash = InternalHashData (DevicePath, DevicePathSize);
+
+  if (Hash != NULL) {
+    *Hash = DevicePathHash;
+  }
+  if (Size != NULL) {
+    *Size = DevicePathSize;
+  }
+
+  Bucket = &DevicePathPropertyData->NodeBuckets[DevicePathHash % DEVICE_PATH_PROPERTY_NODE_BUCKETS];
+  Link   = GetFirstNode (Bucket);
 
-  while (!IsNull (&DevicePathPropertyData->Nodes, Node)) {
-    DevicePathSize2 = GetDevicePathSize (&PROPERTY_NODE_FROM_LIST_ENTRY (Node)->DevicePath);
+  while (!IsNull (Bucket, Link)) {
+    Node = PROPERTY_NODE_FROM_HASH_LINK (Link);
 
-    if (DevicePathSize == DevicePathSize2
-      && CompareMem (DevicePath, &PROPERTY_NODE_FROM_LIST_ENTRY (Node)->DevicePath, DevicePathSize) == 0) {
-      return PROPERTY_NODE_FROM_LIST_ENTRY (Node);
+    if (Node->Hdr.Hash == DevicePathHash
+      && Node->Hdr.DevicePathSize == DevicePathSize
+      && CompareMem (DevicePath, &Node->DevicePath, DevicePathSize) == 0) {
+      return Node;
     }
 
-    Node = GetNextNode (&DevicePathPropertyData->Nodes, Node);
+    Link = GetNextNode (Bucket, Link);
   }
 
   return NULL;
@@ -162,21 +256,31 @@ InternalGetPropertyNode (
 STATIC
 EFI_DEVICE_PATH_PROPERTY *
 InternalGetProperty (
-  IN EFI_DEVICE_PATH_PROPERTY_NODE  *Node,
-  IN CONST CHAR16                   *Name
+  IN  EFI_DEVICE_PATH_PROPERTY_NODE  *Node,
+  IN  CONST CHAR16                   *Name,
+  OUT UINT32                         *Hash OPTIONAL
   )
 {
-  LIST_ENTRY  *Property;
+  LIST_ENTRY                *Link;
+  EFI_DEVICE_PATH_PROPERTY  *Property;
+  UINT32                    NameHash;
+
+  NameHash = InternalHashName (Name);
+  if (Hash != NULL) {
+    *Hash = NameHash;
+  }
 
+  Link = GetFirstNode (&Node->Hdr.Properties);
 
-  Property = GetFirstNode (&Node->Hdr.Properties);
+  while (!IsNull (&Node->Hdr.Properties, Link)) {
+    Property = EFI_DEVICE_PATH_PROPERTY_FROM_LIST_ENTRY (Link);
 
-  while (!IsNull (&Node->Hdr.Properties, Property)) {
-    if (StrCmp (Name, (CONST CHAR16 *) &EFI_DEVICE_PATH_PROPERTY_FROM_LIST_ENTRY (Property)->Name->Data[0]) == 0) {
-      return EFI_DEVICE_PATH_PROPERTY_FROM_LIST_ENTRY (Property);
+    if (Property->NameHash == NameHash
+      && StrCmp (Name, (CONST CHAR16 *) &Property->Name->Data[0]) == 0) {
+      return Property;
     }
 
-    Property = GetNextNode (&Node->Hdr.Properties, Property);
+    Link = GetNextNode (&Node->Hdr.Properties, Link);
   }
 
   return NULL;
@@ -262,12 +366,12 @@ DppDbGetProperty (
   BOOLEAN                           BufferTooSmall;
 
   Database = PROPERTY_DATABASE_FROM_PROTOCOL (This);
-  Node     = InternalGetPropertyNode (Database, DevicePath);
+  Node     = InternalGetPropertyNode (Database, DevicePath, NULL, NULL);
   if (Node == NULL) {
     return EFI_NOT_FOUND;
   }
 
-  Property = InternalGetProperty (Node, Name);
+  Property = InternalGetProperty (Node, Name, NULL);
   if (Property == NULL) {
     return EFI_NOT_FOUND;
   }
@@ -312,24 +416,27 @@ DppDbSetProperty (
   DEVICE_PATH_PROPERTY_DATA     *Database;
   EFI_DEVICE_PATH_PROPERTY_NODE *Node;
   UINTN                         DevicePathSize;
+  UINT32                        DevicePathHash;
   EFI_DEVICE_PATH_PROPERTY      *Property;
+  UINT32                        PropertyNameHash;
   UINTN                         PropertyNameSize;
   UINTN                         PropertyValueSize;
   EFI_DEVICE_PATH_PROPERTY_DATA *PropertyName;
   EFI_DEVICE_PATH_PROPERTY_DATA *PropertyValue;
 
   Database = PROPERTY_DATABASE_FROM_PROTOCOL (This);
-  Node     = InternalGetPropertyNode (Database, DevicePath);
+  Node     = InternalGetPropertyNode (Database, DevicePath, &DevicePathHash, &DevicePathSize);
 
   if (Node == NULL) {
-    DevicePathSize = GetDevicePathSize (DevicePath);
-    Node           = AllocateZeroPool (sizeof (*Node) + DevicePathSize);
+    Node = AllocateZeroPool (sizeof (*Node) + DevicePathSize);
 
     if (Node == NULL) {
       return EFI_OUT_OF_RESOURCES;
     }
 
-    Node->Hdr.Signature = EFI_DEVICE_PATH_PROPERTY_NODE_SIGNATURE;
+    Node->Hdr.Signature      = EFI_DEVICE_PATH_PROPERTY_NODE_SIGNATURE;
+    Node->Hdr.Hash           = DevicePathHash;
+    Node->Hdr.DevicePathSize = DevicePathSize;
 
     InitializeListHead (&Node->Hdr.Properties);
 
@@ -340,11 +447,16 @@ DppDbSetProperty (
       );
 
     InsertTailList (&Database->Nodes, &Node->Hdr.Link);
+    InsertTailList (
+      &Database->NodeBuckets[DevicePathHash % DEVICE_PATH_PROPERTY_NODE_BUCKETS],
+      &Node->Hdr.HashLink
+      );
 
     Database->Modified = TRUE;
+    InternalInvalidatePropertyBuffer (Database);
   }
 
-  Property = InternalGetProperty (Node, Name);
+  Property = InternalGetProperty (Node, Name, &PropertyNameHash);
 
   if (Property != NULL) {
     if (Property->Value->Size == Size + sizeof (UINT32)
@@ -362,6 +474,7 @@ DppDbSetProperty (
   }
 
   Database->Modified = TRUE;
+  InternalInvalidatePropertyBuffer (Database);
   Property           = AllocateZeroPool (sizeof (*Property));
   
   if (Property == NULL) {
@@ -387,6 +500,7 @@ DppDbSetProperty (
   }
   
   Property->Signature = EFI_DEVICE_PATH_PROPERTY_SIGNATURE;
+  Property->NameHash  = PropertyNameHash;
 
   CopyMem (&Property->Name->Data[0], Name, PropertyNameSize - sizeof (*PropertyName));
   Property->Name->Size = (UINT32) PropertyNameSize;
@@ -426,17 +540,18 @@ DppDbRemoveProperty (
   EFI_DEVICE_PATH_PROPERTY      *Property;
 
   DevicePathPropertyData = PROPERTY_DATABASE_FROM_PROTOCOL (This);
-  Node = InternalGetPropertyNode (DevicePathPropertyData, DevicePath);
+  Node = InternalGetPropertyNode (DevicePathPropertyData, DevicePath, NULL, NULL);
   if (Node == NULL) {
     return EFI_NOT_FOUND;
   }
 
-  Property = InternalGetProperty (Node, Name);
+  Property = InternalGetProperty (Node, Name, NULL);
   if (Property == NULL) {
     return EFI_NOT_FOUND;
   }
 
   DevicePathPropertyData->Modified = TRUE;
+  InternalInvalidatePropertyBuffer (DevicePathPropertyData);
 
   RemoveEntryList (&Property->Link);
 
@@ -448,6 +563,7 @@ DppDbRemoveProperty (
 
   if (Node->Hdr.NumberOfProperties == 0) {
     RemoveEntryList (&Node->Hdr.Link);
+    RemoveEntryList (&Node->Hdr.HashLink);
 
     FreePool (Node);
   }
@@ -455,53 +571,21 @@ DppDbRemoveProperty (
   return EFI_SUCCESS;
 }
 
-// DppDbGetPropertyBuffer
-/** Returns a Buffer of all device properties into Buffer.
-
-  @param[in]      This    A pointer to the protocol instance.
-  @param[out]     Buffer  The Buffer allocated by the caller to return the
-                          property Buffer into.
-  @param[in,out]  Size    On input the size of the allocated Buffer.
-                          On output the size required to fill the Buffer.
-
-  @return                       The status of the operation is returned.
-  @retval EFI_BUFFER_TOO_SMALL  The memory required to return the value exceeds
-                                the size of the allocated Buffer.
-                                The required size to complete the operation has
-                                been returned into Size.
-  @retval EFI_SUCCESS           The operation completed successfully.
-**/
-EFI_STATUS
-EFIAPI
-DppDbGetPropertyBuffer (
-  IN     EFI_DEVICE_PATH_PROPERTY_DATABASE_PROTOCOL  *This,
-  OUT    EFI_DEVICE_PATH_PROPERTY_BUFFER             *Buffer OPTIONAL,
-  IN OUT UINTN                                       *Size
+// InternalGetPropertyBufferSize
+STATIC
+UINTN
+InternalGetPropertyBufferSize (
+  IN  LIST_ENTRY  *Nodes,
+  OUT UINT32      *NumberOfNodes
   )
 {
-  LIST_ENTRY                           *Nodes;
-  LIST_ENTRY                           *NodeWalker;
-  UINTN                                BufferSize;
-  LIST_ENTRY                           *Property;
-  UINT32                               NumberOfNodes;
-  EFI_DEVICE_PATH_PROPERTY_BUFFER_NODE *BufferNode;
-  UINT8                                *BufferPtr;
-  BOOLEAN                              BufferTooSmall;
-
-  Nodes  = &(PROPERTY_DATABASE_FROM_PROTOCOL (This))->Nodes;
-
-  if (IsListEmpty (Nodes)) {
-    *Size  = 0;
-    return EFI_SUCCESS;
-  }
-
-  if (PcdGetBool (PcdEnableAppleThunderboltSync)) {
-    InternalSyncWithThunderboltDevices ();
-  }
+  LIST_ENTRY  *NodeWalker;
+  LIST_ENTRY  *Property;
+  UINTN       BufferSize;
 
-  NodeWalker    = GetFirstNode (Nodes);
-  BufferSize    = sizeof (*Buffer);
-  NumberOfNodes = 0;
+  NodeWalker     = GetFirstNode (Nodes);
+  BufferSize     = sizeof (EFI_DEVICE_PATH_PROPERTY_BUFFER);
+  *NumberOfNodes = 0;
 
   while (!IsNull (Nodes, NodeWalker)) {
     Property = GetFirstNode (&PROPERTY_NODE_FROM_LIST_ENTRY (NodeWalker)->Hdr.Properties);
@@ -515,16 +599,26 @@ DppDbGetPropertyBuffer (
 
     NodeWalker = GetNextNode (Nodes, NodeWalker);
 
-    ++NumberOfNodes;
+    ++*NumberOfNodes;
   }
 
-  DEBUG ((DEBUG_VERBOSE, "Saving to %p, given %u, requested %u\n", Buffer, (UINT32) *Size, (UINT32) BufferSize));
+  return BufferSize;
+}
 
-  BufferTooSmall = *Size < BufferSize;
-  *Size  = BufferSize;
-  if (BufferTooSmall) {
-    return EFI_BUFFER_TOO_SMALL;
-  }
+// InternalSerializePropertyBuffer
+STATIC
+VOID
+InternalSerializePropertyBuffer (
+  IN  LIST_ENTRY                       *Nodes,
+  IN  UINTN                            BufferSize,
+  IN  UINT32                           NumberOfNodes,
+  OUT EFI_DEVICE_PATH_PROPERTY_BUFFER  *Buffer
+  )
+{
+  LIST_ENTRY                           *NodeWalker;
+  LIST_ENTRY                           *Property;
+  EFI_DEVICE_PATH_PROPERTY_BUFFER_NODE *BufferNode;
+  UINT8                                *BufferPtr;
 
   Buffer->Size          = (UINT32) BufferSize;
   Buffer->Version       = EFI_DEVICE_PATH_PROPERTY_DATABASE_VERSION;
@@ -535,7 +629,7 @@ DppDbGetPropertyBuffer (
   BufferNode = &Buffer->Nodes[0];
 
   while (!IsNull (Nodes, NodeWalker)) {
-    BufferSize = GetDevicePathSize (&PROPERTY_NODE_FROM_LIST_ENTRY (NodeWalker)->DevicePath);
+    BufferSize = PROPERTY_NODE_FROM_LIST_ENTRY (NodeWalker)->Hdr.DevicePathSize;
 
     CopyMem (
       &BufferNode->DevicePath,
@@ -578,6 +672,85 @@ DppDbGetPropertyBuffer (
 
     NodeWalker = GetNextNode (Nodes, NodeWalker);
   }
+}
+
+// DppDbGetPropertyBuffer
+/** Returns a Buffer of all device properties into Buffer.
+
+  @param[in]      This    A pointer to the protocol instance.
+  @param[out]     Buffer  The Buffer allocated by the caller to return the
+                          property Buffer into.
+  @param[in,out]  Size    On input the size of the allocated Buffer.
+                          On output the size required to fill the Buffer.
+
+  @return                       The status of the operation is returned.
+  @retval EFI_BUFFER_TOO_SMALL  The memory required to return the value exceeds
+                                the size of the allocated Buffer.
+                                The required size to complete the operation has
+                                been returned into Size.
+  @retval EFI_SUCCESS           The operation completed successfully.
+**/
+EFI_STATUS
+EFIAPI
+DppDbGetPropertyBuffer (
+  IN     EFI_DEVICE_PATH_PROPERTY_DATABASE_PROTOCOL  *This,
+  OUT    EFI_DEVICE_PATH_PROPERTY_BUFFER             *Buffer OPTIONAL,
+  IN OUT UINTN                                       *Size
+  )
+{
+  DEVICE_PATH_PROPERTY_DATA            *Database;
+  LIST_ENTRY                           *Nodes;
+  UINTN                                BufferSize;
+  UINT32                               NumberOfNodes;
+  BOOLEAN                              BufferTooSmall;
+
+  Database      = PROPERTY_DATABASE_FROM_PROTOCOL (This);
+  Nodes         = &Database->Nodes;
+  NumberOfNodes = 0;
+
+  if (IsListEmpty (Nodes)) {
+    *Size  = 0;
+    return EFI_SUCCESS;
+  }
+
+  //
+  // Thunderbolt drivers may update the properties, so sync before using the cache.
+  //
+  if (PcdGetBool (PcdEnableAppleThunderboltSync)) {
+    InternalSyncWithThunderboltDevices ();
+  }
+
+  //
+  // boot.efi requests the buffer multiple times, serialize it only once
+  // after every modification. Setting or removing properties invalidates it.
+  //
+  if (Database->Buffer == NULL) {
+    BufferSize = InternalGetPropertyBufferSize (Nodes, &NumberOfNodes);
+    Database->Buffer = AllocatePool (BufferSize);
+    if (Database->Buffer != NULL) {
+      InternalSerializePropertyBuffer (Nodes, BufferSize, NumberOfNodes, Database->Buffer);
+      Database->BufferSize = BufferSize;
+    }
+  } else {
+    BufferSize = Database->BufferSize;
+  }
+
+  DEBUG ((DEBUG_VERBOSE, "Saving to %p, given %u, requested %u\n", Buffer, (UINT32) *Size, (UINT32) BufferSize));
+
+  BufferTooSmall = *Size < BufferSize;
+  *Size  = BufferSize;
+  if (BufferTooSmall) {
+    return EFI_BUFFER_TOO_SMALL;
+  }
+
+  //
+  // Serialize directly if we could not allocate the cache.
+  //
+  if (Database->Buffer != NULL) {
+    CopyMem (Buffer, Database->Buffer, BufferSize);
+  } else {
+    InternalSerializePropertyBuffer (Nodes, BufferSize, NumberOfNodes, Buffer);
+  }
 
   return EFI_SUCCESS;
 }
@@ -789,6 +962,7 @@ OcDevicePathPropertyInstallProtocol (
   DEVICE_PATH_PROPERTY_DATA                   *DevicePathPropertyData;
   UINTN                                       DataSize;
   UINT32                                      VariableIndex;
+  UINTN                                       Index;
   CHAR16                                      IndexBuffer[5];
   CHAR16                                      VariableName[64];
   UINTN                                       VariableSize;
@@ -827,6 +1001,9 @@ OcDevicePathPropertyInstallProtocol (
     );
 
   InitializeListHead (&DevicePathPropertyData->Nodes);
+  for (Index = 0; Index < DEVICE_PATH_PROPERTY_NODE_BUCKETS; ++Index) {
+    InitializeListHead (&DevicePathPropertyData->NodeBuckets[Index]);
+  }
 
   if (PcdGetBool (PcNvramInitDevicePropertyDatabase)) {
     Status = InternalReadEfiVariableProperties (
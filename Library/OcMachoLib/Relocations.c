@@ -16,11 +16,19 @@ WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
 
 #include <IndustryStandard/AppleMachoImage.h>
 
+#include <Library/BaseMemoryLib.h>
 #include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/OcGuardLib.h>
 #include <Library/OcMachoLib.h>
 
 #include "OcMachoLibInternal.h"
 
+///
+/// Minimum amount of relocations to build a lookup index for.
+///
+#define MACHO_RELOCATION_INDEX_THRESHOLD  32U
+
 /**
   Returns whether the Relocation's type indicates a Pair for the Intel 32
   platform.
@@ -194,6 +202,308 @@ InternalLookupSectionRelocationByOffset (
   return NULL;
 }
 
+/**
+  Compares two relocation index entries by their target address.  Entries
+  targeting the same address are ordered by their position in the relocation
+  tables, so that lookups return the same Relocation as a linear scan.
+
+  @param[in] Entry1  The first entry to compare.
+  @param[in] Entry2  The second entry to compare.
+
+  @returns  Whether Entry1 is ordered before Entry2.
+
+**/
+STATIC
+BOOLEAN
+InternalRelocationIndexEntryLess (
+  IN CONST OC_MACHO_RELOCATION_INDEX_ENTRY  *Entry1,
+  IN CONST OC_MACHO_RELOCATION_INDEX_ENTRY  *Entry2
+  )
+{
+  if (Entry1->Address != Entry2->Address) {
+    return Entry1->Address < Entry2->Address;
+  }
+
+  return Entry1->Sequence < Entry2->Sequence;
+}
+
+/**
+  Restores the max-heap property for the subtree rooted at Root.
+
+  @param[in,out] Entries     The entries to operate on.
+  @param[in]     Root        The root of the subtree.
+  @param[in]     NumEntries  The number of entries in the heap.
+
+**/
+STATIC
+VOID
+InternalRelocationIndexSiftDown (
+  IN OUT OC_MACHO_RELOCATION_INDEX_ENTRY  *Entries,
+  IN     UINT32                           Root,
+  IN     UINT32                           NumEntries
+  )
+{
+  OC_MACHO_RELOCATION_INDEX_ENTRY  Temp;
+  UINT32                           Child;
+
+  while (Root < NumEntries / 2) {
+    Child = 2 * Root + 1;
+    if (Child + 1 < NumEntries
+     && InternalRelocationIndexEntryLess (&Entries[Child], &Entries[Child + 1])) {
+      ++Child;
+    }
+
+    if (!InternalRelocationIndexEntryLess (&Entries[Root], &Entries[Child])) {
+      return;
+    }
+
+    CopyMem (&Temp, &Entries[Root], sizeof (Temp));
+    CopyMem (&Entries[Root], &Entries[Child], sizeof (Temp));
+    CopyMem (&Entries[Child], &Temp, sizeof (Temp));
+
+    Root = Child;
+  }
+}
+
+/**
+  Sorts the relocation index by target address.  Heap sort is used as it
+  requires no additional memory and has no degenerate inputs.
+
+  @param[in,out] Entries     The entries to sort.
+  @param[in]     NumEntries  The number of entries in Entries.
+
+**/
+STATIC
+VOID
+InternalSortRelocationIndex (
+  IN OUT OC_MACHO_RELOCATION_INDEX_ENTRY  *Entries,
+  IN     UINT32                           NumEntries
+  )
+{
+  OC_MACHO_RELOCATION_INDEX_ENTRY  Temp;
+  UINT32                           Index;
+
+  if (NumEntries < 2) {
+    return;
+  }
+
+  for (Index = NumEntries / 2; Index > 0; --Index) {
+    InternalRelocationIndexSiftDown (Entries, Index - 1, NumEntries);
+  }
+
+  for (Index = NumEntries - 1; Index > 0; --Index) {
+    CopyMem (&Temp, &Entries[0], sizeof (Temp));
+    CopyMem (&Entries[0], &Entries[Index], sizeof (Temp));
+    CopyMem (&Entries[Index], &Temp, sizeof (Temp));
+
+    InternalRelocationIndexSiftDown (Entries, 0, Index);
+  }
+}
+
+/**
+  Builds a relocation index for the extern or local relocations of the
+  Mach-O.  On failure, the index is left empty and lookups scan the
+  relocation tables instead.
+
+  @param[in,out] Context     Context of the Mach-O.
+  @param[out]    RelocIndex  The index to build.
+  @param[in]     External    Whether to index the extern relocations.
+
+**/
+STATIC
+VOID
+InternalBuildRelocationIndex (
+  IN OUT OC_MACHO_CONTEXT           *Context,
+  OUT    OC_MACHO_RELOCATION_INDEX  *RelocIndex,
+  IN     BOOLEAN                    External
+  )
+{
+  MACH_SECTION_ANY                 *Section;
+  UINT32                           SectionIndex;
+  UINT32                           Index;
+  MACH_RELOCATION_INFO             *Relocations;
+  MACH_RELOCATION_INFO             *Relocation;
+  UINT32                           RelocationCount;
+  UINT32                           MaxEntries;
+  UINT64                           SectionAddress;
+  OC_MACHO_RELOCATION_INDEX_ENTRY  *Entries;
+  UINT32                           NumEntries;
+
+  ASSERT (!RelocIndex->Initialized);
+
+  RelocIndex->Initialized = TRUE;
+  RelocIndex->Entries     = NULL;
+  RelocIndex->NumEntries  = 0;
+
+  if (Context->DySymtab != NULL) {
+    MaxEntries = External ? Context->DySymtab->NumExternalRelocations
+      : Context->DySymtab->NumOfLocalRelocations;
+  } else {
+    MaxEntries = 0;
+    for (
+      SectionIndex = 0;
+      (Section = MachoGetSectionByIndex (Context, SectionIndex)) != NULL;
+      ++SectionIndex
+      ) {
+      RelocationCount = Context->Is32Bit ? Section->Section32.NumRelocations : Section->Section64.NumRelocations;
+      if (OcOverflowAddU32 (MaxEntries, RelocationCount, &MaxEntries)) {
+        return;
+      }
+    }
+  }
+
+  //
+  // Scanning small relocation tables is cheaper than maintaining an index.
+  //
+  if (MaxEntries < MACHO_RELOCATION_INDEX_THRESHOLD
+   || MaxEntries > MAX_UINT32 / sizeof (*Entries)) {
+    return;
+  }
+
+  Entries = AllocatePool (MaxEntries * sizeof (*Entries));
+  if (Entries == NULL) {
+    return;
+  }
+
+  NumEntries = 0;
+
+  if (Context->DySymtab != NULL) {
+    Relocations = External ? Context->ExternRelocations : Context->LocalRelocations;
+    if (Relocations == NULL) {
+      FreePool (Entries);
+      return;
+    }
+
+    for (Index = 0; Index < MaxEntries; ++Index) {
+      Relocation = &Relocations[Index];
+      //
+      // Mirror the filtering of InternalLookupRelocationByOffset.
+      //
+      if ((Relocation->Extern != 0)
+       || (Relocation->SymbolNumber != MACH_RELOC_ABSOLUTE)) {
+        Entries[NumEntries].Address    = (UINT64) Relocation->Address;
+        Entries[NumEntries].Sequence   = NumEntries;
+        Entries[NumEntries].Relocation = Relocation;
+        ++NumEntries;
+
+        if (MachoRelocationIsPairIntel64 ((UINT8) Relocation->Type)) {
+          if (Index == (MAX_UINT32 - 1)) {
+            break;
+          }
+          ++Index;
+        }
+      }
+    }
+  } else {
+    for (
+      SectionIndex = 0;
+      (Section = MachoGetSectionByIndex (Context, SectionIndex)) != NULL;
+      ++SectionIndex
+      ) {
+      RelocationCount = Context->Is32Bit ? Section->Section32.NumRelocations : Section->Section64.NumRelocations;
+      if (RelocationCount == 0) {
+        continue;
+      }
+
+      Relocations = (MACH_RELOCATION_INFO*) (((UINTN)(Context->MachHeader))
+        + (Context->Is32Bit ? Section->Section32.RelocationsOffset : Section->Section64.RelocationsOffset));
+      SectionAddress = Context->Is32Bit ? Section->Section32.Address : Section->Section64.Address;
+
+      //
+      // Mirror the filtering of InternalLookupSectionRelocationByOffset.
+      //
+      for (Index = 0; Index < RelocationCount && NumEntries < MaxEntries; ++Index) {
+        Relocation = &Relocations[Index];
+        if ((Relocation->Extern == 0)
+         && (Relocation->SymbolNumber == MACH_RELOC_ABSOLUTE)) {
+          continue;
+        }
+
+        if (Relocation->Extern != (UINT32)(External ? 1 : 0)) {
+          continue;
+        }
+
+        if (Context->Is32Bit) {
+          Entries[NumEntries].Address = (UINT32) Relocation->Address + (UINT32) SectionAddress;
+        } else {
+          Entries[NumEntries].Address = (UINT64) Relocation->Address + SectionAddress;
+        }
+
+        Entries[NumEntries].Sequence   = NumEntries;
+        Entries[NumEntries].Relocation = Relocation;
+        ++NumEntries;
+      }
+    }
+  }
+
+  InternalSortRelocationIndex (Entries, NumEntries);
+
+  RelocIndex->Entries    = Entries;
+  RelocIndex->NumEntries = NumEntries;
+}
+
+/**
+  Retrieves a Relocation by the address it targets via a relocation index.
+
+  @param[in] RelocIndex  The index to search.
+  @param[in] Address     The address to search for.
+
+  @retval NULL  NULL is returned on failure.
+
+**/
+STATIC
+MACH_RELOCATION_INFO *
+InternalLookupRelocationIndex (
+  IN CONST OC_MACHO_RELOCATION_INDEX  *RelocIndex,
+  IN       UINT64                     Address
+  )
+{
+  UINT32  Low;
+  UINT32  High;
+  UINT32  Middle;
+
+  ASSERT (RelocIndex->Entries != NULL);
+
+  //
+  // Find the first entry not less than Address.
+  //
+  Low  = 0;
+  High = RelocIndex->NumEntries;
+  while (Low < High) {
+    Middle = Low + (High - Low) / 2;
+    if (RelocIndex->Entries[Middle].Address < Address) {
+      Low = Middle + 1;
+    } else {
+      High = Middle;
+    }
+  }
+
+  if (Low < RelocIndex->NumEntries && RelocIndex->Entries[Low].Address == Address) {
+    return RelocIndex->Entries[Low].Relocation;
+  }
+
+  return NULL;
+}
+
+VOID
+MachoFreeRelocationIndex (
+  IN OUT OC_MACHO_CONTEXT  *Context
+  )
+{
+  ASSERT (Context != NULL);
+
+  if (Context->ExternRelocationIndex.Entries != NULL) {
+    FreePool (Context->ExternRelocationIndex.Entries);
+  }
+
+  if (Context->LocalRelocationIndex.Entries != NULL) {
+    FreePool (Context->LocalRelocationIndex.Entries);
+  }
+
+  ZeroMem (&Context->ExternRelocationIndex, sizeof (Context->ExternRelocationIndex));
+  ZeroMem (&Context->LocalRelocationIndex, sizeof (Context->LocalRelocationIndex));
+}
+
 /**
   Retrieves an extern Relocation by the address it targets.
 
@@ -209,6 +519,14 @@ InternalGetExternRelocationByOffset (
   IN     UINT64            Address
   )
 {
+  if (!Context->ExternRelocationIndex.Initialized) {
+    InternalBuildRelocationIndex (Context, &Context->ExternRelocationIndex, TRUE);
+  }
+
+  if (Context->ExternRelocationIndex.Entries != NULL) {
+    return InternalLookupRelocationIndex (&Context->ExternRelocationIndex, Address);
+  }
+
   //
   // MH_OBJECT does not have a DYSYMTAB.
   //
@@ -242,6 +560,14 @@ InternalGetLocalRelocationByOffset (
   IN     UINT64            Address
   )
 {
+  if (!Context->LocalRelocationIndex.Initialized) {
+    InternalBuildRelocationIndex (Context, &Context->LocalRelocationIndex, FALSE);
+  }
+
+  if (Context->LocalRelocationIndex.Entries != NULL) {
+    return InternalLookupRelocationIndex (&Context->LocalRelocationIndex, Address);
+  }
+
   //
   // MH_OBJECT does not have a DYSYMTAB.
   //
@@ -15,13 +15,19 @@ WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
 #include "ProcessorBind.h"
 #include <Library/OcMainLib.h>
 
+#include <Guid/OcVariable.h>
+
 #include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
 #include <Library/DebugLib.h>
+#include <Library/DevicePathLib.h>
 #include <Library/MemoryAllocationLib.h>
 #include <Library/OcAfterBootCompatLib.h>
 #include <Library/OcAppleKernelLib.h>
+#include <Library/OcGuardLib.h>
 #include <Library/OcMiscLib.h>
 #include <Library/OcAppleImg4Lib.h>
+#include <Library/OcRngLib.h>
 #include <Library/OcStringLib.h>
 #include <Library/OcVirtualFsLib.h>
 #include <Library/PrintLib.h>
@@ -39,6 +45,69 @@ STATIC BOOLEAN             mUse32BitKernel;
 STATIC CACHELESS_CONTEXT   mOcCachelessContext;
 STATIC BOOLEAN             mOcCachelessInProgress;
 
+STATIC GUID                mOcBootVolumeUuid;
+STATIC BOOLEAN             mOcBootVolumeUuidValid;
+
+//
+// Patched prelinked kernel cache stored in the ESP root as kernel-{UUID}.bin.
+//
+#define OC_KERNEL_CACHE_MAGIC      SIGNATURE_32 ('O', 'C', 'K', 'C')
+#define OC_KERNEL_CACHE_VERSION    1
+#define OC_KERNEL_CACHE_MAX_SIZE   BASE_1GB
+#define OC_KERNEL_CACHE_CHUNK_SIZE SIZE_1MB
+#define OC_KERNEL_CACHE_KEY_SIZE   SHA256_DIGEST_SIZE
+#define OC_HMAC_BLOCK_SIZE         64
+
+typedef struct {
+  UINT32  Magic;
+  UINT32  Version;
+  UINT32  KernelSize;
+  UINT32  DarwinVersion;
+  UINT8   InputsDigest[SHA256_DIGEST_SIZE];
+  UINT8   Mac[SHA256_DIGEST_SIZE];
+} OC_KERNEL_CACHE_HEADER;
+
+STATIC UINT8               mOcKernelCacheDigest[SHA256_DIGEST_SIZE];
+STATIC BOOLEAN             mOcKernelCacheDigestValid;
+STATIC BOOLEAN             mOcKernelCacheHit;
+
+STATIC
+BOOLEAN
+OcKernelGetVolumeUuid (
+  IN  EFI_HANDLE  DeviceHandle,
+  OUT GUID        *VolumeUuid
+  )
+{
+  EFI_DEVICE_PATH_PROTOCOL  *DevicePath;
+  HARDDRIVE_DEVICE_PATH     *HardDrive;
+  BOOLEAN                   Found;
+
+  DevicePath = DevicePathFromHandle (DeviceHandle);
+  if (DevicePath == NULL) {
+    return FALSE;
+  }
+
+  //
+  // Use the innermost GPT partition, which is the booted volume.
+  //
+  Found = FALSE;
+  while (!IsDevicePathEnd (DevicePath)) {
+    if (DevicePathType (DevicePath) == MEDIA_DEVICE_PATH
+      && DevicePathSubType (DevicePath) == MEDIA_HARDDRIVE_DP
+      && DevicePathNodeLength (DevicePath) >= sizeof (HARDDRIVE_DEVICE_PATH)) {
+      HardDrive = (HARDDRIVE_DEVICE_PATH *) DevicePath;
+      if (HardDrive->SignatureType == SIGNATURE_TYPE_GUID) {
+        CopyMem (VolumeUuid, HardDrive->Signature, sizeof (*VolumeUuid));
+        Found = TRUE;
+      }
+    }
+
+    DevicePath = NextDevicePathNode (DevicePath);
+  }
+
+  return Found;
+}
+
 STATIC
 VOID
 OcKernelConfigureCapabilities (
@@ -63,6 +132,7 @@ OcKernelConfigureCapabilities (
   // Capabilities will always have K64 stripped when compiled for IA32.
   //
   mUse32BitKernel = (Capabilities & OC_KERN_CAPABILITY_K64_U64) == 0;
+  mOcBootVolumeUuidValid = FALSE;
 
   //
   // Skip if not Apple image.
@@ -72,6 +142,11 @@ OcKernelConfigureCapabilities (
     return;
   }
 
+  //
+  // Remember the booted volume to key cacheless kext index.
+  //
+  mOcBootVolumeUuidValid = OcKernelGetVolumeUuid (LoadedImage->DeviceHandle, &mOcBootVolumeUuid);
+
   //
   // arch boot argument overrides any compatibility checks.
   //
@@ -792,6 +867,236 @@ OcKernelProcessMkext (
   return Status;
 }
 
+STATIC
+EFI_STATUS
+OcKernelCacheGetKey (
+  OUT UINT8  *Key
+  )
+{
+  EFI_STATUS  Status;
+  UINT32      Attributes;
+  UINTN       Size;
+  UINT32      Index;
+  UINT64      Random;
+
+  //
+  // The key is kept in a boot services only variable, so that the operating
+  // system cannot read it and forge the cache.
+  //
+  Size   = OC_KERNEL_CACHE_KEY_SIZE;
+  Status = gRT->GetVariable (
+    OC_KERNEL_CACHE_KEY_VARIABLE_NAME,
+    &gOcVendorVariableGuid,
+    &Attributes,
+    &Size,
+    Key
+    );
+  if (!EFI_ERROR (Status)
+    && Size == OC_KERNEL_CACHE_KEY_SIZE
+    && Attributes == (EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_BOOTSERVICE_ACCESS)) {
+    return EFI_SUCCESS;
+  }
+
+  if (Status != EFI_NOT_FOUND) {
+    gRT->SetVariable (
+      OC_KERNEL_CACHE_KEY_VARIABLE_NAME,
+      &gOcVendorVariableGuid,
+      0,
+      0,
+      NULL
+      );
+  }
+
+  for (Index = 0; Index < OC_KERNEL_CACHE_KEY_SIZE; Index += sizeof (Random)) {
+    Random = GetPseudoRandomNumber64 ();
+    CopyMem (&Key[Index], &Random, sizeof (Random));
+  }
+
+  Status = gRT->SetVariable (
+    OC_KERNEL_CACHE_KEY_VARIABLE_NAME,
+    &gOcVendorVariableGuid,
+    EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_BOOTSERVICE_ACCESS,
+    OC_KERNEL_CACHE_KEY_SIZE,
+    Key
+    );
+
+  DEBUG ((DEBUG_INFO, "OC: Generated new kernel cache key - %r\n", Status));
+  return Status;
+}
+
+STATIC
+VOID
+OcKernelCacheGetMac (
+  IN  CONST UINT8  *Key,
+  IN  CONST VOID   *Header,
+  IN  UINT32       HeaderSize,
+  IN  CONST VOID   *Data,
+  IN  UINT32       DataSize,
+  OUT UINT8        *Mac
+  )
+{
+  SHA256_CONTEXT  Context;
+  UINT8           Pad[OC_HMAC_BLOCK_SIZE];
+  UINT8           InnerDigest[SHA256_DIGEST_SIZE];
+  UINT32          Index;
+
+  //
+  // HMAC-SHA256 over the header without the MAC itself and the data.
+  //
+  ZeroMem (Pad, sizeof (Pad));
+  CopyMem (Pad, Key, OC_KERNEL_CACHE_KEY_SIZE);
+  for (Index = 0; Index < sizeof (Pad); ++Index) {
+    Pad[Index] ^= 0x36;
+  }
+
+  Sha256Init (&Context);
+  Sha256Update (&Context, Pad, sizeof (Pad));
+  Sha256Update (&Context, Header, HeaderSize);
+  Sha256Update (&Context, Data, DataSize);
+  Sha256Final (&Context, InnerDigest);
+
+  for (Index = 0; Index < sizeof (Pad); ++Index) {
+    Pad[Index] ^= 0x36 ^ 0x5C;
+  }
+
+  Sha256Init (&Context);
+  Sha256Update (&Context, Pad, sizeof (Pad));
+  Sha256Update (&Context, InnerDigest, sizeof (InnerDigest));
+  Sha256Final (&Context, Mac);
+
+  SecureZeroMem (Pad, sizeof (Pad));
+  SecureZeroMem (&Context, sizeof (Context));
+}
+
+STATIC
+VOID
+OcKernelLoadCachelessIndex (
+  IN     CACHELESS_CONTEXT      *Context
+  )
+{
+  EFI_STATUS            Status;
+  CHAR16                IndexName[64];
+  UINT8                 *Index;
+  UINT32                IndexSize;
+  UINT8                 Key[OC_KERNEL_CACHE_KEY_SIZE];
+  UINT8                 Mac[SHA256_DIGEST_SIZE];
+
+  UnicodeSPrint (IndexName, sizeof (IndexName), L"cacheless-%g.bin", &mOcBootVolumeUuid);
+
+  IndexSize = 0;
+  Index     = ReadFile (mOcStorage->FileSystem, IndexName, &IndexSize, SIZE_4MB);
+
+  //
+  // The index decides which kexts are treated as built-in, so it is
+  // authenticated the same way as the prelinked kernel cache. The MAC
+  // precedes the index and covers the volume UUID and the index.
+  //
+  if (Index != NULL) {
+    Status = EFI_SECURITY_VIOLATION;
+    if (IndexSize > sizeof (Mac)) {
+      Status = OcKernelCacheGetKey (Key);
+      if (!EFI_ERROR (Status)) {
+        OcKernelCacheGetMac (
+          Key,
+          &mOcBootVolumeUuid,
+          sizeof (mOcBootVolumeUuid),
+          Index + sizeof (Mac),
+          IndexSize - sizeof (Mac),
+          Mac
+          );
+        SecureZeroMem (Key, sizeof (Key));
+        if (SecureCompareMem (Mac, Index, sizeof (Mac)) != 0) {
+          Status = EFI_SECURITY_VIOLATION;
+        }
+      }
+    }
+
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_WARN, "OC: Cacheless index %s failed authentication - %r\n", IndexName, Status));
+      FreePool (Index);
+      Index = NULL;
+    }
+  }
+
+  Status = CachelessContextSetIndex (
+    Context,
+    &mOcBootVolumeUuid,
+    Index != NULL ? Index + sizeof (Mac) : NULL,
+    Index != NULL ? IndexSize - sizeof (Mac) : 0
+    );
+  DEBUG ((DEBUG_INFO, "OC: Cacheless index %s (%u) - %r\n", IndexName, IndexSize, Status));
+
+  if (Index != NULL) {
+    FreePool (Index);
+  }
+}
+
+STATIC
+VOID
+OcKernelSaveCachelessIndex (
+  IN     CACHELESS_CONTEXT      *Context
+  )
+{
+  EFI_STATUS            Status;
+  CHAR16                IndexName[64];
+  VOID                  *Index;
+  UINT32                IndexSize;
+  UINT8                 *File;
+  UINT32                FileSize;
+  UINT8                 Key[OC_KERNEL_CACHE_KEY_SIZE];
+  EFI_FILE_PROTOCOL     *RootFs;
+
+  Status = CachelessContextGetIndex (Context, &Index, &IndexSize);
+  if (EFI_ERROR (Status)) {
+    return;
+  }
+
+  if (OcOverflowAddU32 (IndexSize, SHA256_DIGEST_SIZE, &FileSize)) {
+    FreePool (Index);
+    return;
+  }
+
+  File = AllocatePool (FileSize);
+  if (File == NULL) {
+    FreePool (Index);
+    return;
+  }
+
+  Status = OcKernelCacheGetKey (Key);
+  if (EFI_ERROR (Status)) {
+    FreePool (File);
+    FreePool (Index);
+    return;
+  }
+
+  CopyMem (File + SHA256_DIGEST_SIZE, Index, IndexSize);
+  FreePool (Index);
+
+  OcKernelCacheGetMac (
+    Key,
+    &mOcBootVolumeUuid,
+    sizeof (mOcBootVolumeUuid),
+    File + SHA256_DIGEST_SIZE,
+    IndexSize,
+    File
+    );
+  SecureZeroMem (Key, sizeof (Key));
+
+  UnicodeSPrint (IndexName, sizeof (IndexName), L"cacheless-%g.bin", &mOcBootVolumeUuid);
+
+  Status = mOcStorage->FileSystem->OpenVolume (
+    mOcStorage->FileSystem,
+    &RootFs
+    );
+  if (!EFI_ERROR (Status)) {
+    Status = SetFileData (RootFs, IndexName, File, FileSize);
+    RootFs->Close (RootFs);
+  }
+
+  DEBUG ((DEBUG_INFO, "OC: Saving %u byte cacheless index %s - %r\n", FileSize, IndexName, Status));
+  FreePool (File);
+}
+
 STATIC
 EFI_STATUS
 OcKernelInitCacheless (
@@ -817,6 +1122,10 @@ OcKernelInitCacheless (
     return Status;
   }
 
+  if (Config->Kernel.Scheme.CachelessIndex && mOcBootVolumeUuidValid) {
+    OcKernelLoadCachelessIndex (Context);
+  }
+
   OcKernelInjectKexts (Config, CacheTypeCacheless, Context, DarwinVersion, Is32Bit, 0, 0);
 
   OcKernelApplyPatches (Config, mOcCpuInfo, DarwinVersion, Is32Bit, CacheTypeCacheless, Context, NULL, 0);
@@ -826,6 +1135,264 @@ OcKernelInitCacheless (
   return CachelessContextOverlayExtensionsDir (Context, File);
 }
 
+STATIC
+EFI_STATUS
+OcKernelCacheHashKernelFile (
+  IN  EFI_FILE_PROTOCOL  *KernelFile,
+  OUT UINT8              *Digest
+  )
+{
+  EFI_STATUS      Status;
+  SHA384_CONTEXT  Context;
+  UINT8           *Buffer;
+  UINT32          FileSize;
+  UINT32          Position;
+  UINT32          ChunkSize;
+
+  Status = GetFileSize (KernelFile, &FileSize);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Buffer = AllocatePool (MIN (FileSize, OC_KERNEL_CACHE_CHUNK_SIZE));
+  if (Buffer == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Sha384Init (&Context);
+
+  for (Position = 0; Position < FileSize; Position += ChunkSize) {
+    ChunkSize = MIN (FileSize - Position, OC_KERNEL_CACHE_CHUNK_SIZE);
+    Status    = GetFileData (KernelFile, Position, ChunkSize, Buffer);
+    if (EFI_ERROR (Status)) {
+      FreePool (Buffer);
+      return Status;
+    }
+
+    Sha384Update (&Context, Buffer, ChunkSize);
+  }
+
+  Sha384Final (&Context, Digest);
+  FreePool (Buffer);
+  return EFI_SUCCESS;
+}
+
+STATIC
+VOID
+OcKernelCacheHashKexts (
+  IN OUT SHA256_CONTEXT       *Context,
+  IN     UINT32               Count,
+  IN     OC_KERNEL_ADD_ENTRY  **Kexts
+  )
+{
+  UINT32               Index;
+  OC_KERNEL_ADD_ENTRY  *Kext;
+
+  for (Index = 0; Index < Count; ++Index) {
+    Kext = Kexts[Index];
+    Sha256Update (Context, (CONST UINT8 *) &Index, sizeof (Index));
+    if (Kext->PlistData != NULL) {
+      Sha256Update (Context, (CONST UINT8 *) &Kext->PlistDataSize, sizeof (Kext->PlistDataSize));
+      Sha256Update (Context, Kext->PlistData, Kext->PlistDataSize);
+    }
+    if (Kext->ImageData != NULL) {
+      Sha256Update (Context, (CONST UINT8 *) &Kext->ImageDataSize, sizeof (Kext->ImageDataSize));
+      Sha256Update (Context, Kext->ImageData, Kext->ImageDataSize);
+    }
+  }
+}
+
+STATIC
+EFI_STATUS
+OcKernelCacheGetInputsDigest (
+  IN  EFI_FILE_PROTOCOL  *KernelFile,
+  IN  BOOLEAN            Is32Bit,
+  OUT UINT8              *KernelDigest,
+  OUT UINT8              *InputsDigest
+  )
+{
+  EFI_STATUS      Status;
+  SHA256_CONTEXT  Context;
+  CHAR8           *ConfigData;
+  UINT32          ConfigDataSize;
+  UINT32          CacheVersion;
+
+  //
+  // Patching results depend on the kernel, the kexts loaded for injection,
+  // the configuration and the CPU used for CPUID patches. The whole
+  // configuration is hashed as any of its parts may affect patching.
+  //
+  Status = OcKernelCacheHashKernelFile (KernelFile, KernelDigest);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  ConfigData = OcStorageReadFileUnicode (
+    mOcStorage,
+    OPEN_CORE_CONFIG_PATH,
+    &ConfigDataSize
+    );
+  if (ConfigData == NULL) {
+    return EFI_NOT_FOUND;
+  }
+
+  CacheVersion = OC_KERNEL_CACHE_VERSION;
+
+  Sha256Init (&Context);
+  Sha256Update (&Context, (CONST UINT8 *) &CacheVersion, sizeof (CacheVersion));
+  Sha256Update (&Context, (CONST UINT8 *) &Is32Bit, sizeof (Is32Bit));
+  Sha256Update (&Context, KernelDigest, SHA384_DIGEST_SIZE);
+  Sha256Update (&Context, (CONST UINT8 *) ConfigData, ConfigDataSize);
+  Sha256Update (&Context, (CONST UINT8 *) &mOcCpuInfo->CpuidVerEax, sizeof (mOcCpuInfo->CpuidVerEax));
+  Sha256Update (&Context, (CONST UINT8 *) &mOcCpuInfo->CpuidVerEbx, sizeof (mOcCpuInfo->CpuidVerEbx));
+  Sha256Update (&Context, (CONST UINT8 *) &mOcCpuInfo->CpuidVerEcx, sizeof (mOcCpuInfo->CpuidVerEcx));
+  Sha256Update (&Context, (CONST UINT8 *) &mOcCpuInfo->CpuidVerEdx, sizeof (mOcCpuInfo->CpuidVerEdx));
+  Sha256Update (&Context, (CONST UINT8 *) &mOcCpuInfo->MicrocodeRevision, sizeof (mOcCpuInfo->MicrocodeRevision));
+  OcKernelCacheHashKexts (&Context, mOcConfiguration->Kernel.Force.Count, mOcConfiguration->Kernel.Force.Values);
+  OcKernelCacheHashKexts (&Context, mOcConfiguration->Kernel.Add.Count, mOcConfiguration->Kernel.Add.Values);
+  Sha256Final (&Context, InputsDigest);
+
+  FreePool (ConfigData);
+  return EFI_SUCCESS;
+}
+
+STATIC
+EFI_STATUS
+OcKernelCacheLoad (
+  IN     CONST UINT8  *InputsDigest,
+  IN OUT UINT32       *DarwinVersion,
+     OUT UINT8        **Kernel,
+     OUT UINT32       *KernelSize,
+     OUT UINT32       *AllocatedSize
+  )
+{
+  EFI_STATUS              Status;
+  CHAR16                  CacheName[64];
+  UINT8                   *Cache;
+  UINT32                  CacheSize;
+  OC_KERNEL_CACHE_HEADER  *Header;
+  UINT8                   Key[OC_KERNEL_CACHE_KEY_SIZE];
+  UINT8                   Mac[SHA256_DIGEST_SIZE];
+
+  UnicodeSPrint (CacheName, sizeof (CacheName), L"kernel-%g.bin", &mOcBootVolumeUuid);
+
+  Cache = ReadFile (mOcStorage->FileSystem, CacheName, &CacheSize, OC_KERNEL_CACHE_MAX_SIZE);
+  if (Cache == NULL) {
+    return EFI_NOT_FOUND;
+  }
+
+  Header = (OC_KERNEL_CACHE_HEADER *) Cache;
+  if (CacheSize < sizeof (*Header)
+    || Header->Magic != OC_KERNEL_CACHE_MAGIC
+    || Header->Version != OC_KERNEL_CACHE_VERSION
+    || Header->KernelSize > CacheSize - sizeof (*Header)
+    || Header->DarwinVersion < *DarwinVersion
+    || CompareMem (Header->InputsDigest, InputsDigest, SHA256_DIGEST_SIZE) != 0) {
+    FreePool (Cache);
+    return EFI_NOT_FOUND;
+  }
+
+  Status = OcKernelCacheGetKey (Key);
+  if (EFI_ERROR (Status)) {
+    FreePool (Cache);
+    return Status;
+  }
+
+  OcKernelCacheGetMac (Key, Header, OFFSET_OF (OC_KERNEL_CACHE_HEADER, Mac), Cache + sizeof (*Header), Header->KernelSize, Mac);
+  SecureZeroMem (Key, sizeof (Key));
+  if (SecureCompareMem (Mac, Header->Mac, sizeof (Mac)) != 0) {
+    DEBUG ((DEBUG_WARN, "OC: Kernel cache %s failed authentication\n", CacheName));
+    FreePool (Cache);
+    return EFI_SECURITY_VIOLATION;
+  }
+
+  *DarwinVersion = Header->DarwinVersion;
+  *KernelSize    = Header->KernelSize;
+  *AllocatedSize = CacheSize;
+  *Kernel        = Cache;
+
+  //
+  // Move the kernel to the beginning of the buffer, which is freed by its owner.
+  //
+  CopyMem (Cache, Cache + sizeof (*Header), *KernelSize);
+  return EFI_SUCCESS;
+}
+
+STATIC
+VOID
+OcKernelCacheSave (
+  IN CONST UINT8  *Kernel,
+  IN UINT32       KernelSize,
+  IN UINT32       DarwinVersion
+  )
+{
+  EFI_STATUS              Status;
+  CHAR16                  CacheName[64];
+  OC_KERNEL_CACHE_HEADER  Header;
+  UINT8                   Key[OC_KERNEL_CACHE_KEY_SIZE];
+  EFI_FILE_PROTOCOL       *RootFs;
+  EFI_FILE_PROTOCOL       *File;
+  UINTN                   WrittenSize;
+
+  Status = OcKernelCacheGetKey (Key);
+  if (EFI_ERROR (Status)) {
+    return;
+  }
+
+  Header.Magic         = OC_KERNEL_CACHE_MAGIC;
+  Header.Version       = OC_KERNEL_CACHE_VERSION;
+  Header.KernelSize    = KernelSize;
+  Header.DarwinVersion = DarwinVersion;
+  CopyMem (Header.InputsDigest, mOcKernelCacheDigest, sizeof (Header.InputsDigest));
+  OcKernelCacheGetMac (Key, &Header, OFFSET_OF (OC_KERNEL_CACHE_HEADER, Mac), Kernel, KernelSize, Header.Mac);
+  SecureZeroMem (Key, sizeof (Key));
+
+  UnicodeSPrint (CacheName, sizeof (CacheName), L"kernel-%g.bin", &mOcBootVolumeUuid);
+
+  Status = mOcStorage->FileSystem->OpenVolume (
+    mOcStorage->FileSystem,
+    &RootFs
+    );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_INFO, "OC: Saving kernel cache %s - %r\n", CacheName, Status));
+    return;
+  }
+
+  //
+  // Recreate the file to drop the contents of an older and larger cache.
+  //
+  Status = SafeFileOpen (RootFs, &File, CacheName, EFI_FILE_MODE_CREATE | EFI_FILE_MODE_READ | EFI_FILE_MODE_WRITE, 0);
+  if (!EFI_ERROR (Status)) {
+    File->Delete (File);
+    Status = SafeFileOpen (RootFs, &File, CacheName, EFI_FILE_MODE_CREATE | EFI_FILE_MODE_READ | EFI_FILE_MODE_WRITE, 0);
+  }
+
+  if (!EFI_ERROR (Status)) {
+    WrittenSize = sizeof (Header);
+    Status = File->Write (File, &WrittenSize, &Header);
+    if (!EFI_ERROR (Status)) {
+      WrittenSize = KernelSize;
+      Status = File->Write (File, &WrittenSize, (VOID *) Kernel);
+      if (!EFI_ERROR (Status) && WrittenSize != KernelSize) {
+        Status = EFI_VOLUME_FULL;
+      }
+    }
+
+    //
+    // Do not leave an incomplete cache behind.
+    //
+    if (EFI_ERROR (Status)) {
+      File->Delete (File);
+    } else {
+      File->Close (File);
+    }
+  }
+
+  RootFs->Close (RootFs);
+
+  DEBUG ((DEBUG_INFO, "OC: Saving %u byte kernel cache %s - %r\n", KernelSize, CacheName, Status));
+}
+
 STATIC
 EFI_STATUS
 OcKernelReadAppleKernel (
@@ -850,6 +1417,7 @@ OcKernelReadAppleKernel (
   UINT32             ReservedInfoSize;
   UINT32             NumReservedKexts;
   UINT32             ReservedFullSize;
+  UINT8              KernelDigest[SHA384_DIGEST_SIZE];
 
   OcKernelLoadKextsAndReserve (
     RootFile,
@@ -877,6 +1445,39 @@ OcKernelReadAppleKernel (
     return EFI_UNSUPPORTED;
   }
 
+  //
+  // Try to serve previously patched kernel from the cache.
+  //
+  mOcKernelCacheHit         = FALSE;
+  mOcKernelCacheDigestValid = FALSE;
+  if (mOcConfiguration->Kernel.Scheme.PrelinkedCache && mOcBootVolumeUuidValid) {
+    Status = OcKernelCacheGetInputsDigest (
+      KernelFile,
+      Is32Bit,
+      KernelDigest,
+      mOcKernelCacheDigest
+      );
+    mOcKernelCacheDigestValid = !EFI_ERROR (Status);
+
+    if (mOcKernelCacheDigestValid) {
+      Status = OcKernelCacheLoad (
+        mOcKernelCacheDigest,
+        DarwinVersion,
+        Kernel,
+        KernelSize,
+        AllocatedSize
+        );
+      DEBUG ((DEBUG_INFO, "OC: Kernel cache for %s - %r\n", FileName, Status));
+      if (!EFI_ERROR (Status)) {
+        if (Digest != NULL) {
+          CopyMem (Digest, KernelDigest, SHA384_DIGEST_SIZE);
+        }
+        mOcKernelCacheHit = TRUE;
+        return EFI_SUCCESS;
+      }
+    }
+  }
+
   //
   // Read last requested architecture for kernel.
   //
@@ -1216,32 +1817,38 @@ OcKernelFileOpen (
         return EFI_NOT_FOUND;
       }
 
-      //
-      // Apply patches to kernel itself, and then process prelinked.
-      //
-      OcKernelApplyPatches (
-        mOcConfiguration,
-        mOcCpuInfo,
-        mOcDarwinVersion,
-        mUse32BitKernel,
-        CacheTypeNone,
-        NULL,
-        Kernel,
-        KernelSize
-        );
-
-      PrelinkedStatus = OcKernelProcessPrelinked (
-        mOcConfiguration,
-        mOcDarwinVersion,
-        mUse32BitKernel,
-        Kernel,
-        &KernelSize,
-        AllocatedSize,
-        LinkedExpansion,
-        ReservedExeSize
-        );
-
-      DEBUG ((DEBUG_INFO, "OC: Prelinked status - %r\n", PrelinkedStatus));
+      if (!mOcKernelCacheHit) {
+        //
+        // Apply patches to kernel itself, and then process prelinked.
+        //
+        OcKernelApplyPatches (
+          mOcConfiguration,
+          mOcCpuInfo,
+          mOcDarwinVersion,
+          mUse32BitKernel,
+          CacheTypeNone,
+          NULL,
+          Kernel,
+          KernelSize
+          );
+
+        PrelinkedStatus = OcKernelProcessPrelinked (
+          mOcConfiguration,
+          mOcDarwinVersion,
+          mUse32BitKernel,
+          Kernel,
+          &KernelSize,
+          AllocatedSize,
+          LinkedExpansion,
+          ReservedExeSize
+          );
+
+        DEBUG ((DEBUG_INFO, "OC: Prelinked status - %r\n", PrelinkedStatus));
+
+        if (!EFI_ERROR (PrelinkedStatus) && mOcKernelCacheDigestValid) {
+          OcKernelCacheSave (Kernel, KernelSize, mOcDarwinVersion);
+        }
+      }
 
       Status = GetFileModificationTime (*NewHandle, &ModificationTime);
       if (EFI_ERROR (Status)) {
@@ -1421,6 +2028,11 @@ OcKernelFileOpen (
         DEBUG ((DEBUG_INFO, "OC: Error SLE hooking %s - %r\n", FileName, Status));
       }
 
+      //
+      // Built-in kext list is built on first hook, save it if asked to.
+      //
+      OcKernelSaveCachelessIndex (&mOcCachelessContext);
+
       if (!EFI_ERROR (Status) && VirtualFileHandle != NULL) {
         *NewHandle = VirtualFileHandle;
         return EFI_SUCCESS;
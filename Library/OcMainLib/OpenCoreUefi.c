@@ -740,6 +740,8 @@ OcLoadUefiSupport (
     ActivateHpetSupport ();
   }
 
+  OcCpuUpdateFrequencyCache (Config->Uefi.Quirks.CacheTscFrequency);
+
   if (Config->Uefi.Quirks.IgnoreInvalidFlexRatio) {
     OcCpuCorrectFlexRatio (CpuInfo);
   }
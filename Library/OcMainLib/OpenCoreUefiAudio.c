@@ -17,9 +17,11 @@ WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
 #include <Guid/AppleVariable.h>
 #include <Guid/OcVariable.h>
 #include <Guid/GlobalVariable.h>
+#include <Protocol/AppleVoiceOver.h>
 #include <Protocol/AudioDecode.h>
 
 #include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
 #include <Library/DebugLib.h>
 #include <Library/DevicePathLib.h>
 #include <Library/MemoryAllocationLib.h>
@@ -48,10 +50,36 @@ WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
 #include <Library/UefiRuntimeServicesTableLib.h>
 
 typedef struct OC_AUDIO_FILE_ {
-  UINT8   *Buffer;
-  UINT32  Size;
+  UINT8                       *Buffer;
+  UINT32                      Size;
+  EFI_AUDIO_IO_PROTOCOL_FREQ  Frequency;
+  EFI_AUDIO_IO_PROTOCOL_BITS  Bits;
+  UINT8                       Channels;
 } OC_AUDIO_FILE;
 
+typedef struct OC_AUDIO_PREDECODE_REQUEST_ {
+  UINT32                          File;
+  APPLE_VOICE_OVER_LANGUAGE_CODE  LanguageCode;
+} OC_AUDIO_PREDECODE_REQUEST;
+
+typedef struct OC_AUDIO_PREDECODED_FILE_ {
+  OC_AUDIO_PREDECODE_REQUEST  Request;
+  OC_AUDIO_FILE               Data;
+} OC_AUDIO_PREDECODED_FILE;
+
+//
+// Amount of pending predecode requests.
+//
+#define OC_AUDIO_PREDECODE_QUEUE_SIZE  8
+//
+// Amount of predecoded files kept in memory until played.
+//
+#define OC_AUDIO_PREDECODE_MAX_FILES   4
+//
+// Delay before decoding the next queued file, lets the caller start playback first.
+//
+#define OC_AUDIO_PREDECODE_DELAY       EFI_TIMER_PERIOD_MILLISECONDS (100)
+
 STATIC OC_AUDIO_FILE  mAppleAudioFiles[AppleVoiceOverAudioFileMax];
 STATIC OC_AUDIO_FILE  mOcAudioFiles[OcVoiceOverAudioFileMax - OcVoiceOverAudioFileBase];
 //
@@ -61,6 +89,17 @@ STATIC OC_AUDIO_FILE  mOcAudioFiles[OcVoiceOverAudioFileMax - OcVoiceOverAudioFi
 STATIC BOOLEAN        mEnableAudioCaching = FALSE;
 STATIC EFI_AUDIO_DECODE_PROTOCOL  *mAudioDecodeProtocol = NULL;
 
+//
+// Files likely to be spoken next are decoded from a timer while the picker
+// is idle, so that the first spoken prompts do not wait for decoding.
+//
+STATIC OC_AUDIO_PREDECODE_REQUEST  mPredecodeQueue[OC_AUDIO_PREDECODE_QUEUE_SIZE];
+STATIC UINT32                      mPredecodeQueueCount;
+STATIC OC_AUDIO_PREDECODED_FILE    mPredecodedFiles[OC_AUDIO_PREDECODE_MAX_FILES];
+STATIC UINT32                      mPredecodedFileNext;
+STATIC EFI_EVENT                   mPredecodeEvent;
+STATIC BOOLEAN                     mAudioAcquireActive;
+
 STATIC
 CONST CHAR8 *
 OcAudioGetFilePath (
@@ -297,53 +336,20 @@ OcAudioGetFileContents (
 
 STATIC
 EFI_STATUS
-EFIAPI
-OcAudioAcquireFile (
-  IN  VOID                            *Context,
+OcAudioLoadFile (
+  IN  OC_STORAGE_CONTEXT              *Storage,
   IN  UINT32                          File,
   IN  APPLE_VOICE_OVER_LANGUAGE_CODE  LanguageCode,
-  OUT UINT8                           **Buffer,
-  OUT UINT32                          *BufferSize,
-  OUT EFI_AUDIO_IO_PROTOCOL_FREQ      *Frequency,
-  OUT EFI_AUDIO_IO_PROTOCOL_BITS      *Bits,
-  OUT UINT8                           *Channels
+  OUT OC_AUDIO_FILE                   *AudioFile
   )
 {
   EFI_STATUS          Status;
   CHAR8               TmpPath[8];
-  OC_STORAGE_CONTEXT  *Storage;
   CONST CHAR8         *BaseType;
   CONST CHAR8         *BasePath;
   UINT8               *FileBuffer;
   UINT32              FileBufferSize;
   BOOLEAN             Localised;
-  OC_AUDIO_FILE       *CacheFile;
-
-  Storage   = (OC_STORAGE_CONTEXT *) Context;
-  CacheFile = NULL;
-
-  if (File >= OcVoiceOverAudioFileBase && File < OcVoiceOverAudioFileMax) {
-    if (mEnableAudioCaching) {
-      CacheFile = &mOcAudioFiles[File - OcVoiceOverAudioFileBase];
-      if (CacheFile->Buffer != NULL) {
-        *Buffer = CacheFile->Buffer;
-        *BufferSize = CacheFile->Size;
-        return EFI_SUCCESS;
-      }
-    }
-  } else if (File < AppleVoiceOverAudioFileMax) {
-    if (mEnableAudioCaching) {
-      CacheFile = &mAppleAudioFiles[File];
-      if (CacheFile->Buffer != NULL) {
-        *Buffer = CacheFile->Buffer;
-        *BufferSize = CacheFile->Size;
-        return EFI_SUCCESS;
-      }
-    }
-  } else {
-    DEBUG ((DEBUG_INFO, "OC: Invalid wave index %d\n", File));
-    return EFI_NOT_FOUND;
-  }
 
   BasePath = OcAudioGetFilePath (
     File,
@@ -390,11 +396,11 @@ OcAudioAcquireFile (
     mAudioDecodeProtocol,
     FileBuffer,
     FileBufferSize,
-    (VOID **) Buffer,
-    BufferSize,
-    Frequency,
-    Bits,
-    Channels
+    (VOID **) &AudioFile->Buffer,
+    &AudioFile->Size,
+    &AudioFile->Frequency,
+    &AudioFile->Bits,
+    &AudioFile->Channels
     );
 
   FreePool (FileBuffer);
@@ -404,11 +410,240 @@ OcAudioAcquireFile (
     return EFI_UNSUPPORTED;
   }
 
-  if (CacheFile != NULL) {
-    CacheFile->Buffer = *Buffer;
-    CacheFile->Size   = *BufferSize;
+  return EFI_SUCCESS;
+}
+
+STATIC
+BOOLEAN
+OcAudioTakePredecodedFile (
+  IN  UINT32                          File,
+  IN  APPLE_VOICE_OVER_LANGUAGE_CODE  LanguageCode,
+  OUT OC_AUDIO_FILE                   *AudioFile
+  )
+{
+  UINT32  Index;
+
+  for (Index = 0; Index < OC_AUDIO_PREDECODE_MAX_FILES; ++Index) {
+    if (mPredecodedFiles[Index].Data.Buffer != NULL
+      && mPredecodedFiles[Index].Request.File == File
+      && mPredecodedFiles[Index].Request.LanguageCode == LanguageCode) {
+      //
+      // Ownership is passed to the caller, the buffer is freed on release.
+      //
+      CopyMem (AudioFile, &mPredecodedFiles[Index].Data, sizeof (*AudioFile));
+      mPredecodedFiles[Index].Data.Buffer = NULL;
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+STATIC
+VOID
+OcAudioQueuePredecode (
+  IN UINT32                          File,
+  IN APPLE_VOICE_OVER_LANGUAGE_CODE  LanguageCode
+  )
+{
+  UINT32  Index;
+
+  if (mPredecodeEvent == NULL
+    || mPredecodeQueueCount == OC_AUDIO_PREDECODE_QUEUE_SIZE) {
+    return;
+  }
+
+  for (Index = 0; Index < mPredecodeQueueCount; ++Index) {
+    if (mPredecodeQueue[Index].File == File
+      && mPredecodeQueue[Index].LanguageCode == LanguageCode) {
+      return;
+    }
   }
 
+  for (Index = 0; Index < OC_AUDIO_PREDECODE_MAX_FILES; ++Index) {
+    if (mPredecodedFiles[Index].Data.Buffer != NULL
+      && mPredecodedFiles[Index].Request.File == File
+      && mPredecodedFiles[Index].Request.LanguageCode == LanguageCode) {
+      return;
+    }
+  }
+
+  mPredecodeQueue[mPredecodeQueueCount].File         = File;
+  mPredecodeQueue[mPredecodeQueueCount].LanguageCode = LanguageCode;
+  ++mPredecodeQueueCount;
+
+  gBS->SetTimer (mPredecodeEvent, TimerRelative, OC_AUDIO_PREDECODE_DELAY);
+}
+
+STATIC
+VOID
+OcAudioQueueLikelyFiles (
+  IN UINT32                          File,
+  IN APPLE_VOICE_OVER_LANGUAGE_CODE  LanguageCode
+  )
+{
+  //
+  // Picker prompts follow a fixed order: the prompt, then entries by index,
+  // selection, and finally loading. Predict the next file from the current one.
+  //
+  if (File > OcVoiceOverAudioFileIndexBase && File < OcVoiceOverAudioFileIndexMax) {
+    OcAudioQueuePredecode (File + 1, LanguageCode);
+    return;
+  }
+
+  switch (File) {
+    case OcVoiceOverAudioFileWelcome:
+      OcAudioQueuePredecode (OcVoiceOverAudioFileChooseOS, LanguageCode);
+      break;
+    case OcVoiceOverAudioFileChooseOS:
+      OcAudioQueuePredecode (OcVoiceOverAudioFileIndexBase + 1, LanguageCode);
+      OcAudioQueuePredecode (OcVoiceOverAudioFileSelected, LanguageCode);
+      break;
+    case OcVoiceOverAudioFileAbortTimeout:
+    case OcVoiceOverAudioFileDefault:
+      OcAudioQueuePredecode (OcVoiceOverAudioFileSelected, LanguageCode);
+      break;
+    case OcVoiceOverAudioFileSelected:
+      OcAudioQueuePredecode (OcVoiceOverAudioFileLoading, LanguageCode);
+      break;
+    case OcVoiceOverAudioFileEnterPassword:
+      OcAudioQueuePredecode (OcVoiceOverAudioFilePasswordAccepted, LanguageCode);
+      OcAudioQueuePredecode (OcVoiceOverAudioFilePasswordIncorrect, LanguageCode);
+      break;
+    default:
+      break;
+  }
+}
+
+STATIC
+VOID
+EFIAPI
+OcAudioPredecodeNotify (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  EFI_STATUS                  Status;
+  OC_AUDIO_PREDECODE_REQUEST  Request;
+  OC_AUDIO_PREDECODED_FILE    *Slot;
+  OC_AUDIO_FILE               AudioFile;
+
+  //
+  // Never interfere with a synchronous request, try again later.
+  //
+  if (mAudioAcquireActive) {
+    gBS->SetTimer (mPredecodeEvent, TimerRelative, OC_AUDIO_PREDECODE_DELAY);
+    return;
+  }
+
+  if (mPredecodeQueueCount == 0) {
+    return;
+  }
+
+  CopyMem (&Request, &mPredecodeQueue[0], sizeof (Request));
+  --mPredecodeQueueCount;
+  CopyMem (
+    &mPredecodeQueue[0],
+    &mPredecodeQueue[1],
+    mPredecodeQueueCount * sizeof (mPredecodeQueue[0])
+    );
+
+  Status = OcAudioLoadFile (
+    (OC_STORAGE_CONTEXT *) Context,
+    Request.File,
+    Request.LanguageCode,
+    &AudioFile
+    );
+  DEBUG ((DEBUG_INFO, "OC: Predecoded wave %d - %r\n", Request.File, Status));
+
+  if (!EFI_ERROR (Status)) {
+    //
+    // Replace the oldest predecoded file, it was most likely never played.
+    //
+    Slot = &mPredecodedFiles[mPredecodedFileNext];
+    mPredecodedFileNext = (mPredecodedFileNext + 1) % OC_AUDIO_PREDECODE_MAX_FILES;
+
+    if (Slot->Data.Buffer != NULL) {
+      FreePool (Slot->Data.Buffer);
+    }
+
+    CopyMem (&Slot->Request, &Request, sizeof (Slot->Request));
+    CopyMem (&Slot->Data, &AudioFile, sizeof (Slot->Data));
+  }
+
+  if (mPredecodeQueueCount > 0) {
+    gBS->SetTimer (mPredecodeEvent, TimerRelative, OC_AUDIO_PREDECODE_DELAY);
+  }
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+OcAudioAcquireFile (
+  IN  VOID                            *Context,
+  IN  UINT32                          File,
+  IN  APPLE_VOICE_OVER_LANGUAGE_CODE  LanguageCode,
+  OUT UINT8                           **Buffer,
+  OUT UINT32                          *BufferSize,
+  OUT EFI_AUDIO_IO_PROTOCOL_FREQ      *Frequency,
+  OUT EFI_AUDIO_IO_PROTOCOL_BITS      *Bits,
+  OUT UINT8                           *Channels
+  )
+{
+  EFI_STATUS          Status;
+  OC_STORAGE_CONTEXT  *Storage;
+  OC_AUDIO_FILE       *CacheFile;
+  OC_AUDIO_FILE       AudioFile;
+
+  Storage   = (OC_STORAGE_CONTEXT *) Context;
+  CacheFile = NULL;
+
+  if (File >= OcVoiceOverAudioFileBase && File < OcVoiceOverAudioFileMax) {
+    if (mEnableAudioCaching) {
+      CacheFile = &mOcAudioFiles[File - OcVoiceOverAudioFileBase];
+    }
+  } else if (File < AppleVoiceOverAudioFileMax) {
+    if (mEnableAudioCaching) {
+      CacheFile = &mAppleAudioFiles[File];
+    }
+  } else {
+    DEBUG ((DEBUG_INFO, "OC: Invalid wave index %d\n", File));
+    return EFI_NOT_FOUND;
+  }
+
+  if (CacheFile != NULL && CacheFile->Buffer != NULL) {
+    CopyMem (&AudioFile, CacheFile, sizeof (AudioFile));
+    Status = EFI_SUCCESS;
+  } else {
+    mAudioAcquireActive = TRUE;
+
+    if (OcAudioTakePredecodedFile (File, LanguageCode, &AudioFile)) {
+      Status = EFI_SUCCESS;
+    } else {
+      Status = OcAudioLoadFile (Storage, File, LanguageCode, &AudioFile);
+    }
+
+    if (!EFI_ERROR (Status)) {
+      OcAudioQueueLikelyFiles (File, LanguageCode);
+    }
+
+    mAudioAcquireActive = FALSE;
+
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    if (CacheFile != NULL) {
+      CopyMem (CacheFile, &AudioFile, sizeof (*CacheFile));
+    }
+  }
+
+  *Buffer     = AudioFile.Buffer;
+  *BufferSize = AudioFile.Size;
+  *Frequency  = AudioFile.Frequency;
+  *Bits       = AudioFile.Bits;
+  *Channels   = AudioFile.Channels;
+
   return EFI_SUCCESS;
 }
 
@@ -468,6 +703,57 @@ OcAudioExitBootServices (
   OC_AUDIO_PROTOCOL  *OcAudio;
   OcAudio = Context;
   OcAudio->StopPlayback (OcAudio, TRUE);
+
+  if (mPredecodeEvent != NULL) {
+    gBS->CloseEvent (mPredecodeEvent);
+    mPredecodeEvent = NULL;
+  }
+}
+
+STATIC
+VOID
+OcAudioStartPredecode (
+  IN OC_STORAGE_CONTEXT  *Storage
+  )
+{
+  EFI_STATUS                       Status;
+  APPLE_VOICE_OVER_AUDIO_PROTOCOL  *VoiceOver;
+  UINT8                            LanguageCode;
+  CONST CHAR8                      *LanguageString;
+
+  Status = gBS->CreateEvent (
+    EVT_TIMER | EVT_NOTIFY_SIGNAL,
+    TPL_CALLBACK,
+    OcAudioPredecodeNotify,
+    Storage,
+    &mPredecodeEvent
+    );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_INFO, "OC: Audio predecode event failure - %r\n", Status));
+    mPredecodeEvent = NULL;
+    return;
+  }
+
+  Status = gBS->LocateProtocol (
+    &gAppleVOAudioProtocolGuid,
+    NULL,
+    (VOID **) &VoiceOver
+    );
+  if (!EFI_ERROR (Status)) {
+    Status = VoiceOver->GetLanguage (VoiceOver, &LanguageCode, &LanguageString);
+  }
+
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_INFO, "OC: Audio predecode has no language - %r\n", Status));
+    return;
+  }
+
+  //
+  // The picker always starts with these prompts.
+  //
+  OcAudioQueuePredecode (OcVoiceOverAudioFileChooseOS, (APPLE_VOICE_OVER_LANGUAGE_CODE) LanguageCode);
+  OcAudioQueuePredecode (OcVoiceOverAudioFileIndexBase + 1, (APPLE_VOICE_OVER_LANGUAGE_CODE) LanguageCode);
+  OcAudioQueuePredecode (OcVoiceOverAudioFileDefault, (APPLE_VOICE_OVER_LANGUAGE_CODE) LanguageCode);
 }
 
 VOID
@@ -583,5 +869,9 @@ OcLoadUefiAudioSupport (
     DEBUG ((DEBUG_INFO, "OC: Play chime started - %r\n", Status));
   }
 
+  if (Config->Misc.Boot.PickerAudioAssist) {
+    OcAudioStartPredecode (Storage);
+  }
+
   OcScheduleExitBootServices (OcAudioExitBootServices, OcAudio);
 }
@@ -0,0 +1,219 @@
+/** @file
+  Copyright (C) 2026, agent. All rights reserved.
+
+  All rights reserved.
+
+  This program and the accompanying materials
+  are licensed and made available under the terms and conditions of the BSD License
+  which accompanies this distribution.  The full text of the license may be found at
+  http://opensource.org/licenses/bsd-license.php
+
+  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+**/
+
+#include <Uefi.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/OcGuardLib.h>
+#include <Library/OcMemoryLib.h>
+
+/**
+  Find last interval starting at or below Address.
+
+  @param[in]  Intervals  Free memory intervals.
+  @param[in]  Address    Address to look up.
+
+  @retval Interval index or Intervals->Count when none.
+**/
+STATIC
+UINTN
+FindMemoryInterval (
+  IN CONST OC_MEMORY_INTERVALS  *Intervals,
+  IN EFI_PHYSICAL_ADDRESS       Address
+  )
+{
+  UINTN  Low;
+  UINTN  High;
+  UINTN  Middle;
+
+  Low  = 0;
+  High = Intervals->Count;
+
+  while (Low < High) {
+    Middle = Low + (High - Low) / 2;
+    if (Intervals->Intervals[Middle].Start <= Address) {
+      Low = Middle + 1;
+    } else {
+      High = Middle;
+    }
+  }
+
+  return Low > 0 ? Low - 1 : Intervals->Count;
+}
+
+/**
+  Count free memory below Address.
+
+  @param[in]  Intervals  Free memory intervals.
+  @param[in]  Address    Address to look up.
+
+  @retval Amount of free memory in bytes.
+**/
+STATIC
+UINT64
+CountFreeMemoryBelow (
+  IN CONST OC_MEMORY_INTERVALS  *Intervals,
+  IN EFI_PHYSICAL_ADDRESS       Address
+  )
+{
+  UINTN               Index;
+  OC_MEMORY_INTERVAL  *Interval;
+
+  Index = FindMemoryInterval (Intervals, Address);
+  if (Index == Intervals->Count) {
+    return 0;
+  }
+
+  Interval = &Intervals->Intervals[Index];
+  return Interval->FreeBefore + MIN (Address, Interval->End) - Interval->Start;
+}
+
+EFI_STATUS
+OcMemoryIntervalsInit (
+  OUT OC_MEMORY_INTERVALS    *Intervals,
+  IN  UINTN                  MemoryMapSize,
+  IN  EFI_MEMORY_DESCRIPTOR  *MemoryMap,
+  IN  UINTN                  DescriptorSize
+  )
+{
+  EFI_MEMORY_DESCRIPTOR  *Desc;
+  OC_MEMORY_INTERVAL     *Current;
+  OC_MEMORY_INTERVAL     Temp;
+  UINTN                  NumEntries;
+  UINTN                  Index;
+  UINTN                  Index2;
+  UINTN                  Count;
+  UINT64                 FreeBefore;
+  EFI_PHYSICAL_ADDRESS   End;
+
+  ASSERT (Intervals != NULL);
+  ASSERT (MemoryMap != NULL);
+  ASSERT (DescriptorSize > 0);
+
+  NumEntries = MemoryMapSize / DescriptorSize;
+
+  Intervals->Count     = 0;
+  Intervals->Intervals = AllocatePool (MAX (NumEntries, 1) * sizeof (Intervals->Intervals[0]));
+  if (Intervals->Intervals == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  //
+  // Collect free memory descriptors. The memory map is normally
+  // sorted, so insertion sort stays linear in practice.
+  //
+  Count = 0;
+  Desc  = MemoryMap;
+  for (Index = 0; Index < NumEntries; ++Index) {
+    if (Desc->Type == EfiConventionalMemory
+      && Desc->NumberOfPages > 0
+      && Desc->NumberOfPages <= RShiftU64 (MAX_UINT64, EFI_PAGE_SHIFT)
+      && !OcOverflowAddU64 (Desc->PhysicalStart, EFI_PAGES_TO_SIZE (Desc->NumberOfPages), &End)) {
+      Temp.Start = Desc->PhysicalStart;
+      Temp.End   = End;
+
+      Index2 = Count;
+      while (Index2 > 0 && Intervals->Intervals[Index2 - 1].Start > Temp.Start) {
+        Intervals->Intervals[Index2] = Intervals->Intervals[Index2 - 1];
+        --Index2;
+      }
+      Intervals->Intervals[Index2] = Temp;
+      ++Count;
+    }
+
+    Desc = NEXT_MEMORY_DESCRIPTOR (Desc, DescriptorSize);
+  }
+
+  //
+  // Merge adjacent and overlapping intervals and calculate prefix sums.
+  //
+  Current    = NULL;
+  FreeBefore = 0;
+  for (Index = 0; Index < Count; ++Index) {
+    if (Current != NULL && Intervals->Intervals[Index].Start <= Current->End) {
+      Current->End = MAX (Current->End, Intervals->Intervals[Index].End);
+      continue;
+    }
+
+    if (Current != NULL) {
+      FreeBefore += Current->End - Current->Start;
+      ++Current;
+    } else {
+      Current = &Intervals->Intervals[0];
+    }
+
+    Current->Start      = Intervals->Intervals[Index].Start;
+    Current->End        = Intervals->Intervals[Index].End;
+    Current->FreeBefore = FreeBefore;
+  }
+
+  if (Current != NULL) {
+    Intervals->Count = (UINTN) (Current - Intervals->Intervals) + 1;
+  }
+
+  return EFI_SUCCESS;
+}
+
+VOID
+OcMemoryIntervalsFree (
+  IN OUT OC_MEMORY_INTERVALS  *Intervals
+  )
+{
+  ASSERT (Intervals != NULL);
+
+  if (Intervals->Intervals != NULL) {
+    FreePool (Intervals->Intervals);
+  }
+
+  Intervals->Intervals = NULL;
+  Intervals->Count     = 0;
+}
+
+BOOLEAN
+OcMemoryIntervalsIsFree (
+  IN CONST OC_MEMORY_INTERVALS  *Intervals,
+  IN EFI_PHYSICAL_ADDRESS       Start,
+  IN EFI_PHYSICAL_ADDRESS       End
+  )
+{
+  UINTN  Index;
+
+  ASSERT (Intervals != NULL);
+
+  if (Start >= End) {
+    return TRUE;
+  }
+
+  Index = FindMemoryInterval (Intervals, Start);
+  return Index < Intervals->Count && End <= Intervals->Intervals[Index].End;
+}
+
+UINT64
+OcMemoryIntervalsFreeSize (
+  IN CONST OC_MEMORY_INTERVALS  *Intervals,
+  IN EFI_PHYSICAL_ADDRESS       Start,
+  IN EFI_PHYSICAL_ADDRESS       End
+  )
+{
+  ASSERT (Intervals != NULL);
+
+  if (Start >= End) {
+    return 0;
+  }
+
+  return CountFreeMemoryBelow (Intervals, End) - CountFreeMemoryBelow (Intervals, Start);
+}
@@ -58,9 +58,17 @@
 
 #include <Library/BaseLib.h>
 
+typedef INT64 Word64;
+
+/*
+ * 32x32->64 products are written in plain C rather than via BaseLib MultS64x64
+ * and RShiftU64. Both IA32 and X64 compilers emit a single widening imul for
+ * them and can schedule the surrounding code, while BaseLib calls are opaque
+ * out-of-line function calls in the hottest loops of the decoder.
+ */
 static __inline int MULSHIFT32(int x, int y)	
 {
-	return (INT32) (RShiftU64 (MultS64x64 (x, y), 32));
+	return (int) (((Word64) x * y) >> 32);
 }
 
 static __inline int FASTABS(int x) 
@@ -90,22 +98,20 @@ static __inline int CLZ(int x)
 	return numZeros;
 }
 
-typedef INT64 Word64;
-
 static __inline Word64 MADD64(Word64 sum, int x, int y)
 {
-	sum += MultS64x64 (x, y);
+	sum += (Word64) x * y;
 	return sum;
 }
 
 static __inline Word64 SHL64(Word64 x, int n)
 {
-	return (Word64)LShiftU64 (x, n);
+	return (Word64) ((UINT64) x << n);
 }
 
 static __inline Word64 SAR64(Word64 x, int n)
 {
-	return (Word64)RShiftU64 (x, n);
+	return x >> n;
 }
 
 #endif /* _ASSEMBLY_H */
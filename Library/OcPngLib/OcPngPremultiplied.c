@@ -0,0 +1,523 @@
+/** @file
+  Copyright (C) 2026, agent. All rights reserved.
+
+  All rights reserved.
+
+  This program and the accompanying materials
+  are licensed and made available under the terms and conditions of the BSD License
+  which accompanies this distribution.  The full text of the license may be found at
+  http://opensource.org/licenses/bsd-license.php
+
+  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+**/
+
+#include <Uefi.h>
+
+#include <Protocol/GraphicsOutput.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/OcCompressionLib.h>
+#include <Library/OcGuardLib.h>
+#include <Library/OcPngLib.h>
+
+#define PNG_SIGNATURE_SIZE     8U
+#define PNG_CHUNK_HEADER_SIZE  8U
+#define PNG_CHUNK_CRC_SIZE     4U
+#define PNG_IHDR_SIZE          13U
+
+#define PNG_CHUNK_IHDR  SIGNATURE_32 ('I', 'H', 'D', 'R')
+#define PNG_CHUNK_IDAT  SIGNATURE_32 ('I', 'D', 'A', 'T')
+#define PNG_CHUNK_IEND  SIGNATURE_32 ('I', 'E', 'N', 'D')
+#define PNG_CHUNK_TRNS  SIGNATURE_32 ('t', 'R', 'N', 'S')
+
+#define PNG_COLOR_TYPE_RGB   2U
+#define PNG_COLOR_TYPE_RGBA  6U
+
+#define PNG_FILTER_NONE   0U
+#define PNG_FILTER_SUB    1U
+#define PNG_FILTER_UP     2U
+#define PNG_FILTER_AVG    3U
+#define PNG_FILTER_PAETH  4U
+
+STATIC CONST UINT8 mPngSignature[PNG_SIGNATURE_SIZE] = {
+  0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'
+};
+
+/**
+  Simple PNG image description for the fast decoding path.
+**/
+typedef struct {
+  UINT32       Width;
+  UINT32       Height;
+  UINT32       Bpp;
+  CONST UINT8  *Data;
+  UINTN        DataSize;
+  UINT8        *DataCopy;
+} OC_PNG_FAST_IMAGE;
+
+STATIC
+UINT32
+PngReadBe32 (
+  IN CONST UINT8  *Buffer
+  )
+{
+  return SwapBytes32 (ReadUnaligned32 ((CONST UINT32 *) Buffer));
+}
+
+/**
+  Parse PNG chunks and collect compressed image data.
+
+  @param[in]  Buffer  PNG image.
+  @param[in]  Size    PNG image size.
+  @param[out] Image   Image description.
+
+  @retval EFI_SUCCESS           Image can be decoded with the fast path.
+  @retval EFI_UNSUPPORTED       Image must be decoded with lodepng.
+  @retval EFI_OUT_OF_RESOURCES  Memory allocation failure.
+**/
+STATIC
+EFI_STATUS
+PngParseFastImage (
+  IN  CONST UINT8        *Buffer,
+  IN  UINTN              Size,
+  OUT OC_PNG_FAST_IMAGE  *Image
+  )
+{
+  UINTN        Offset;
+  UINT32       ChunkSize;
+  UINT32       ChunkType;
+  CONST UINT8  *ChunkData;
+  CONST UINT8  *FirstIdat;
+  UINTN        IdatCount;
+  UINTN        IdatSize;
+  BOOLEAN      HasEnd;
+
+  ZeroMem (Image, sizeof (*Image));
+
+  if (Size < PNG_SIGNATURE_SIZE + PNG_CHUNK_HEADER_SIZE + PNG_IHDR_SIZE + PNG_CHUNK_CRC_SIZE
+    || CompareMem (Buffer, mPngSignature, sizeof (mPngSignature)) != 0) {
+    return EFI_UNSUPPORTED;
+  }
+
+  //
+  // Collect IDAT chunks in the first pass, most images have only one.
+  //
+  Offset    = PNG_SIGNATURE_SIZE;
+  FirstIdat = NULL;
+  IdatCount = 0;
+  IdatSize  = 0;
+  HasEnd    = FALSE;
+
+  while (!HasEnd && Size - Offset >= PNG_CHUNK_HEADER_SIZE + PNG_CHUNK_CRC_SIZE) {
+    ChunkSize = PngReadBe32 (&Buffer[Offset]);
+    ChunkType = ReadUnaligned32 ((CONST UINT32 *) &Buffer[Offset + 4]);
+    ChunkData = &Buffer[Offset + PNG_CHUNK_HEADER_SIZE];
+
+    if (ChunkSize > Size - Offset - PNG_CHUNK_HEADER_SIZE - PNG_CHUNK_CRC_SIZE) {
+      return EFI_UNSUPPORTED;
+    }
+
+    if (Offset == PNG_SIGNATURE_SIZE) {
+      //
+      // Only non-interlaced 8-bit RGB and RGBA images are supported.
+      //
+      if (ChunkType != PNG_CHUNK_IHDR
+        || ChunkSize != PNG_IHDR_SIZE
+        || ChunkData[8] != 8
+        || (ChunkData[9] != PNG_COLOR_TYPE_RGB && ChunkData[9] != PNG_COLOR_TYPE_RGBA)
+        || ChunkData[10] != 0
+        || ChunkData[11] != 0
+        || ChunkData[12] != 0) {
+        return EFI_UNSUPPORTED;
+      }
+
+      Image->Width  = PngReadBe32 (&ChunkData[0]);
+      Image->Height = PngReadBe32 (&ChunkData[4]);
+      Image->Bpp    = ChunkData[9] == PNG_COLOR_TYPE_RGBA ? 4 : 3;
+    } else if (ChunkType == PNG_CHUNK_IDAT) {
+      if (FirstIdat == NULL) {
+        FirstIdat = ChunkData;
+      }
+
+      ++IdatCount;
+      IdatSize += ChunkSize;
+    } else if (ChunkType == PNG_CHUNK_TRNS) {
+      //
+      // Colour key transparency is left to lodepng.
+      //
+      return EFI_UNSUPPORTED;
+    } else if (ChunkType == PNG_CHUNK_IEND) {
+      HasEnd = TRUE;
+    }
+
+    Offset += PNG_CHUNK_HEADER_SIZE + ChunkSize + PNG_CHUNK_CRC_SIZE;
+  }
+
+  if (!HasEnd || IdatCount == 0 || Image->Width == 0 || Image->Height == 0) {
+    return EFI_UNSUPPORTED;
+  }
+
+  if (IdatCount == 1) {
+    Image->Data     = FirstIdat;
+    Image->DataSize = IdatSize;
+    return EFI_SUCCESS;
+  }
+
+  Image->DataCopy = AllocatePool (IdatSize);
+  if (Image->DataCopy == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Image->Data     = Image->DataCopy;
+  Image->DataSize = IdatSize;
+
+  Offset   = PNG_SIGNATURE_SIZE;
+  IdatSize = 0;
+  do {
+    ChunkSize = PngReadBe32 (&Buffer[Offset]);
+    ChunkType = ReadUnaligned32 ((CONST UINT32 *) &Buffer[Offset + 4]);
+
+    if (ChunkType == PNG_CHUNK_IDAT) {
+      CopyMem (&Image->DataCopy[IdatSize], &Buffer[Offset + PNG_CHUNK_HEADER_SIZE], ChunkSize);
+      IdatSize += ChunkSize;
+    }
+
+    Offset += PNG_CHUNK_HEADER_SIZE + ChunkSize + PNG_CHUNK_CRC_SIZE;
+  } while (ChunkType != PNG_CHUNK_IEND);
+
+  return EFI_SUCCESS;
+}
+
+STATIC
+UINT8
+PngPaethPredictor (
+  IN UINT8  Left,
+  IN UINT8  Above,
+  IN UINT8  UpperLeft
+  )
+{
+  INT32  Pa;
+  INT32  Pb;
+  INT32  Pc;
+
+  Pa = (INT32) Above - UpperLeft;
+  Pb = (INT32) Left - UpperLeft;
+  Pc = Pa + Pb;
+
+  if (Pa < 0) {
+    Pa = -Pa;
+  }
+  if (Pb < 0) {
+    Pb = -Pb;
+  }
+  if (Pc < 0) {
+    Pc = -Pc;
+  }
+
+  if (Pa <= Pb && Pa <= Pc) {
+    return Left;
+  }
+
+  if (Pb <= Pc) {
+    return Above;
+  }
+
+  return UpperLeft;
+}
+
+/**
+  Reverse scanline filter in place.
+
+  @param[in]     Filter    Filter type.
+  @param[in,out] Row       Filtered scanline without filter type byte.
+  @param[in]     Previous  Previous unfiltered scanline, optional.
+  @param[in]     Length    Scanline length in bytes.
+  @param[in]     Bpp       Bytes per pixel.
+
+  @retval TRUE on success.
+**/
+STATIC
+BOOLEAN
+PngUnfilterRow (
+  IN     UINT8        Filter,
+  IN OUT UINT8        *Row,
+  IN     CONST UINT8  *Previous  OPTIONAL,
+  IN     UINTN        Length,
+  IN     UINT32       Bpp
+  )
+{
+  UINTN   Index;
+  UINT64  Value;
+  UINT64  Above;
+
+  switch (Filter) {
+    case PNG_FILTER_NONE:
+      return TRUE;
+
+    case PNG_FILTER_SUB:
+      for (Index = Bpp; Index < Length; ++Index) {
+        Row[Index] = (UINT8) (Row[Index] + Row[Index - Bpp]);
+      }
+      return TRUE;
+
+    case PNG_FILTER_UP:
+      if (Previous == NULL) {
+        return TRUE;
+      }
+
+      //
+      // Add 8 bytes at once without carries crossing byte boundaries.
+      //
+      for (Index = 0; Index + sizeof (UINT64) <= Length; Index += sizeof (UINT64)) {
+        Value = ReadUnaligned64 ((CONST UINT64 *) &Row[Index]);
+        Above = ReadUnaligned64 ((CONST UINT64 *) &Previous[Index]);
+        Value = ((Value & 0x7F7F7F7F7F7F7F7FULL) + (Above & 0x7F7F7F7F7F7F7F7FULL))
+          ^ ((Value ^ Above) & 0x8080808080808080ULL);
+        WriteUnaligned64 ((UINT64 *) &Row[Index], Value);
+      }
+
+      for (; Index < Length; ++Index) {
+        Row[Index] = (UINT8) (Row[Index] + Previous[Index]);
+      }
+      return TRUE;
+
+    case PNG_FILTER_AVG:
+      if (Previous == NULL) {
+        for (Index = Bpp; Index < Length; ++Index) {
+          Row[Index] = (UINT8) (Row[Index] + (Row[Index - Bpp] >> 1U));
+        }
+        return TRUE;
+      }
+
+      for (Index = 0; Index < Bpp; ++Index) {
+        Row[Index] = (UINT8) (Row[Index] + (Previous[Index] >> 1U));
+      }
+      for (; Index < Length; ++Index) {
+        Row[Index] = (UINT8) (Row[Index] + ((Row[Index - Bpp] + Previous[Index]) >> 1U));
+      }
+      return TRUE;
+
+    case PNG_FILTER_PAETH:
+      if (Previous == NULL) {
+        //
+        // Paeth predictor degrades to Sub for the first scanline.
+        //
+        for (Index = Bpp; Index < Length; ++Index) {
+          Row[Index] = (UINT8) (Row[Index] + Row[Index - Bpp]);
+        }
+        return TRUE;
+      }
+
+      for (Index = 0; Index < Bpp; ++Index) {
+        Row[Index] = (UINT8) (Row[Index] + Previous[Index]);
+      }
+      for (; Index < Length; ++Index) {
+        Row[Index] = (UINT8) (Row[Index] + PngPaethPredictor (
+          Row[Index - Bpp],
+          Previous[Index],
+          Previous[Index - Bpp]
+          ));
+      }
+      return TRUE;
+
+    default:
+      return FALSE;
+  }
+}
+
+/**
+  Multiply colour by alpha, exactly matching (Color * Alpha) / 255.
+**/
+STATIC
+UINT8
+PngMultiplyAlpha (
+  IN UINT32  Color,
+  IN UINT32  Alpha
+  )
+{
+  UINT32  Value;
+
+  Value = Color * Alpha;
+  return (UINT8) ((Value + 1 + (Value >> 8U)) >> 8U);
+}
+
+/**
+  Convert unfiltered RGB or RGBA scanline to premultiplied BGRA pixels.
+**/
+STATIC
+VOID
+PngConvertRow (
+  IN  CONST UINT8                    *Row,
+  IN  UINT32                         Width,
+  IN  UINT32                         Bpp,
+  OUT EFI_GRAPHICS_OUTPUT_BLT_PIXEL  *Pixels
+  )
+{
+  UINT32  Index;
+  UINT8   Alpha;
+
+  if (Bpp == 3) {
+    for (Index = 0; Index < Width; ++Index, Row += 3) {
+      Pixels[Index].Blue     = Row[2];
+      Pixels[Index].Green    = Row[1];
+      Pixels[Index].Red      = Row[0];
+      Pixels[Index].Reserved = 0xFF;
+    }
+    return;
+  }
+
+  for (Index = 0; Index < Width; ++Index, Row += 4) {
+    Alpha = Row[3];
+    if (Alpha == 0xFF) {
+      Pixels[Index].Blue  = Row[2];
+      Pixels[Index].Green = Row[1];
+      Pixels[Index].Red   = Row[0];
+    } else if (Alpha == 0) {
+      Pixels[Index].Blue  = 0;
+      Pixels[Index].Green = 0;
+      Pixels[Index].Red   = 0;
+    } else {
+      Pixels[Index].Blue  = PngMultiplyAlpha (Row[2], Alpha);
+      Pixels[Index].Green = PngMultiplyAlpha (Row[1], Alpha);
+      Pixels[Index].Red   = PngMultiplyAlpha (Row[0], Alpha);
+    }
+    Pixels[Index].Reserved = Alpha;
+  }
+}
+
+/**
+  Decode simple PNG images without lodepng.
+
+  @retval EFI_SUCCESS           Image was decoded.
+  @retval EFI_UNSUPPORTED       Image must be decoded with lodepng.
+  @retval EFI_OUT_OF_RESOURCES  Memory allocation failure.
+**/
+STATIC
+EFI_STATUS
+PngDecodeFast (
+  IN  CONST UINT8                    *Buffer,
+  IN  UINTN                          Size,
+  OUT EFI_GRAPHICS_OUTPUT_BLT_PIXEL  **RawData,
+  OUT UINT32                         *Width,
+  OUT UINT32                         *Height
+  )
+{
+  EFI_STATUS                     Status;
+  OC_PNG_FAST_IMAGE              Image;
+  UINTN                          RowSize;
+  UINTN                          ScanlinesSize;
+  UINTN                          PixelsSize;
+  UINT8                          *Scanlines;
+  UINT8                          *Row;
+  CONST UINT8                    *Previous;
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL  *Pixels;
+  UINT32                         Index;
+
+  Status = PngParseFastImage (Buffer, Size, &Image);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Scanlines = NULL;
+  Pixels    = NULL;
+
+  if (OcOverflowMulUN (Image.Width, Image.Bpp, &RowSize)
+    || OcOverflowMulUN (RowSize + 1, Image.Height, &ScanlinesSize)
+    || OcOverflowTriMulUN (Image.Width, Image.Height, sizeof (*Pixels), &PixelsSize)) {
+    Status = EFI_UNSUPPORTED;
+  } else {
+    Scanlines = AllocatePool (ScanlinesSize);
+    Pixels    = AllocatePool (PixelsSize);
+  }
+
+  if (EFI_ERROR (Status)) {
+    //
+    // Dimensions are unsupported.
+    //
+  } else if (Scanlines == NULL || Pixels == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
+  } else if (DecompressZLIB (Scanlines, ScanlinesSize, Image.Data, Image.DataSize) != ScanlinesSize) {
+    Status = EFI_UNSUPPORTED;
+  }
+
+  if (Image.DataCopy != NULL) {
+    FreePool (Image.DataCopy);
+  }
+
+  //
+  // Unfilter each scanline and convert it while it is still in cache.
+  //
+  Previous = NULL;
+  Row      = Scanlines;
+  for (Index = 0; !EFI_ERROR (Status) && Index < Image.Height; ++Index) {
+    if (!PngUnfilterRow (Row[0], Row + 1, Previous, RowSize, Image.Bpp)) {
+      Status = EFI_UNSUPPORTED;
+      break;
+    }
+
+    PngConvertRow (Row + 1, Image.Width, Image.Bpp, &Pixels[(UINTN) Index * Image.Width]);
+
+    Previous = Row + 1;
+    Row     += RowSize + 1;
+  }
+
+  if (Scanlines != NULL) {
+    FreePool (Scanlines);
+  }
+
+  if (EFI_ERROR (Status)) {
+    if (Pixels != NULL) {
+      FreePool (Pixels);
+    }
+    return Status;
+  }
+
+  *RawData = Pixels;
+  *Width   = Image.Width;
+  *Height  = Image.Height;
+  return EFI_SUCCESS;
+}
+
+EFI_STATUS
+OcDecodePngPremultiplied (
+  IN   VOID    *Buffer,
+  IN   UINTN   Size,
+  OUT  VOID    **RawData,
+  OUT  UINT32  *Width,
+  OUT  UINT32  *Height
+  )
+{
+  EFI_STATUS                     Status;
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL  *Pixels;
+  UINTN                          Index;
+  UINT8                          Red;
+
+  ASSERT (Buffer != NULL);
+  ASSERT (RawData != NULL);
+  ASSERT (Width != NULL);
+  ASSERT (Height != NULL);
+
+  Status = PngDecodeFast (Buffer, Size, (EFI_GRAPHICS_OUTPUT_BLT_PIXEL **) RawData, Width, Height);
+  if (Status != EFI_UNSUPPORTED) {
+    return Status;
+  }
+
+  Status = OcDecodePng (Buffer, Size, RawData, Width, Height, NULL);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Pixels = *RawData;
+  for (Index = 0; Index < (UINTN) *Width * *Height; ++Index) {
+    Red                 = Pixels[Index].Blue;
+    Pixels[Index].Blue  = PngMultiplyAlpha (Pixels[Index].Red, Pixels[Index].Reserved);
+    Pixels[Index].Green = PngMultiplyAlpha (Pixels[Index].Green, Pixels[Index].Reserved);
+    Pixels[Index].Red   = PngMultiplyAlpha (Red, Pixels[Index].Reserved);
+  }
+
+  return EFI_SUCCESS;
+}
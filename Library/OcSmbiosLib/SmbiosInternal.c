@@ -557,3 +557,132 @@ SmbiosGetStructureCount (
 
   return Count;
 }
+
+EFI_STATUS
+SmbiosBuildStructureIndex (
+  IN  APPLE_SMBIOS_STRUCTURE_POINTER  SmbiosTable,
+  IN  UINT32                          SmbiosTableSize,
+  OUT OC_SMBIOS_STRUCTURE_INDEX       *Index
+  )
+{
+  APPLE_SMBIOS_STRUCTURE_POINTER  Walker;
+  UINT32                          Remaining;
+  UINT32                          Length;
+  UINT32                          Count;
+  UINT32                          Type;
+  UINT32                          Cursor[MAX_UINT8 + 1];
+
+  ZeroMem (Index, sizeof (*Index));
+
+  //
+  // Count structures of each type first, so that they can be grouped without resorting.
+  //
+  Count     = 0;
+  Walker    = SmbiosTable;
+  Remaining = SmbiosTableSize;
+  while (Remaining >= sizeof (SMBIOS_STRUCTURE)) {
+    Length = SmbiosGetStructureLength (Walker, Remaining);
+    if (Length == 0) {
+      break;
+    }
+
+    ++Index->TypeStart[Walker.Standard.Hdr->Type + 1];
+    ++Count;
+
+    if (Walker.Standard.Hdr->Type == SMBIOS_TYPE_END_OF_TABLE) {
+      break;
+    }
+
+    Walker.Raw += Length;
+    Remaining  -= Length;
+  }
+
+  if (Count == 0) {
+    return EFI_NOT_FOUND;
+  }
+
+  Index->Entries = AllocatePool (Count * sizeof (*Index->Entries));
+  if (Index->Entries == NULL) {
+    ZeroMem (Index, sizeof (*Index));
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  for (Type = 0; Type <= MAX_UINT8; ++Type) {
+    Index->TypeStart[Type + 1] += Index->TypeStart[Type];
+    Cursor[Type]                = Index->TypeStart[Type];
+  }
+
+  //
+  // Walk again with the same rules, lengths are already known to be valid.
+  //
+  Walker    = SmbiosTable;
+  Remaining = SmbiosTableSize;
+  while (Count > 0) {
+    Length = SmbiosGetStructureLength (Walker, Remaining);
+    Type   = Walker.Standard.Hdr->Type;
+
+    Index->Entries[Cursor[Type]].Offset = (UINT32) (Walker.Raw - SmbiosTable.Raw);
+    Index->Entries[Cursor[Type]].Length = Length;
+    ++Cursor[Type];
+
+    Walker.Raw += Length;
+    Remaining  -= Length;
+    --Count;
+  }
+
+  return EFI_SUCCESS;
+}
+
+VOID
+SmbiosFreeStructureIndex (
+  IN OUT OC_SMBIOS_STRUCTURE_INDEX  *Index
+  )
+{
+  if (Index->Entries != NULL) {
+    FreePool (Index->Entries);
+  }
+
+  ZeroMem (Index, sizeof (*Index));
+}
+
+APPLE_SMBIOS_STRUCTURE_POINTER
+SmbiosGetIndexedStructureOfType (
+  IN  APPLE_SMBIOS_STRUCTURE_POINTER  SmbiosTable,
+  IN  CONST OC_SMBIOS_STRUCTURE_INDEX *Index,
+  IN  SMBIOS_TYPE                     Type,
+  IN  UINT16                          TypeIndex
+  )
+{
+  UINT32  EntryIndex;
+
+  ASSERT (Index->Entries != NULL);
+
+  EntryIndex = Index->TypeStart[Type] + TypeIndex - 1;
+  if (TypeIndex == 0 || EntryIndex >= Index->TypeStart[Type + 1]) {
+    SmbiosTable.Raw = NULL;
+    return SmbiosTable;
+  }
+
+  SmbiosTable.Raw += Index->Entries[EntryIndex].Offset;
+  return SmbiosTable;
+}
+
+UINT16
+SmbiosGetIndexedStructureCount (
+  IN  CONST OC_SMBIOS_STRUCTURE_INDEX *Index,
+  IN  SMBIOS_TYPE                     Type
+  )
+{
+  UINT32  Count;
+
+  Count = Index->TypeStart[Type + 1] - Index->TypeStart[Type];
+
+  //
+  // Match SmbiosGetStructureCount, which treats more than MAX_UINT16 tables of this kind as invalid.
+  //
+  if (Count > MAX_UINT16) {
+    return 0;
+  }
+
+  return (UINT16) Count;
+}
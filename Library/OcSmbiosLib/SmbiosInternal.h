@@ -108,6 +108,34 @@ typedef struct OC_SMBIOS_MAPPING_ {
   SMBIOS_HANDLE  New;
 } OC_SMBIOS_MAPPING;
 
+//
+// Location of a single structure within the original table.
+//
+typedef struct OC_SMBIOS_STRUCTURE_INDEX_ENTRY_ {
+  //
+  // Structure offset from the table start.
+  //
+  UINT32  Offset;
+  //
+  // Structure length including the string set.
+  //
+  UINT32  Length;
+} OC_SMBIOS_STRUCTURE_INDEX_ENTRY;
+
+//
+// Original table structures grouped by type in table order.
+//
+typedef struct OC_SMBIOS_STRUCTURE_INDEX_ {
+  //
+  // Structure locations, NULL when the index is not built.
+  //
+  OC_SMBIOS_STRUCTURE_INDEX_ENTRY  *Entries;
+  //
+  // First entry of each type, entries of Type end at TypeStart[Type + 1].
+  //
+  UINT32                           TypeStart[MAX_UINT8 + 2];
+} OC_SMBIOS_STRUCTURE_INDEX;
+
 /**
   Allocate bytes in SMBIOS table if necessary
 
@@ -248,4 +276,63 @@ SmbiosGetStructureCount (
   IN  SMBIOS_TYPE                     Type
   );
 
+/**
+  Build structure index of SMBIOS table, following the same rules as
+  SmbiosGetStructureOfType for walking.
+
+  @param[in]  SmbiosTable      Pointer to SMBIOS table.
+  @param[in]  SmbiosTableSize  SMBIOS table size
+  @param[out] Index            Structure index to fill.
+
+  @retval EFI_SUCCESS on success.
+**/
+EFI_STATUS
+SmbiosBuildStructureIndex (
+  IN  APPLE_SMBIOS_STRUCTURE_POINTER  SmbiosTable,
+  IN  UINT32                          SmbiosTableSize,
+  OUT OC_SMBIOS_STRUCTURE_INDEX       *Index
+  );
+
+/**
+  Free structure index built by SmbiosBuildStructureIndex.
+
+  @param[in,out] Index  Structure index.
+**/
+VOID
+SmbiosFreeStructureIndex (
+  IN OUT OC_SMBIOS_STRUCTURE_INDEX  *Index
+  );
+
+/**
+  Obtain Nth structure of specified type through structure index.
+
+  @param[in] SmbiosTable      Pointer to indexed SMBIOS table.
+  @param[in] Index            Structure index.
+  @param[in] Type             SMBIOS table type
+  @param[in] TypeIndex        SMBIOS table index starting from 1
+
+  @retval found table or NULL
+**/
+APPLE_SMBIOS_STRUCTURE_POINTER
+SmbiosGetIndexedStructureOfType (
+  IN  APPLE_SMBIOS_STRUCTURE_POINTER  SmbiosTable,
+  IN  CONST OC_SMBIOS_STRUCTURE_INDEX *Index,
+  IN  SMBIOS_TYPE                     Type,
+  IN  UINT16                          TypeIndex
+  );
+
+/**
+  Obtain structure count of specified type through structure index.
+
+  @param[in] Index            Structure index.
+  @param[in] Type             SMBIOS table type
+
+  @retval structure count or 0
+**/
+UINT16
+SmbiosGetIndexedStructureCount (
+  IN  CONST OC_SMBIOS_STRUCTURE_INDEX *Index,
+  IN  SMBIOS_TYPE                     Type
+  );
+
 #endif // SMBIOS_INTERNAL_H
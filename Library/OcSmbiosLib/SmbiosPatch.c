@@ -46,6 +46,7 @@ STATIC SMBIOS_TABLE_ENTRY_POINT        *mOriginalSmbios;
 STATIC SMBIOS_TABLE_3_0_ENTRY_POINT    *mOriginalSmbios3;
 STATIC APPLE_SMBIOS_STRUCTURE_POINTER  mOriginalTable;
 STATIC UINT32                          mOriginalTableSize;
+STATIC OC_SMBIOS_STRUCTURE_INDEX       mOriginalIndex;
 
 #define SMBIOS_OVERRIDE_S(Table, Field, Original, Value, Index, Fallback) \
   do { \
@@ -89,6 +90,10 @@ SmbiosGetOriginalStructure (
     return mOriginalTable;
   }
 
+  if (mOriginalIndex.Entries != NULL) {
+    return SmbiosGetIndexedStructureOfType (mOriginalTable, &mOriginalIndex, Type, Index);
+  }
+
   return SmbiosGetStructureOfType (mOriginalTable, mOriginalTableSize, Type, Index);
 }
 
@@ -102,6 +107,10 @@ SmbiosGetOriginalStructureCount (
     return 0;
   }
 
+  if (mOriginalIndex.Entries != NULL) {
+    return SmbiosGetIndexedStructureCount (&mOriginalIndex, Type);
+  }
+
   return SmbiosGetStructureCount (mOriginalTable, mOriginalTableSize, Type);
 }
 
@@ -1403,6 +1412,7 @@ OcSmbiosTablePrepare (
   mOriginalSmbios3   = NULL;
   mOriginalTableSize = 0;
   mOriginalTable.Raw = NULL;
+  SmbiosFreeStructureIndex (&mOriginalIndex);
   ZeroMem (SmbiosTable, sizeof (*SmbiosTable));
   SmbiosTable->Handle = OcSmbiosAutomaticHandle;
 
@@ -1497,6 +1507,15 @@ OcSmbiosTablePrepare (
       ));
   }
 
+  //
+  // Patching looks up original structures by type many times (e.g. per memory slot),
+  // so walk the original table only once here. Lookups fall back to walking on failure.
+  //
+  if (mOriginalTable.Raw != NULL) {
+    Status = SmbiosBuildStructureIndex (mOriginalTable, mOriginalTableSize, &mOriginalIndex);
+    DEBUG ((DEBUG_VERBOSE, "OCSMB: Original table index - %r\n", Status));
+  }
+
   Status = SmbiosExtendTable (SmbiosTable, 1);
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_VERBOSE, "OCSMB: SmbiosLookupHost failed to initialise smbios table - %r\n", Status));
@@ -1515,6 +1534,7 @@ OcSmbiosTableFree (
     FreePool (Table->Table);
   }
 
+  SmbiosFreeStructureIndex (&mOriginalIndex);
   ZeroMem (Table, sizeof (*Table));
 }
 
@@ -271,6 +271,142 @@ LoadLabelFromStorage (
   return Status;
 }
 
+STATIC
+EFI_STATUS
+InternalLoadIcon (
+  IN OUT BOOT_PICKER_GUI_CONTEXT  *Context,
+  IN     UINT32                   Index
+  )
+{
+  EFI_STATUS  Status;
+  UINT32      ImageWidth;
+  UINT32      ImageHeight;
+  BOOLEAN     AllowLessSize;
+
+  ASSERT (Context != NULL);
+  ASSERT (Index < ICON_NUM_TOTAL);
+  ASSERT (!Context->IconsProbed[Index]);
+
+  Context->IconsProbed[Index] = TRUE;
+
+  AllowLessSize = FALSE;
+  if (Index == ICON_CURSOR) {
+    ImageWidth  = MAX_CURSOR_DIMENSION;
+    ImageHeight = MAX_CURSOR_DIMENSION;
+    AllowLessSize = TRUE;
+  } else if (Index == ICON_SELECTED) {
+    ImageWidth  = BOOT_SELECTOR_BACKGROUND_DIMENSION;
+    ImageHeight = BOOT_SELECTOR_BACKGROUND_DIMENSION;
+  } else if (Index == ICON_SELECTOR) {
+    ImageWidth  = BOOT_SELECTOR_BUTTON_WIDTH;
+    ImageHeight = BOOT_SELECTOR_BUTTON_HEIGHT;
+    AllowLessSize = TRUE;
+  } else if (Index == ICON_LEFT || Index == ICON_RIGHT) {
+    ImageWidth  = BOOT_SCROLL_BUTTON_DIMENSION;
+    ImageHeight = BOOT_SCROLL_BUTTON_DIMENSION;
+  } else if (Index == ICON_SHUT_DOWN || Index == ICON_RESTART) {
+    ImageWidth  = BOOT_ACTION_BUTTON_DIMENSION;
+    ImageHeight = BOOT_ACTION_BUTTON_DIMENSION;
+    AllowLessSize = TRUE;
+  } else {
+    ImageWidth  = BOOT_ENTRY_ICON_DIMENSION;
+    ImageHeight = BOOT_ENTRY_ICON_DIMENSION;
+  }
+
+  Status = LoadImageFileFromStorage (
+    Context->Icons[Index],
+    Context->Storage,
+    mIconNames[Index],
+    Context->Scale,
+    ImageWidth,
+    ImageHeight,
+    Index >= ICON_NUM_SYS,
+    Context->Prefix,
+    AllowLessSize
+    );
+  if (!EFI_ERROR (Status)) {
+    if (Index == ICON_SELECTOR || Index == ICON_LEFT || Index == ICON_RIGHT || Index == ICON_SHUT_DOWN || Index == ICON_RESTART) {
+      Status = GuiCreateHighlightedImage (
+        &Context->Icons[Index][ICON_TYPE_HELD],
+        &Context->Icons[Index][ICON_TYPE_BASE],
+        &mHighlightPixel
+        );
+    } else if (Index == ICON_GENERIC_HDD
+            && Context->Icons[Index][ICON_TYPE_EXTERNAL].Buffer == NULL) {
+      //
+      // For generic disk icon being able to distinguish internal and external
+      // disk icons is a security requirement. These icons are used whenever
+      // 'typed' external icons are not available.
+      //
+      Status = EFI_NOT_FOUND;
+      DEBUG ((DEBUG_WARN, "OCUI: Missing external disk icon\n"));
+      STATIC_ASSERT (
+        ICON_GENERIC_HDD < ICON_NUM_MANDATORY,
+        "The base icon should must be cleaned up explicitly."
+        );
+    }
+  } else {
+    ZeroMem (&Context->Icons[Index], sizeof (Context->Icons[Index]));
+  }
+
+  return Status;
+}
+
+CONST GUI_IMAGE *
+InternalGetIconImage (
+  IN OUT BOOT_PICKER_GUI_CONTEXT  *Context,
+  IN     UINT32                   Index,
+  IN     UINT32                   Type
+  )
+{
+  ASSERT (Context != NULL);
+  ASSERT (Index < ICON_NUM_TOTAL);
+  ASSERT (Type < ICON_TYPE_COUNT);
+
+  if (!Context->IconsProbed[Index]) {
+    //
+    // Mandatory icons are always loaded during context construction.
+    //
+    ASSERT (Index >= ICON_NUM_MANDATORY);
+    InternalLoadIcon (Context, Index);
+  }
+
+  return &Context->Icons[Index][Type];
+}
+
+CONST GUI_IMAGE *
+InternalGetLabelImage (
+  IN OUT BOOT_PICKER_GUI_CONTEXT  *Context,
+  IN     UINT32                   Index
+  )
+{
+  EFI_STATUS  Status;
+
+  ASSERT (Context != NULL);
+  ASSERT (Index < LABEL_NUM_TOTAL);
+
+  if (!Context->LabelsProbed[Index]) {
+    Context->LabelsProbed[Index] = TRUE;
+
+    Status = LoadLabelFromStorage (
+      Context->Storage,
+      mLabelNames[Index],
+      Context->Scale,
+      Context->LightBackground,
+      &Context->Labels[Index]
+      );
+    if (EFI_ERROR (Status)) {
+      Context->Labels[Index].Buffer = NULL;
+    }
+  }
+
+  if (Context->Labels[Index].Buffer == NULL) {
+    return NULL;
+  }
+
+  return &Context->Labels[Index];
+}
+
 EFI_STATUS
 InternalContextConstruct (
   OUT BOOT_PICKER_GUI_CONTEXT  *Context,
@@ -286,11 +422,8 @@ InternalContextConstruct (
   UINT32                             FontDataSize;
   UINTN                              UiScaleSize;
   UINT32                             Index;
-  UINT32                             ImageWidth;
-  UINT32                             ImageHeight;
   CONST CHAR8                        *Prefix;
   BOOLEAN                            Result;
-  BOOLEAN                            AllowLessSize;
 
   ASSERT (Context != NULL);
 
@@ -363,84 +496,16 @@ InternalContextConstruct (
   //
   Context->BackgroundColor.Pixel.Reserved = 0xFF;
 
-  for (Index = 0; Index < ICON_NUM_TOTAL; ++Index) {
-    AllowLessSize = FALSE;
-    if (Index == ICON_CURSOR) {
-      ImageWidth  = MAX_CURSOR_DIMENSION;
-      ImageHeight = MAX_CURSOR_DIMENSION;
-      AllowLessSize = TRUE;
-    } else if (Index == ICON_SELECTED) {
-      ImageWidth  = BOOT_SELECTOR_BACKGROUND_DIMENSION;
-      ImageHeight = BOOT_SELECTOR_BACKGROUND_DIMENSION;
-    } else if (Index == ICON_SELECTOR) {
-      ImageWidth  = BOOT_SELECTOR_BUTTON_WIDTH;
-      ImageHeight = BOOT_SELECTOR_BUTTON_HEIGHT;
-      AllowLessSize = TRUE;
-    } else if (Index == ICON_LEFT || Index == ICON_RIGHT) {
-      ImageWidth  = BOOT_SCROLL_BUTTON_DIMENSION;
-      ImageHeight = BOOT_SCROLL_BUTTON_DIMENSION;
-    } else if (Index == ICON_SHUT_DOWN || Index == ICON_RESTART) {
-      ImageWidth  = BOOT_ACTION_BUTTON_DIMENSION;
-      ImageHeight = BOOT_ACTION_BUTTON_DIMENSION;
-      AllowLessSize = TRUE;
-    } else {
-      ImageWidth  = BOOT_ENTRY_ICON_DIMENSION;
-      ImageHeight = BOOT_ENTRY_ICON_DIMENSION;
-    }
-
-    Status = LoadImageFileFromStorage (
-      Context->Icons[Index],
-      Storage,
-      mIconNames[Index],
-      Context->Scale,
-      ImageWidth,
-      ImageHeight,
-      Index >= ICON_NUM_SYS,
-      Prefix,
-      AllowLessSize
-      );
-    if (!EFI_ERROR (Status)) {
-      if (Index == ICON_SELECTOR || Index == ICON_LEFT || Index == ICON_RIGHT || Index == ICON_SHUT_DOWN || Index == ICON_RESTART) {
-        Status = GuiCreateHighlightedImage (
-          &Context->Icons[Index][ICON_TYPE_HELD],
-          &Context->Icons[Index][ICON_TYPE_BASE],
-          &mHighlightPixel
-          );
-      } else if (Index == ICON_GENERIC_HDD
-              && Context->Icons[Index][ICON_TYPE_EXTERNAL].Buffer == NULL) {
-        //
-        // For generic disk icon being able to distinguish internal and external
-        // disk icons is a security requirement. These icons are used whenever
-        // 'typed' external icons are not available.
-        //
-        Status = EFI_NOT_FOUND;
-        DEBUG ((DEBUG_WARN, "OCUI: Missing external disk icon\n"));
-        STATIC_ASSERT (
-          ICON_GENERIC_HDD < ICON_NUM_MANDATORY,
-          "The base icon should must be cleaned up explicitly."
-          );
-      }
-    } else {
-      ZeroMem (&Context->Icons[Index], sizeof (Context->Icons[Index]));
-    }
-
-    if (EFI_ERROR (Status) && Index < ICON_NUM_MANDATORY) {
-      DEBUG ((DEBUG_WARN, "OCUI: Failed to load images\n"));
-      InternalContextDestruct (Context);
-      return EFI_UNSUPPORTED;
-    }
-  }
-
-  for (Index = 0; Index < LABEL_NUM_TOTAL; ++Index) {
-    Status = LoadLabelFromStorage (
-      Storage,
-      mLabelNames[Index],
-      Context->Scale,
-      Context->LightBackground,
-      &Context->Labels[Index]
-      );
+  Context->Storage = Storage;
+  Context->Prefix  = Prefix;
+  //
+  // Only the icons required to draw the picker itself are loaded upfront.
+  // Optional entry icons and labels are loaded on first use, which usually
+  // happens when the corresponding entry becomes visible.
+  //
+  for (Index = 0; Index < ICON_NUM_MANDATORY; ++Index) {
+    Status = InternalLoadIcon (Context, Index);
     if (EFI_ERROR (Status)) {
-      Context->Labels[Index].Buffer = NULL;
       DEBUG ((DEBUG_WARN, "OCUI: Failed to load images\n"));
       InternalContextDestruct (Context);
       return EFI_UNSUPPORTED;
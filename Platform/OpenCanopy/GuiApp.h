@@ -12,6 +12,7 @@
 #include "BmfLib.h"
 
 #include <Library/OcBootManagementLib.h>
+#include <Library/OcStorageLib.h>
 
 #define MAX_CURSOR_DIMENSION  144U
 
@@ -41,6 +42,11 @@
 #define BOOT_ACTION_BUTTON_DIMENSION  144U
 #define BOOT_ACTION_BUTTON_SPACE      36U
 
+//
+// Maximum amount of off-screen boot entries to decode images for per frame.
+//
+#define BOOT_ENTRY_LAZY_DECODE_BUDGET  1U
+
 typedef enum {
   LABEL_GENERIC_HDD,
   LABEL_APPLE,
@@ -101,6 +107,10 @@ typedef struct _BOOT_PICKER_GUI_CONTEXT {
   UINT32                               CursorDefaultY;
   INT32                                AudioPlaybackTimeout;
   OC_PICKER_CONTEXT                    *PickerContext;
+  OC_STORAGE_CONTEXT                   *Storage;
+  CONST CHAR8                          *Prefix;
+  BOOLEAN                              IconsProbed[ICON_NUM_TOTAL];
+  BOOLEAN                              LabelsProbed[LABEL_NUM_TOTAL];
 } BOOT_PICKER_GUI_CONTEXT;
 
 EFI_STATUS
@@ -129,6 +139,19 @@ BootPickerViewDeinitialize (
   IN OUT BOOT_PICKER_GUI_CONTEXT  *GuiContext
   );
 
+CONST GUI_IMAGE *
+InternalGetIconImage (
+  IN OUT BOOT_PICKER_GUI_CONTEXT  *Context,
+  IN     UINT32                   Index,
+  IN     UINT32                   Type
+  );
+
+CONST GUI_IMAGE *
+InternalGetLabelImage (
+  IN OUT BOOT_PICKER_GUI_CONTEXT  *Context,
+  IN     UINT32                   Index
+  );
+
 CONST GUI_IMAGE *
 InternalGetCursorImage (
   IN BOOT_PICKER_GUI_CONTEXT  *Context
@@ -239,35 +239,31 @@ GuiPngToImage (
   )
 {
   EFI_STATUS                       Status;
-  EFI_GRAPHICS_OUTPUT_BLT_PIXEL    *BufferWalker;
-  UINTN                            Index;
-  UINT8                            TmpChannel;
-
-  Status = OcDecodePng (
-    ImageData,
-    ImageDataSize,
-    (VOID **) &Image->Buffer,
-    &Image->Width,
-    &Image->Height,
-    NULL
-    );
+
+  if (PremultiplyAlpha) {
+    Status = OcDecodePngPremultiplied (
+      ImageData,
+      ImageDataSize,
+      (VOID **) &Image->Buffer,
+      &Image->Width,
+      &Image->Height
+      );
+  } else {
+    Status = OcDecodePng (
+      ImageData,
+      ImageDataSize,
+      (VOID **) &Image->Buffer,
+      &Image->Width,
+      &Image->Height,
+      NULL
+      );
+  }
 
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_INFO, "OCUI: DecodePNG - %r\n", Status));
     return Status;
   }
 
-  if (PremultiplyAlpha) {
-    BufferWalker = Image->Buffer;
-    for (Index = 0; Index < (UINTN) Image->Width * Image->Height; ++Index) {
-      TmpChannel             = (UINT8) ((BufferWalker->Blue * BufferWalker->Reserved) / 0xFF);
-      BufferWalker->Blue     = (UINT8) ((BufferWalker->Red * BufferWalker->Reserved) / 0xFF);
-      BufferWalker->Green    = (UINT8) ((BufferWalker->Green * BufferWalker->Reserved) / 0xFF);
-      BufferWalker->Red      = TmpChannel;
-      ++BufferWalker;
-    }
-  }
-
   return EFI_SUCCESS;
 }
 
@@ -47,6 +47,13 @@ STATIC UINT8 mBootPickerOpacity = 0xFF;
 GLOBAL_REMOVE_IF_UNREFERENCED INT64 mBackgroundImageOffsetX;
 GLOBAL_REMOVE_IF_UNREFERENCED INT64 mBackgroundImageOffsetY;
 
+STATIC
+VOID
+InternalBootPickerEntryLoadImages (
+  IN OUT BOOT_PICKER_GUI_CONTEXT  *GuiContext,
+  IN OUT GUI_VOLUME_ENTRY         *VolumeEntry
+  );
+
 VOID
 GuiDrawChildImage (
   IN     CONST GUI_IMAGE      *Image,
@@ -483,7 +490,7 @@ InternalBootPickerEntryDraw (
   IN     UINT32                  Height
   )
 {
-  CONST GUI_VOLUME_ENTRY *Entry;
+  GUI_VOLUME_ENTRY       *Entry;
   CONST GUI_IMAGE        *EntryIcon;
   CONST GUI_IMAGE        *Label;
 
@@ -492,6 +499,13 @@ InternalBootPickerEntryDraw (
   ASSERT (Context != NULL);
 
   Entry       = BASE_CR (This, GUI_VOLUME_ENTRY, Hdr.Obj);
+  //
+  // The entry is visible, make sure its images are available.
+  //
+  if (!Entry->ImagesLoaded) {
+    InternalBootPickerEntryLoadImages (Context, Entry);
+  }
+
   /*if (mBootPickerImageIndex < 5) {
     EntryIcon = &((BOOT_PICKER_GUI_CONTEXT *) DrawContext->GuiContext)->Poof[mBootPickerImageIndex];
   } else */{
@@ -532,19 +546,21 @@ InternalBootPickerEntryDraw (
   //ASSERT (Label->Width  <= BOOT_ENTRY_DIMENSION * DrawContext->Scale);
   ASSERT (Label->Height <= BOOT_ENTRY_LABEL_HEIGHT * DrawContext->Scale);
 
-  GuiDrawChildImage (
-    Label,
-    mBootPickerOpacity,
-    DrawContext,
-    BaseX,
-    BaseY,
-    (BOOT_ENTRY_DIMENSION * DrawContext->Scale - Label->Width) / 2,
-    (BOOT_ENTRY_DIMENSION + BOOT_ENTRY_LABEL_SPACE + BOOT_ENTRY_LABEL_HEIGHT) * DrawContext->Scale - Label->Height,
-    OffsetX,
-    OffsetY,
-    Width,
-    Height
-    );
+  if (Label->Buffer != NULL) {
+    GuiDrawChildImage (
+      Label,
+      mBootPickerOpacity,
+      DrawContext,
+      BaseX,
+      BaseY,
+      (BOOT_ENTRY_DIMENSION * DrawContext->Scale - Label->Width) / 2,
+      (BOOT_ENTRY_DIMENSION + BOOT_ENTRY_LABEL_SPACE + BOOT_ENTRY_LABEL_HEIGHT) * DrawContext->Scale - Label->Height,
+      OffsetX,
+      OffsetY,
+      Width,
+      Height
+      );
+  }
   //
   // There should be no children.
   //
@@ -583,6 +599,10 @@ InternalBootPickerEntryPtrEvent (
 
   Entry = BASE_CR (This, GUI_VOLUME_ENTRY, Hdr.Obj);
 
+  if (!Entry->ImagesLoaded) {
+    InternalBootPickerEntryLoadImages (Context, Entry);
+  }
+
   IsHit = GuiClickableIsHit (
             &Entry->EntryIcon,
             OffsetX - BOOT_ENTRY_ICON_SPACE * DrawContext->Scale,
@@ -1369,21 +1389,21 @@ CopyLabel (
   return EFI_SUCCESS;
 }
 
-EFI_STATUS
-BootPickerEntriesAdd (
-  IN OC_PICKER_CONTEXT              *Context,
-  IN BOOT_PICKER_GUI_CONTEXT        *GuiContext,
-  IN OC_BOOT_ENTRY                  *Entry,
-  IN BOOLEAN                        Default
+STATIC
+VOID
+InternalBootPickerEntryLoadImages (
+  IN OUT BOOT_PICKER_GUI_CONTEXT  *GuiContext,
+  IN OUT GUI_VOLUME_ENTRY         *VolumeEntry
   )
 {
   EFI_STATUS                  Status;
-  GUI_VOLUME_ENTRY            *VolumeEntry;
+  OC_PICKER_CONTEXT           *Context;
+  OC_BOOT_ENTRY               *Entry;
   CONST GUI_IMAGE             *SuggestedIcon;
-  LIST_ENTRY                  *ListEntry;
-  CONST GUI_VOLUME_ENTRY      *PrevEntry;
+  CONST GUI_IMAGE             *GenericLabel;
   UINT32                      IconFileSize;
   UINT32                      IconTypeIndex;
+  UINT32                      LabelIndex;
   VOID                        *IconFileData;
   BOOLEAN                     UseVolumeIcon;
   BOOLEAN                     UseDiskLabel;
@@ -1391,21 +1411,24 @@ BootPickerEntriesAdd (
   BOOLEAN                     Result;
 
   ASSERT (GuiContext != NULL);
+  ASSERT (VolumeEntry != NULL);
+  ASSERT (!VolumeEntry->ImagesLoaded);
+
+  Context = GuiContext->PickerContext;
+  Entry   = VolumeEntry->Context;
+
+  ASSERT (Context != NULL);
   ASSERT (Entry != NULL);
 
-  DEBUG ((DEBUG_INFO, "OCUI: Console attributes: %d\n", Context->ConsoleAttributes));
+  //
+  // Mark the entry as loaded first, failures fall back to generic images.
+  //
+  VolumeEntry->ImagesLoaded = TRUE;
 
   UseVolumeIcon   = (Context->PickerAttributes & OC_ATTR_USE_VOLUME_ICON) != 0;
   UseDiskLabel    = (Context->PickerAttributes & OC_ATTR_USE_DISK_LABEL_FILE) != 0;
   UseGenericLabel = (Context->PickerAttributes & OC_ATTR_USE_GENERIC_LABEL_IMAGE) != 0;
 
-  DEBUG ((DEBUG_INFO, "OCUI: UseDiskLabel: %d, UseGenericLabel: %d\n", UseDiskLabel, UseGenericLabel));
-
-  VolumeEntry = AllocateZeroPool (sizeof (*VolumeEntry));
-  if (VolumeEntry == NULL) {
-    return EFI_OUT_OF_RESOURCES;
-  }
-
   if (UseDiskLabel) {
     Status = Context->GetEntryLabelImage (
       Context,
@@ -1422,6 +1445,7 @@ BootPickerEntriesAdd (
         GuiContext->Scale,
         GuiContext->LightBackground
         );
+      FreePool (IconFileData);
     }
   } else {
     Status = EFI_UNSUPPORTED;
@@ -1430,39 +1454,47 @@ BootPickerEntriesAdd (
   if (EFI_ERROR (Status) && UseGenericLabel) {
     switch (Entry->Type) {
       case OC_BOOT_APPLE_OS:
-        Status = CopyLabel (&VolumeEntry->Label, &GuiContext->Labels[LABEL_APPLE]);
+        LabelIndex = LABEL_APPLE;
         break;
       case OC_BOOT_APPLE_FW_UPDATE:
       case OC_BOOT_APPLE_RECOVERY:
-        Status = CopyLabel (&VolumeEntry->Label, &GuiContext->Labels[LABEL_APPLE_RECOVERY]);
+        LabelIndex = LABEL_APPLE_RECOVERY;
         break;
       case OC_BOOT_APPLE_TIME_MACHINE:
-        Status = CopyLabel (&VolumeEntry->Label, &GuiContext->Labels[LABEL_APPLE_TIME_MACHINE]);
+        LabelIndex = LABEL_APPLE_TIME_MACHINE;
         break;
       case OC_BOOT_WINDOWS:
-        Status = CopyLabel (&VolumeEntry->Label, &GuiContext->Labels[LABEL_WINDOWS]);
+        LabelIndex = LABEL_WINDOWS;
         break;
       case OC_BOOT_EXTERNAL_OS:
-        Status = CopyLabel (&VolumeEntry->Label, &GuiContext->Labels[LABEL_OTHER]);
+        LabelIndex = LABEL_OTHER;
         break;
       case OC_BOOT_RESET_NVRAM:
-        Status = CopyLabel (&VolumeEntry->Label, &GuiContext->Labels[LABEL_RESET_NVRAM]);
+        LabelIndex = LABEL_RESET_NVRAM;
         break;
       case OC_BOOT_EXTERNAL_TOOL:
         if (StrStr (Entry->Name, OC_MENU_RESET_NVRAM_ENTRY) != NULL) {
-          Status = CopyLabel (&VolumeEntry->Label, &GuiContext->Labels[LABEL_RESET_NVRAM]);
+          LabelIndex = LABEL_RESET_NVRAM;
         } else if (StrStr (Entry->Name, OC_MENU_UEFI_SHELL_ENTRY) != NULL) {
-          Status = CopyLabel (&VolumeEntry->Label, &GuiContext->Labels[LABEL_SHELL]);
+          LabelIndex = LABEL_SHELL;
         } else {
-          Status = CopyLabel (&VolumeEntry->Label, &GuiContext->Labels[LABEL_TOOL]);
+          LabelIndex = LABEL_TOOL;
         }
         break;
       case OC_BOOT_UNKNOWN:
-        Status = CopyLabel (&VolumeEntry->Label, &GuiContext->Labels[LABEL_GENERIC_HDD]);
+        LabelIndex = LABEL_GENERIC_HDD;
         break;
       default:
         DEBUG ((DEBUG_WARN, "OCUI: Entry kind %d unsupported for label\n", Entry->Type));
-        return EFI_UNSUPPORTED;
+        LabelIndex = LABEL_NUM_TOTAL;
+        break;
+    }
+
+    if (LabelIndex < LABEL_NUM_TOTAL) {
+      GenericLabel = InternalGetLabelImage (GuiContext, LabelIndex);
+      if (GenericLabel != NULL) {
+        Status = CopyLabel (&VolumeEntry->Label, GenericLabel);
+      }
     }
   }
 
@@ -1476,12 +1508,10 @@ BootPickerEntriesAdd (
       );
     if (!Result) {
       DEBUG ((DEBUG_WARN, "OCUI: label failed\n"));
-      return EFI_UNSUPPORTED;
+      ZeroMem (&VolumeEntry->Label, sizeof (VolumeEntry->Label));
     }
   }
 
-  VolumeEntry->Context = Entry;
-
   //
   // Load volume icons when allowed.
   // Do not load volume icons for Time Machine entries unless explicitly enabled.
@@ -1518,60 +1548,163 @@ BootPickerEntriesAdd (
     IconTypeIndex = Entry->IsExternal ? ICON_TYPE_EXTERNAL : ICON_TYPE_BASE;
     switch (Entry->Type) {
       case OC_BOOT_APPLE_OS:
-        SuggestedIcon = &GuiContext->Icons[ICON_APPLE][IconTypeIndex];
+        SuggestedIcon = InternalGetIconImage (GuiContext, ICON_APPLE, IconTypeIndex);
         break;
       case OC_BOOT_APPLE_FW_UPDATE:
       case OC_BOOT_APPLE_RECOVERY:
-        SuggestedIcon = &GuiContext->Icons[ICON_APPLE_RECOVERY][IconTypeIndex];
+        SuggestedIcon = InternalGetIconImage (GuiContext, ICON_APPLE_RECOVERY, IconTypeIndex);
         if (SuggestedIcon->Buffer == NULL) {
-          SuggestedIcon = &GuiContext->Icons[ICON_APPLE][IconTypeIndex];
+          SuggestedIcon = InternalGetIconImage (GuiContext, ICON_APPLE, IconTypeIndex);
         }
         break;
       case OC_BOOT_APPLE_TIME_MACHINE:
-        SuggestedIcon = &GuiContext->Icons[ICON_APPLE_TIME_MACHINE][IconTypeIndex];
+        SuggestedIcon = InternalGetIconImage (GuiContext, ICON_APPLE_TIME_MACHINE, IconTypeIndex);
         if (SuggestedIcon->Buffer == NULL) {
-          SuggestedIcon = &GuiContext->Icons[ICON_APPLE][IconTypeIndex];
+          SuggestedIcon = InternalGetIconImage (GuiContext, ICON_APPLE, IconTypeIndex);
         }
         break;
       case OC_BOOT_WINDOWS:
-        SuggestedIcon = &GuiContext->Icons[ICON_WINDOWS][IconTypeIndex];
+        SuggestedIcon = InternalGetIconImage (GuiContext, ICON_WINDOWS, IconTypeIndex);
         break;
       case OC_BOOT_EXTERNAL_OS:
-        SuggestedIcon = &GuiContext->Icons[ICON_OTHER][IconTypeIndex];
+        SuggestedIcon = InternalGetIconImage (GuiContext, ICON_OTHER, IconTypeIndex);
         break;
       case OC_BOOT_RESET_NVRAM:
-        SuggestedIcon = &GuiContext->Icons[ICON_RESET_NVRAM][IconTypeIndex];
+        SuggestedIcon = InternalGetIconImage (GuiContext, ICON_RESET_NVRAM, IconTypeIndex);
         if (SuggestedIcon->Buffer == NULL) {
-          SuggestedIcon = &GuiContext->Icons[ICON_TOOL][IconTypeIndex];
+          SuggestedIcon = InternalGetIconImage (GuiContext, ICON_TOOL, IconTypeIndex);
         }
         break;
       case OC_BOOT_EXTERNAL_TOOL:
         if (StrStr (Entry->Name, OC_MENU_RESET_NVRAM_ENTRY) != NULL) {
-          SuggestedIcon = &GuiContext->Icons[ICON_RESET_NVRAM][IconTypeIndex];
+          SuggestedIcon = InternalGetIconImage (GuiContext, ICON_RESET_NVRAM, IconTypeIndex);
         } else if (StrStr (Entry->Name, OC_MENU_UEFI_SHELL_ENTRY) != NULL) {
-          SuggestedIcon = &GuiContext->Icons[ICON_SHELL][IconTypeIndex];
+          SuggestedIcon = InternalGetIconImage (GuiContext, ICON_SHELL, IconTypeIndex);
         }
 
         if (SuggestedIcon == NULL || SuggestedIcon->Buffer == NULL) {
-          SuggestedIcon = &GuiContext->Icons[ICON_TOOL][IconTypeIndex];
+          SuggestedIcon = InternalGetIconImage (GuiContext, ICON_TOOL, IconTypeIndex);
         }
         break;
       case OC_BOOT_UNKNOWN:
-        SuggestedIcon = &GuiContext->Icons[ICON_GENERIC_HDD][IconTypeIndex];
+        SuggestedIcon = InternalGetIconImage (GuiContext, ICON_GENERIC_HDD, IconTypeIndex);
         break;
       default:
         DEBUG ((DEBUG_WARN, "OCUI: Entry kind %d unsupported for icon\n", Entry->Type));
-        return EFI_UNSUPPORTED;
+        break;
     }
 
-    ASSERT (SuggestedIcon != NULL);
-
-    if (SuggestedIcon->Buffer == NULL) {
-      SuggestedIcon = &GuiContext->Icons[ICON_GENERIC_HDD][IconTypeIndex];
+    if (SuggestedIcon == NULL || SuggestedIcon->Buffer == NULL) {
+      SuggestedIcon = InternalGetIconImage (GuiContext, ICON_GENERIC_HDD, IconTypeIndex);
     }
 
+    ASSERT (SuggestedIcon->Buffer != NULL);
     CopyMem (&VolumeEntry->EntryIcon, SuggestedIcon, sizeof (VolumeEntry->EntryIcon));
   }
+}
+
+/**
+  Decode the images of not yet loaded boot entries during idle time.
+  Entries closest to the selected entry are processed first, as these are the
+  ones to become visible next. Visible entries are loaded on demand when drawn.
+**/
+STATIC
+BOOLEAN
+InternalBootPickerAnimateLazyLoad (
+  IN     BOOT_PICKER_GUI_CONTEXT *Context,
+  IN OUT GUI_DRAWING_CONTEXT     *DrawContext,
+  IN     UINT64                  CurrentTime
+  )
+{
+  LIST_ENTRY        *Left;
+  LIST_ENTRY        *Right;
+  GUI_VOLUME_ENTRY  *Entry;
+  UINT32            Budget;
+
+  ASSERT (Context != NULL);
+
+  if (mBootPicker.SelectedEntry == NULL) {
+    return FALSE;
+  }
+
+  Budget = BOOT_ENTRY_LAZY_DECODE_BUDGET;
+  Left   = &mBootPicker.SelectedEntry->Hdr.Link;
+  Right  = Left;
+
+  //
+  // Last entry is always the selector, which is not a boot entry.
+  //
+  while (Left != NULL || Right != NULL) {
+    if (Left != NULL) {
+      if (IsNull (&mBootPicker.Hdr.Obj.Children, Left)) {
+        Left = NULL;
+      } else {
+        Entry = BASE_CR (Left, GUI_VOLUME_ENTRY, Hdr.Link);
+        if (!Entry->ImagesLoaded) {
+          InternalBootPickerEntryLoadImages (Context, Entry);
+          --Budget;
+        }
+
+        Left = GetPreviousNode (&mBootPicker.Hdr.Obj.Children, Left);
+      }
+    }
+
+    if (Budget == 0) {
+      return FALSE;
+    }
+
+    if (Right != NULL) {
+      if (Right == mBootPicker.Hdr.Obj.Children.BackLink) {
+        Right = NULL;
+      } else {
+        Entry = BASE_CR (Right, GUI_VOLUME_ENTRY, Hdr.Link);
+        if (!Entry->ImagesLoaded) {
+          InternalBootPickerEntryLoadImages (Context, Entry);
+          --Budget;
+        }
+
+        Right = GetNextNode (&mBootPicker.Hdr.Obj.Children, Right);
+      }
+    }
+
+    if (Budget == 0) {
+      return FALSE;
+    }
+  }
+
+  //
+  // All entries are loaded, the animation is done.
+  //
+  return TRUE;
+}
+
+EFI_STATUS
+BootPickerEntriesAdd (
+  IN OC_PICKER_CONTEXT              *Context,
+  IN BOOT_PICKER_GUI_CONTEXT        *GuiContext,
+  IN OC_BOOT_ENTRY                  *Entry,
+  IN BOOLEAN                        Default
+  )
+{
+  GUI_VOLUME_ENTRY            *VolumeEntry;
+  LIST_ENTRY                  *ListEntry;
+  CONST GUI_VOLUME_ENTRY      *PrevEntry;
+
+  ASSERT (GuiContext != NULL);
+  ASSERT (Entry != NULL);
+
+  DEBUG ((DEBUG_INFO, "OCUI: Console attributes: %d\n", Context->ConsoleAttributes));
+
+  VolumeEntry = AllocateZeroPool (sizeof (*VolumeEntry));
+  if (VolumeEntry == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  //
+  // Label and icon images are decoded lazily, see
+  // InternalBootPickerEntryLoadImages.
+  //
+  VolumeEntry->Context = Entry;
 
   VolumeEntry->Hdr.Parent       = &mBootPicker.Hdr.Obj;
   VolumeEntry->Hdr.Obj.Width    = BOOT_ENTRY_WIDTH  * GuiContext->Scale;
@@ -1611,13 +1744,15 @@ InternalBootPickerEntryDestruct (
   )
 {
   ASSERT (Entry != NULL);
-  ASSERT (Entry->Label.Buffer != NULL);
 
   if (Entry->CustomIcon) {
     FreePool (Entry->EntryIcon.Buffer);
   }
 
-  FreePool (Entry->Label.Buffer);
+  if (Entry->Label.Buffer != NULL) {
+    FreePool (Entry->Label.Buffer);
+  }
+
   FreePool (Entry);
 }
 
@@ -1878,6 +2013,11 @@ BootPickerViewInitialize (
     GuiContext->DoneIntroAnimation = TRUE;
   }
 
+  STATIC GUI_ANIMATION LazyLoadAnim;
+  LazyLoadAnim.Context = GuiContext;
+  LazyLoadAnim.Animate = InternalBootPickerAnimateLazyLoad;
+  InsertTailList (&DrawContext->Animations, &LazyLoadAnim.Link);
+
   /*
   InitBpAnimImageList(GuiInterpolTypeLinear, 25, 25);
   STATIC GUI_ANIMATION PoofAnim;
@@ -21,6 +21,7 @@ typedef struct {
   GUI_IMAGE       Label;
   OC_BOOT_ENTRY   *Context;
   BOOLEAN         CustomIcon;
+  BOOLEAN         ImagesLoaded;
 } GUI_VOLUME_ENTRY;
 
 typedef struct {
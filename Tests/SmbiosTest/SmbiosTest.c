@@ -14,6 +14,7 @@ WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
 
 #include <Uefi.h>
 #include <PiDxe.h>
+#include <Library/BaseLib.h>
 #include <Library/PcdLib.h>
 #include <Library/UefiLib.h>
 #include <Library/MemoryAllocationLib.h>
@@ -87,12 +88,27 @@ TestSmbios (
   EFI_STATUS       Status;
   OC_CPU_INFO      CpuInfo;
   OC_SMBIOS_TABLE  SmbiosTable;
+  UINT64           StartTsc;
+  UINT64           EndTsc;
   OcCpuScanProcessor (&CpuInfo);
+  StartTsc = AsmReadTsc ();
   Status = OcSmbiosTablePrepare (&SmbiosTable);
   if (!EFI_ERROR (Status)) {
-    OcSmbiosCreate (&SmbiosTable, &Data, OcSmbiosUpdateCreate, &CpuInfo);
+    Status = OcSmbiosCreate (&SmbiosTable, &Data, OcSmbiosUpdateCreate, &CpuInfo);
     OcSmbiosTableFree (&SmbiosTable);
   }
+  EndTsc = AsmReadTsc ();
+
+  //
+  // Report patching time, server boards may have hundreds of memory devices.
+  //
+  if (CpuInfo.CPUFrequency != 0) {
+    Print (
+      L"SMBIOS patching took %Lu us - %r\n",
+      DivU64x64Remainder (MultU64x32 (EndTsc - StartTsc, 1000000), CpuInfo.CPUFrequency, NULL),
+      Status
+      );
+  }
 
   return Status;
 }
@@ -0,0 +1,39 @@
+/** @file
+  Copyright (c) 2026, agent. All rights reserved.
+  SPDX-License-Identifier: BSD-3-Clause
+**/
+
+#ifndef OC_USER_MEMORY_H
+#define OC_USER_MEMORY_H
+
+#include <stdint.h>
+
+//
+// Allocation statistics gathered by UserBaseMemoryLib.
+//
+typedef struct {
+  //
+  // Number of pool allocations, including reallocations.
+  //
+  uint64_t  PoolAllocations;
+  //
+  // Total size of pool allocations in bytes.
+  //
+  uint64_t  PoolAllocationSize;
+  //
+  // Number of page allocations.
+  //
+  uint64_t  PageAllocations;
+  //
+  // Total number of allocated pages.
+  //
+  uint64_t  PageAllocationPages;
+  //
+  // Number of pool and page frees.
+  //
+  uint64_t  Frees;
+} USER_MEMORY_STATISTICS;
+
+extern USER_MEMORY_STATISTICS  gUserMemoryStatistics;
+
+#endif // OC_USER_MEMORY_H
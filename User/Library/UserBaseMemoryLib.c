@@ -12,10 +12,20 @@
 #include <string.h>
 #include <stdlib.h>
 
+#include <UserMemory.h>
+
 #ifdef WIN32
 #include <malloc.h>
 #endif // WIN32
 
+//
+// Allocations may happen concurrently, e.g. in ocvalidate batch mode.
+//
+#define USER_MEMORY_STATISTICS_ADD(Field, Value) \
+  __atomic_fetch_add (&gUserMemoryStatistics.Field, (Value), __ATOMIC_RELAXED)
+
+USER_MEMORY_STATISTICS  gUserMemoryStatistics;
+
 VOID *
 EFIAPI
 CopyMem (
@@ -87,6 +97,9 @@ AllocatePool (
   IN  UINTN  AllocationSize
   )
 {
+  USER_MEMORY_STATISTICS_ADD (PoolAllocations, 1);
+  USER_MEMORY_STATISTICS_ADD (PoolAllocationSize, AllocationSize);
+
   return malloc (AllocationSize);
 }
 
@@ -152,6 +165,9 @@ AllocatePages (
   IN UINTN  Pages
   )
 {
+  USER_MEMORY_STATISTICS_ADD (PageAllocations, 1);
+  USER_MEMORY_STATISTICS_ADD (PageAllocationPages, Pages);
+
   #ifdef WIN32
   return _aligned_malloc (Pages * EFI_PAGE_SIZE, EFI_PAGE_SIZE);
   #else // !WIN32
@@ -179,6 +195,8 @@ FreePool (
 {
   ASSERT (Buffer != NULL);
 
+  USER_MEMORY_STATISTICS_ADD (Frees, 1);
+
   free (Buffer);
 }
 
@@ -191,6 +209,8 @@ FreePages (
 {
   ASSERT (Buffer != NULL);
 
+  USER_MEMORY_STATISTICS_ADD (Frees, 1);
+
   free (Buffer);
 }
 
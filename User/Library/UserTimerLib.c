@@ -0,0 +1,88 @@
+/** @file
+  Copyright (c) 2026, agent. All rights reserved.
+  SPDX-License-Identifier: BSD-3-Clause
+**/
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/TimerLib.h>
+
+//
+// Userspace TimerLib for utilities not linking OcTimerLib.
+// Ticks come from a monotonic clock.
+//
+#ifdef _WIN32
+//
+// Declared manually to avoid windows.h conflicting with UEFI types.
+// LARGE_INTEGER is a 64-bit value.
+//
+int __stdcall QueryPerformanceCounter (long long *PerformanceCount);
+int __stdcall QueryPerformanceFrequency (long long *Frequency);
+#else
+#include <time.h>
+#endif
+
+UINT64
+EFIAPI
+GetPerformanceCounter (
+  VOID
+  )
+{
+#ifdef _WIN32
+  long long  Counter;
+
+  QueryPerformanceCounter (&Counter);
+  return (UINT64) Counter;
+#else
+  struct timespec  Time;
+
+  clock_gettime (CLOCK_MONOTONIC, &Time);
+  return (UINT64) Time.tv_sec * 1000000000ULL + (UINT64) Time.tv_nsec;
+#endif
+}
+
+UINT64
+EFIAPI
+GetPerformanceCounterProperties (
+  OUT UINT64  *StartValue  OPTIONAL,
+  OUT UINT64  *EndValue    OPTIONAL
+  )
+{
+#ifdef _WIN32
+  long long  Frequency;
+#endif
+
+  if (StartValue != NULL) {
+    *StartValue = 0;
+  }
+
+  if (EndValue != NULL) {
+    *EndValue = MAX_UINT64;
+  }
+
+#ifdef _WIN32
+  QueryPerformanceFrequency (&Frequency);
+  return (UINT64) Frequency;
+#else
+  return 1000000000ULL;
+#endif
+}
+
+UINT64
+EFIAPI
+GetTimeInNanoSecond (
+  IN UINT64  Ticks
+  )
+{
+#ifdef _WIN32
+  UINT64  Frequency;
+  UINT64  Remainder;
+  UINT64  Seconds;
+
+  Frequency = GetPerformanceCounterProperties (NULL, NULL);
+  Seconds   = DivU64x64Remainder (Ticks, Frequency, &Remainder);
+  return Seconds * 1000000000ULL + DivU64x64Remainder (Remainder * 1000000000ULL, Frequency, NULL);
+#else
+  return Ticks;
+#endif
+}
@@ -14,9 +14,73 @@
 #include <Library/DebugLib.h>
 
 #include <string.h>
+#include <sys/time.h>
 
 #include <UserFile.h>
 
+static long long current_timestamp_us(void) {
+  struct timeval te;
+  gettimeofday(&te, NULL);
+  return te.tv_sec * 1000000LL + te.tv_usec;
+}
+
+static void BenchmarkZlibChunks(OC_APPLE_DISK_IMAGE_CONTEXT *Context, uint8_t *Dmg, uint32_t DmgSize) {
+  uint32_t   chunks   = 0;
+  uint64_t   inbytes  = 0;
+  uint64_t   outbytes = 0;
+  long long  elapsed  = 0;
+  long long  start;
+  uint8_t    *buffer  = NULL;
+  uint64_t   buffer_size = 0;
+
+  for (uint32_t b = 0; b < Context->BlockCount; ++b) {
+    APPLE_DISK_IMAGE_BLOCK_DATA *Block = Context->Blocks[b];
+    for (uint32_t c = 0; c < Block->ChunkCount; ++c) {
+      APPLE_DISK_IMAGE_CHUNK *Chunk = &Block->Chunks[c];
+      uint64_t size = Chunk->SectorCount * APPLE_DISK_IMAGE_SECTOR_SIZE;
+
+      if (Chunk->Type != APPLE_DISK_IMAGE_CHUNK_TYPE_ZLIB
+        || Chunk->CompressedOffset > DmgSize
+        || Chunk->CompressedLength > DmgSize - Chunk->CompressedOffset) {
+        continue;
+      }
+
+      if (size > buffer_size) {
+        free(buffer);
+        buffer      = malloc(size);
+        buffer_size = size;
+        if (buffer == NULL) {
+          printf("ZLIB chunk allocation failed\n");
+          return;
+        }
+      }
+
+      start = current_timestamp_us();
+      if (DecompressZLIB(buffer, size, Dmg + Chunk->CompressedOffset, Chunk->CompressedLength) != size) {
+        printf("ZLIB chunk %u:%u decompression error\n", b, c);
+        free(buffer);
+        return;
+      }
+      elapsed += current_timestamp_us() - start;
+
+      ++chunks;
+      inbytes  += Chunk->CompressedLength;
+      outbytes += size;
+    }
+  }
+
+  free(buffer);
+
+  printf(
+    "ZLIB chunks %u, %llu -> %llu bytes in %lld us, %.1f MB/s\n",
+    chunks,
+    (unsigned long long) inbytes,
+    (unsigned long long) outbytes,
+    elapsed,
+    elapsed > 0 ? (double) outbytes / elapsed : 0.0
+    );
+}
+
 int ENTRY_POINT (int argc, char *argv[]) {
   if (argc < 2) {
     printf ("Please provide a valid Disk Image path\n");
@@ -115,6 +179,41 @@ int ENTRY_POINT (int argc, char *argv[]) {
 
     printf ("Decompressed the entire DMG...\n");
 
+    BenchmarkZlibChunks (&DmgContext, Dmg, DmgSize);
+
+    long long AdlerStart = current_timestamp_us ();
+    UINT32 Adler = Adler32 (UncompDmg, UncompSize);
+    long long AdlerTime = current_timestamp_us () - AdlerStart;
+    printf (
+      "Adler32 %08X over %u bytes in %lld us, %.1f MB/s\n",
+      Adler,
+      UncompSize,
+      AdlerTime,
+      AdlerTime > 0 ? (double) UncompSize / AdlerTime : 0.0
+      );
+
+    //
+    // Re-read the image like a filesystem driver would, idling between reads.
+    //
+    uint8_t  Block[4096];
+    for (uint32_t Offset = 0; Offset + sizeof (Block) <= UncompSize; Offset += sizeof (Block)) {
+      Result = OcAppleDiskImageRead (&DmgContext, Offset / APPLE_DISK_IMAGE_SECTOR_SIZE, sizeof (Block), Block);
+      if (!Result || memcmp (Block, UncompDmg + Offset, sizeof (Block)) != 0) {
+        printf ("DMG sequential read error at %u\n", Offset);
+        goto ContinueDmgLoop;
+      }
+
+      OcAppleDiskImageReadAhead (&DmgContext);
+    }
+
+    printf (
+      "Chunk cache hits %u, misses %u, read-ahead hits %u of %u\n",
+      DmgContext.CacheHits,
+      DmgContext.CacheMisses,
+      DmgContext.ReadAheadHits,
+      DmgContext.ReadAheads
+      );
+
 #if 0
     FILE *Fh = fopen("out.bin", "wb");
     if (Fh != NULL) {
@@ -17,11 +17,14 @@
 #include <Library/OcSerializeLib.h>
 #include <Library/OcMiscLib.h>
 #include <Library/OcAppleKernelLib.h>
+#include <Library/PrintLib.h>
+#include <Library/TimerLib.h>
 
 #include <string.h>
 #include <sys/time.h>
 
 #include <UserFile.h>
+#include <UserMemory.h>
 
 STATIC BOOLEAN FailedToProcess = FALSE;
 STATIC UINT32  KernelVersion   = 0;
@@ -531,6 +534,648 @@ GetFileSize (
   return EFI_SUCCESS;
 }
 
+//
+// Benchmark mode:
+//   KextInject -b <rounds> <input>... [-k <kext|n> <plist>]...
+//
+// Every input (prelinkedkernel, kernel collection, or mkext) is processed
+// the way OpenCore does it, repeated <rounds> times with the kexts given.
+// Per-phase and per-kext timings, measured around the public library calls,
+// and allocation counts summed over all rounds are printed as JSON to stdout.
+//
+
+typedef enum {
+  BenchmarkPhaseRead,
+  BenchmarkPhaseContextInit,
+  BenchmarkPhaseInjectPrepare,
+  BenchmarkPhaseInjectKexts,
+  BenchmarkPhasePatch,
+  BenchmarkPhaseInjectComplete,
+  BenchmarkPhaseTotal,
+  BenchmarkPhaseMax
+} BENCHMARK_PHASE;
+
+STATIC CONST CHAR8 *mBenchmarkPhaseNames[BenchmarkPhaseMax] = {
+  [BenchmarkPhaseRead]           = "read",
+  [BenchmarkPhaseContextInit]    = "context_init",
+  [BenchmarkPhaseInjectPrepare]  = "inject_prepare",
+  [BenchmarkPhaseInjectKexts]    = "inject_kexts",
+  [BenchmarkPhasePatch]          = "patch",
+  [BenchmarkPhaseInjectComplete] = "inject_complete",
+  [BenchmarkPhaseTotal]          = "total"
+};
+
+STATIC KERNEL_QUIRK_NAME mBenchmarkKextQuirks[] = {
+  KernelQuirkAppleCpuPmCfgLock,
+  KernelQuirkExternalDiskIcons,
+  KernelQuirkThirdPartyDrives,
+  KernelQuirkDisableIoMapper,
+  KernelQuirkDisableRtcChecksum,
+  KernelQuirkIncreasePciBarSize,
+  KernelQuirkDummyPowerManagement,
+  KernelQuirkXhciPortLimit1,
+  KernelQuirkXhciPortLimit2,
+  KernelQuirkXhciPortLimit3,
+  KernelQuirkCustomSmbiosGuid1,
+  KernelQuirkCustomSmbiosGuid2,
+  KernelQuirkExtendBTFeatureFlags,
+  KernelQuirkForceSecureBootScheme,
+  KernelQuirkSetApfsTrimTimeout
+};
+
+typedef struct {
+  CONST CHAR8  *Path;
+  UINT8        *Executable;
+  UINT32       ExecutableSize;
+  CHAR8        *InfoPlist;
+  UINT32       InfoPlistSize;
+} BENCHMARK_KEXT;
+
+typedef struct {
+  CONST CHAR8             *Path;
+  UINT8                   *Data;
+  UINT32                  DataSize;
+  BOOLEAN                 IsMkext;
+  BOOLEAN                 Is32Bit;
+  BOOLEAN                 IsKernelCollection;
+  UINT32                  KernelVersion;
+  EFI_STATUS              Status;
+  CONST CHAR8             *FailedPhase;
+  //
+  // Rounds samples per phase in nanoseconds.
+  //
+  UINT64                  *Phases[BenchmarkPhaseMax];
+  //
+  // NumKexts x Rounds samples in nanoseconds.
+  //
+  UINT64                  *KextInject;
+  //
+  // Kext injection status of the last round.
+  //
+  EFI_STATUS              *KextStatus;
+  //
+  // Allocations done in all rounds run.
+  //
+  UINT32                  MemoryRounds;
+  USER_MEMORY_STATISTICS  Memory;
+} BENCHMARK_INPUT;
+
+STATIC
+UINT64
+BenchmarkElapsed (
+  IN UINT64  Start
+  )
+{
+  return GetTimeInNanoSecond (GetPerformanceCounter () - Start);
+}
+
+STATIC
+VOID
+ApplyMkextPatches (
+  IN OUT MKEXT_CONTEXT  *Context
+  )
+{
+  UINT32  Index;
+
+  MkextContextApplyPatch (Context, "com.apple.iokit.IOAHCIFamily", &DisableIOAHCIPatch);
+  MkextContextBlock (Context, "com.apple.iokit.IOHIDFamily", FALSE);
+
+  for (Index = 0; Index < ARRAY_SIZE (mBenchmarkKextQuirks); ++Index) {
+    MkextContextApplyQuirk (Context, mBenchmarkKextQuirks[Index], KernelVersion);
+  }
+}
+
+STATIC
+EFI_STATUS
+BenchmarkMkextRound (
+  IN OUT BENCHMARK_INPUT  *Input,
+  IN     UINT32           Round,
+  IN     BENCHMARK_KEXT   *Kexts,
+  IN     UINT32           NumKexts,
+  IN     UINT32           Rounds
+  )
+{
+  EFI_STATUS     Status;
+  MKEXT_CONTEXT  Context;
+  UINT8          *Mkext;
+  UINT32         MkextSize;
+  UINT32         AllocSize;
+  UINT32         ReservedInfoSize;
+  UINT32         ReservedExeSize;
+  UINT32         Index;
+  UINT64         Start;
+  CHAR8          KextPath[64];
+
+  Start            = GetPerformanceCounter ();
+  ReservedInfoSize = 0;
+  ReservedExeSize  = 0;
+
+  for (Index = 0; Index < NumKexts; ++Index) {
+    MkextReserveKextSize (
+      &ReservedInfoSize,
+      &ReservedExeSize,
+      Kexts[Index].InfoPlistSize,
+      Kexts[Index].Executable,
+      Kexts[Index].ExecutableSize,
+      Input->Is32Bit
+      );
+  }
+
+  Prelinked     = Input->Data;
+  PrelinkedSize = Input->DataSize;
+  Status = ReadAppleMkext (
+    &nilFilProtocol,
+    Input->Is32Bit,
+    &Mkext,
+    &MkextSize,
+    &AllocSize,
+    ReservedInfoSize + ReservedExeSize,
+    NumKexts
+    );
+  Input->Phases[BenchmarkPhaseRead][Round] = BenchmarkElapsed (Start);
+  if (EFI_ERROR (Status)) {
+    Input->FailedPhase = mBenchmarkPhaseNames[BenchmarkPhaseRead];
+    return Status;
+  }
+
+  Start  = GetPerformanceCounter ();
+  Status = MkextContextInit (&Context, Mkext, MkextSize, AllocSize);
+  Input->Phases[BenchmarkPhaseContextInit][Round] = BenchmarkElapsed (Start);
+  if (EFI_ERROR (Status)) {
+    FreePool (Mkext);
+    Input->FailedPhase = mBenchmarkPhaseNames[BenchmarkPhaseContextInit];
+    return Status;
+  }
+
+  for (Index = 0; Index < NumKexts; ++Index) {
+    AsciiSPrint (KextPath, sizeof (KextPath), "/Library/Extensions/Kext%u.kext", Index);
+
+    Start = GetPerformanceCounter ();
+    Input->KextStatus[Index] = MkextInjectKext (
+      &Context,
+      NULL,
+      KextPath,
+      Kexts[Index].InfoPlist,
+      Kexts[Index].InfoPlistSize,
+      Kexts[Index].Executable,
+      Kexts[Index].ExecutableSize
+      );
+    Input->KextInject[Index * Rounds + Round] = BenchmarkElapsed (Start);
+    Input->Phases[BenchmarkPhaseInjectKexts][Round] += Input->KextInject[Index * Rounds + Round];
+  }
+
+  Start = GetPerformanceCounter ();
+  ApplyMkextPatches (&Context);
+  Input->Phases[BenchmarkPhasePatch][Round] = BenchmarkElapsed (Start);
+
+  Start  = GetPerformanceCounter ();
+  Status = MkextInjectPatchComplete (&Context);
+  Input->Phases[BenchmarkPhaseInjectComplete][Round] = BenchmarkElapsed (Start);
+  if (EFI_ERROR (Status)) {
+    Input->FailedPhase = mBenchmarkPhaseNames[BenchmarkPhaseInjectComplete];
+  }
+
+  MkextContextFree (&Context);
+  FreePool (Mkext);
+  return Status;
+}
+
+STATIC
+EFI_STATUS
+BenchmarkPrelinkedRound (
+  IN OUT BENCHMARK_INPUT  *Input,
+  IN     UINT32           Round,
+  IN     BENCHMARK_KEXT   *Kexts,
+  IN     UINT32           NumKexts,
+  IN     UINT32           Rounds
+  )
+{
+  EFI_STATUS         Status;
+  PRELINKED_CONTEXT  Context;
+  UINT8              *Kernel;
+  UINT32             KernelSize;
+  UINT32             AllocSize;
+  UINT32             ReservedInfoSize;
+  UINT32             ReservedExeSize;
+  UINT32             LinkedExpansion;
+  UINT32             Index;
+  UINT64             Start;
+  UINT8              Digest[48];
+  CHAR8              KextPath[64];
+
+  Start            = GetPerformanceCounter ();
+  ReservedInfoSize = PRELINK_INFO_RESERVE_SIZE;
+  ReservedExeSize  = 0;
+
+  for (Index = 0; Index < NumKexts; ++Index) {
+    PrelinkedReserveKextSize (
+      &ReservedInfoSize,
+      &ReservedExeSize,
+      Kexts[Index].InfoPlistSize,
+      Kexts[Index].Executable,
+      Kexts[Index].ExecutableSize,
+      Input->Is32Bit
+      );
+  }
+
+  LinkedExpansion = KcGetSegmentFixupChainsSize (ReservedExeSize);
+  if (LinkedExpansion == 0) {
+    Input->FailedPhase = mBenchmarkPhaseNames[BenchmarkPhaseRead];
+    return EFI_UNSUPPORTED;
+  }
+
+  Prelinked     = Input->Data;
+  PrelinkedSize = Input->DataSize;
+  Status = ReadAppleKernel (
+    &nilFilProtocol,
+    FALSE,
+    &Input->Is32Bit,
+    &Kernel,
+    &KernelSize,
+    &AllocSize,
+    ReservedInfoSize + ReservedExeSize + LinkedExpansion,
+    Digest
+    );
+  if (!EFI_ERROR (Status)) {
+    KernelVersion = OcKernelReadDarwinVersion (Kernel, KernelSize);
+    Input->KernelVersion = KernelVersion;
+  }
+  Input->Phases[BenchmarkPhaseRead][Round] = BenchmarkElapsed (Start);
+  if (EFI_ERROR (Status)) {
+    Input->FailedPhase = mBenchmarkPhaseNames[BenchmarkPhaseRead];
+    return Status;
+  }
+
+  Start = GetPerformanceCounter ();
+  ApplyKernelPatches (Kernel, KernelSize);
+  Input->Phases[BenchmarkPhasePatch][Round] = BenchmarkElapsed (Start);
+
+  Start  = GetPerformanceCounter ();
+  Status = PrelinkedContextInit (&Context, Kernel, KernelSize, AllocSize, Input->Is32Bit);
+  Input->Phases[BenchmarkPhaseContextInit][Round] = BenchmarkElapsed (Start);
+  if (EFI_ERROR (Status)) {
+    FreePool (Kernel);
+    Input->FailedPhase = mBenchmarkPhaseNames[BenchmarkPhaseContextInit];
+    return Status;
+  }
+
+  Input->IsKernelCollection = Context.IsKernelCollection;
+
+  Start  = GetPerformanceCounter ();
+  Status = PrelinkedInjectPrepare (&Context, LinkedExpansion, ReservedExeSize);
+  Input->Phases[BenchmarkPhaseInjectPrepare][Round] = BenchmarkElapsed (Start);
+  if (EFI_ERROR (Status)) {
+    PrelinkedContextFree (&Context);
+    FreePool (Kernel);
+    Input->FailedPhase = mBenchmarkPhaseNames[BenchmarkPhaseInjectPrepare];
+    return Status;
+  }
+
+  for (Index = 0; Index < NumKexts; ++Index) {
+    AsciiSPrint (KextPath, sizeof (KextPath), "/Library/Extensions/Kext%u.kext", Index);
+
+    Start = GetPerformanceCounter ();
+    Input->KextStatus[Index] = PrelinkedInjectKext (
+      &Context,
+      NULL,
+      KextPath,
+      Kexts[Index].InfoPlist,
+      Kexts[Index].InfoPlistSize,
+      Kexts[Index].Executable != NULL ? "Contents/MacOS/Kext" : NULL,
+      Kexts[Index].Executable,
+      Kexts[Index].ExecutableSize
+      );
+    Input->KextInject[Index * Rounds + Round] = BenchmarkElapsed (Start);
+    Input->Phases[BenchmarkPhaseInjectKexts][Round] += Input->KextInject[Index * Rounds + Round];
+  }
+
+  Start = GetPerformanceCounter ();
+  ApplyKextPatches (&Context);
+  Input->Phases[BenchmarkPhasePatch][Round] += BenchmarkElapsed (Start);
+
+  Start  = GetPerformanceCounter ();
+  Status = PrelinkedInjectComplete (&Context);
+  Input->Phases[BenchmarkPhaseInjectComplete][Round] = BenchmarkElapsed (Start);
+  if (EFI_ERROR (Status)) {
+    Input->FailedPhase = mBenchmarkPhaseNames[BenchmarkPhaseInjectComplete];
+  }
+
+  PrelinkedContextFree (&Context);
+  FreePool (Kernel);
+  return Status;
+}
+
+STATIC
+int
+BenchmarkCompareSamples (
+  const void  *First,
+  const void  *Second
+  )
+{
+  UINT64  A;
+  UINT64  B;
+
+  A = *(CONST UINT64 *) First;
+  B = *(CONST UINT64 *) Second;
+  return A < B ? -1 : A > B;
+}
+
+STATIC
+VOID
+BenchmarkPrintString (
+  IN CONST CHAR8  *String
+  )
+{
+  putchar ('"');
+  for (; *String != '\0'; ++String) {
+    if (*String == '"' || *String == '\\') {
+      printf ("\\%c", *String);
+    } else if ((UINT8) *String < 0x20) {
+      printf ("\\u%04x", (UINT8) *String);
+    } else {
+      putchar (*String);
+    }
+  }
+  putchar ('"');
+}
+
+STATIC
+VOID
+BenchmarkPrintSamples (
+  IN CONST CHAR8  *Name,
+  IN UINT64       *Samples,
+  IN UINT32       Rounds
+  )
+{
+  UINT64  *Sorted;
+  UINT64  Sum;
+  UINT32  Index;
+
+  Sorted = malloc (Rounds * sizeof (*Sorted));
+  if (Sorted == NULL) {
+    abort ();
+  }
+
+  memcpy (Sorted, Samples, Rounds * sizeof (*Sorted));
+  qsort (Sorted, Rounds, sizeof (*Sorted), BenchmarkCompareSamples);
+
+  Sum = 0;
+  for (Index = 0; Index < Rounds; ++Index) {
+    Sum += Sorted[Index];
+  }
+
+  BenchmarkPrintString (Name);
+  printf (
+    ": {\"min_ns\": %llu, \"median_ns\": %llu, \"mean_ns\": %llu, \"max_ns\": %llu}",
+    (unsigned long long) Sorted[0],
+    (unsigned long long) Sorted[Rounds / 2],
+    (unsigned long long) (Sum / Rounds),
+    (unsigned long long) Sorted[Rounds - 1]
+    );
+
+  free (Sorted);
+}
+
+STATIC
+VOID
+BenchmarkPrintInput (
+  IN BENCHMARK_INPUT  *Input,
+  IN BENCHMARK_KEXT   *Kexts,
+  IN UINT32           NumKexts,
+  IN UINT32           Rounds
+  )
+{
+  UINT32  Index;
+  CHAR8   StatusString[64];
+
+  printf ("    {\n      \"path\": ");
+  BenchmarkPrintString (Input->Path);
+  printf (
+    ",\n      \"type\": \"%s\",\n      \"arch\": \"%s\",\n      \"kernel_version\": %u,\n",
+    Input->IsMkext ? "mkext" : (Input->IsKernelCollection ? "kernelcollection" : "prelinkedkernel"),
+    Input->Is32Bit ? "i386" : "x86_64",
+    Input->KernelVersion
+    );
+
+  AsciiSPrint (StatusString, sizeof (StatusString), "%r", Input->Status);
+  printf ("      \"status\": ");
+  BenchmarkPrintString (StatusString);
+  if (Input->FailedPhase != NULL) {
+    printf (",\n      \"failed_phase\": ");
+    BenchmarkPrintString (Input->FailedPhase);
+  }
+
+  if (EFI_ERROR (Input->Status)) {
+    printf ("\n    }");
+    return;
+  }
+
+  printf (",\n      \"phases\": {");
+  for (Index = 0; Index < BenchmarkPhaseMax; ++Index) {
+    //
+    // Mkext kexts are not linked.
+    //
+    if (Input->IsMkext && Index == BenchmarkPhaseInjectPrepare) {
+      continue;
+    }
+
+    printf (Index > 0 ? ",\n        " : "\n        ");
+    BenchmarkPrintSamples (mBenchmarkPhaseNames[Index], Input->Phases[Index], Rounds);
+  }
+
+  printf ("\n      },\n      \"kexts\": [\n");
+  for (Index = 0; Index < NumKexts; ++Index) {
+    AsciiSPrint (StatusString, sizeof (StatusString), "%r", Input->KextStatus[Index]);
+    printf ("        {\"path\": ");
+    BenchmarkPrintString (Kexts[Index].Path);
+    printf (", \"status\": ");
+    BenchmarkPrintString (StatusString);
+    printf (", ");
+    BenchmarkPrintSamples ("inject", &Input->KextInject[Index * Rounds], Rounds);
+    printf (Index + 1 < NumKexts ? "},\n" : "}\n");
+  }
+
+  printf (
+    "      ],\n"
+    "      \"allocations\": {\"rounds\": %u, \"pool\": %llu, \"pool_bytes\": %llu, \"pages\": %llu, \"page_count\": %llu, \"frees\": %llu}\n"
+    "    }",
+    Input->MemoryRounds,
+    (unsigned long long) Input->Memory.PoolAllocations,
+    (unsigned long long) Input->Memory.PoolAllocationSize,
+    (unsigned long long) Input->Memory.PageAllocations,
+    (unsigned long long) Input->Memory.PageAllocationPages,
+    (unsigned long long) Input->Memory.Frees
+    );
+}
+
+STATIC
+VOID
+BenchmarkDetectMkext (
+  IN OUT BENCHMARK_INPUT  *Input
+  )
+{
+  EFI_STATUS  Status;
+  UINT8       *Mkext;
+  UINT32      MkextSize;
+  UINT32      AllocSize;
+  UINT32      Index;
+
+  Prelinked     = Input->Data;
+  PrelinkedSize = Input->DataSize;
+
+  for (Index = 0; Index < 2; ++Index) {
+    Status = ReadAppleMkext (&nilFilProtocol, Index != 0, &Mkext, &MkextSize, &AllocSize, 0, 0);
+    if (!EFI_ERROR (Status)) {
+      FreePool (Mkext);
+      Input->IsMkext = TRUE;
+      Input->Is32Bit = Index != 0;
+      return;
+    }
+  }
+}
+
+STATIC
+int
+BenchmarkMain (
+  IN int   argc,
+  IN char  **argv
+  )
+{
+  BENCHMARK_INPUT         *Inputs;
+  BENCHMARK_KEXT          *Kexts;
+  BENCHMARK_INPUT         *Input;
+  UINT32                  NumInputs;
+  UINT32                  NumKexts;
+  UINT32                  Rounds;
+  UINT32                  Round;
+  UINT32                  Index;
+  UINT32                  Phase;
+  UINT64                  Start;
+  USER_MEMORY_STATISTICS  Memory;
+  int                     Code;
+
+  if (argc < 2 || (Rounds = (UINT32) strtoul (argv[0], NULL, 0)) == 0) {
+    printf ("Usage: KextInject -b <rounds> <input>... [-k <kext|n> <plist>]...\n");
+    return -1;
+  }
+
+  //
+  // Keep stdout clean for JSON.
+  //
+  PcdGet32 (PcdFixedDebugPrintErrorLevel) = 0;
+  PcdGet32 (PcdDebugPrintErrorLevel)      = 0;
+
+  Inputs = calloc (argc, sizeof (*Inputs));
+  Kexts  = calloc (argc, sizeof (*Kexts));
+  if (Inputs == NULL || Kexts == NULL) {
+    return -1;
+  }
+
+  NumInputs = 0;
+  NumKexts  = 0;
+
+  for (Index = 1; Index < (UINT32) argc; ++Index) {
+    if (strcmp (argv[Index], "-k") == 0) {
+      if (Index + 2 >= (UINT32) argc) {
+        printf ("Missing kext binary or plist\n");
+        return -1;
+      }
+
+      Kexts[NumKexts].Path = argv[Index + 1];
+      if (strcmp (argv[Index + 1], "n") != 0) {
+        Kexts[NumKexts].Executable = UserReadFile (argv[Index + 1], &Kexts[NumKexts].ExecutableSize);
+        if (Kexts[NumKexts].Executable == NULL) {
+          printf ("Read data fail %s\n", argv[Index + 1]);
+          return -1;
+        }
+      }
+
+      Kexts[NumKexts].InfoPlist = (CHAR8 *) UserReadFile (argv[Index + 2], &Kexts[NumKexts].InfoPlistSize);
+      if (Kexts[NumKexts].InfoPlist == NULL) {
+        printf ("Read plist fail %s\n", argv[Index + 2]);
+        return -1;
+      }
+
+      ++NumKexts;
+      Index += 2;
+      continue;
+    }
+
+    Inputs[NumInputs].Path = argv[Index];
+    Inputs[NumInputs].Data = UserReadFile (argv[Index], &Inputs[NumInputs].DataSize);
+    if (Inputs[NumInputs].Data == NULL) {
+      printf ("Read fail %s\n", argv[Index]);
+      return -1;
+    }
+
+    ++NumInputs;
+  }
+
+  Code = 0;
+
+  printf ("{\n  \"rounds\": %u,\n  \"inputs\": [\n", Rounds);
+
+  for (Index = 0; Index < NumInputs; ++Index) {
+    Input = &Inputs[Index];
+
+    for (Phase = 0; Phase < BenchmarkPhaseMax; ++Phase) {
+      Input->Phases[Phase] = calloc (Rounds, sizeof (UINT64));
+    }
+    Input->KextInject = calloc ((UINTN) NumKexts * Rounds + 1, sizeof (UINT64));
+    Input->KextStatus = calloc (NumKexts + 1, sizeof (EFI_STATUS));
+
+    BenchmarkDetectMkext (Input);
+    KernelVersion = 0;
+
+    for (Round = 0; Round < Rounds; ++Round) {
+      memcpy (&Memory, &gUserMemoryStatistics, sizeof (Memory));
+      Start = GetPerformanceCounter ();
+
+      if (Input->IsMkext) {
+        Input->Status = BenchmarkMkextRound (Input, Round, Kexts, NumKexts, Rounds);
+      } else {
+        Input->Status = BenchmarkPrelinkedRound (Input, Round, Kexts, NumKexts, Rounds);
+      }
+
+      Input->Phases[BenchmarkPhaseTotal][Round] = BenchmarkElapsed (Start);
+
+      Input->Memory.PoolAllocations     += gUserMemoryStatistics.PoolAllocations - Memory.PoolAllocations;
+      Input->Memory.PoolAllocationSize  += gUserMemoryStatistics.PoolAllocationSize - Memory.PoolAllocationSize;
+      Input->Memory.PageAllocations     += gUserMemoryStatistics.PageAllocations - Memory.PageAllocations;
+      Input->Memory.PageAllocationPages += gUserMemoryStatistics.PageAllocationPages - Memory.PageAllocationPages;
+      Input->Memory.Frees               += gUserMemoryStatistics.Frees - Memory.Frees;
+      ++Input->MemoryRounds;
+
+      if (EFI_ERROR (Input->Status)) {
+        Code = -1;
+        break;
+      }
+    }
+
+    BenchmarkPrintInput (Input, Kexts, NumKexts, Rounds);
+    printf (Index + 1 < NumInputs ? ",\n" : "\n");
+
+    for (Phase = 0; Phase < BenchmarkPhaseMax; ++Phase) {
+      free (Input->Phases[Phase]);
+    }
+    free (Input->KextInject);
+    free (Input->KextStatus);
+    free (Input->Data);
+  }
+
+  printf ("  ]\n}\n");
+
+  for (Index = 0; Index < NumKexts; ++Index) {
+    free (Kexts[Index].Executable);
+    free (Kexts[Index].InfoPlist);
+  }
+
+  free (Inputs);
+  free (Kexts);
+
+  return Code;
+}
+
 int wrap_main(int argc, char** argv) {
   PcdGet32 (PcdFixedDebugPrintErrorLevel) |= DEBUG_INFO;
   PcdGet32 (PcdDebugPrintErrorLevel)      |= DEBUG_INFO;
@@ -825,6 +1470,10 @@ INT32 LLVMFuzzerTestOneInput(CONST UINT8 *Data, UINTN Size) {
 }
 
 int ENTRY_POINT(int argc, char *argv[]) {
+  if (argc > 1 && strcmp (argv[1], "-b") == 0) {
+    return BenchmarkMain (argc - 2, argv + 2);
+  }
+
   int code = wrap_main(argc, argv);
   if (FailedToProcess) {
     code = -1;
@@ -268,9 +268,72 @@ static int FeedMacho(void *file, uint32_t size) {
     }
   }
 
+  MachoFreeRelocationIndex (&Context);
+
   return code != 963;
 }
 
+static long long current_timestamp_us(void) {
+  struct timeval te;
+  gettimeofday(&te, NULL);
+  return te.tv_sec * 1000000LL + te.tv_usec;
+}
+
+static void BenchmarkRelocations(void *file, uint32_t size) {
+  OC_MACHO_CONTEXT Context;
+  MACH_SECTION_64 *Section;
+  MACH_NLIST_64   *Symbol;
+  uint32_t        index;
+  uint64_t        address;
+  uint32_t        lookups;
+  uint32_t        hits;
+  long long       start;
+
+  for (int pass = 0; pass < 2; pass++) {
+    if (!MachoInitializeContext64 (&Context, file, size, 0)) {
+      printf("Not a 64-bit Mach-O\n");
+      return;
+    }
+
+    if (pass == 0) {
+      //
+      // Mark the indices as initialised without entries to force linear lookups.
+      //
+      Context.ExternRelocationIndex.Initialized = TRUE;
+      Context.LocalRelocationIndex.Initialized  = TRUE;
+    }
+
+    lookups = 0;
+    hits    = 0;
+    start   = current_timestamp_us();
+
+    //
+    // Query every pointer slot like vtable construction does.
+    //
+    for (index = 0; (Section = MachoGetSectionByIndex64 (&Context, index)) != NULL; index++) {
+      for (address = Section->Address; address + sizeof (UINT64) <= Section->Address + Section->Size; address += sizeof (UINT64)) {
+        lookups++;
+        if (MachoGetSymbolByExternRelocationOffset64 (&Context, address, &Symbol)) {
+          hits++;
+        }
+        if (MachoGetSymbolByRelocationOffset64 (&Context, address, &Symbol)) {
+          hits++;
+        }
+      }
+    }
+
+    printf(
+      "%s relocation lookups: %u, hits: %u, time: %lld us\n",
+      pass == 0 ? "Linear " : "Indexed",
+      lookups,
+      hits,
+      current_timestamp_us() - start
+      );
+
+    MachoFreeRelocationIndex (&Context);
+  }
+}
+
 int ENTRY_POINT(int argc, char** argv) {
   uint32_t f;
   uint8_t *b;
@@ -279,6 +342,11 @@ int ENTRY_POINT(int argc, char** argv) {
     return -1;
   }
 
+  if (argc > 2 && strcmp(argv[2], "--bench") == 0) {
+    BenchmarkRelocations (b, f);
+    return 0;
+  }
+
   return FeedMacho (b, f);
 }
 
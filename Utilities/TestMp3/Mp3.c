@@ -25,41 +25,106 @@
 
 #include <UserFile.h>
 
-int ENTRY_POINT(int argc, char** argv) {
+#define DECODE_ROUNDS 5
+
+static long long current_timestamp_us(void) {
+  struct timeval te;
+  gettimeofday(&te, NULL);
+  return te.tv_sec * 1000000LL + te.tv_usec;
+}
+
+static uint32_t frequency_to_hz(EFI_AUDIO_IO_PROTOCOL_FREQ freq) {
+  switch (freq) {
+    case EfiAudioIoFreq8kHz:  return 8000;
+    case EfiAudioIoFreq11kHz: return 11025;
+    case EfiAudioIoFreq16kHz: return 16000;
+    case EfiAudioIoFreq22kHz: return 22050;
+    case EfiAudioIoFreq32kHz: return 32000;
+    case EfiAudioIoFreq44kHz: return 44100;
+    case EfiAudioIoFreq48kHz: return 48000;
+    default:                  return 0;
+  }
+}
+
+static int decode_file(const char *name, const char *output) {
   uint32_t size;
   uint8_t *buffer;
-  if ((buffer = UserReadFile(argc > 1 ? argv[1] : "test.mp3", &size)) == NULL) {
-    printf("Read fail\n");
+  if ((buffer = UserReadFile(name, &size)) == NULL) {
+    printf("%s: read fail\n", name);
     return -1;
   }
 
-  void *outbuffer;
+  void *outbuffer = NULL;
   uint32_t outsize;
   EFI_AUDIO_IO_PROTOCOL_FREQ freq;
   EFI_AUDIO_IO_PROTOCOL_BITS bits;
   UINT8                      channels;
+  EFI_STATUS                 Status = EFI_SUCCESS;
+  long long                  best_us = 0;
 
-  EFI_STATUS Status = OcDecodeMp3 (
-    buffer,
-    size,
-    &outbuffer,
-    &outsize,
-    &freq,
-    &bits,
-    &channels
-    );
+  //
+  // Report the best of several rounds to reduce scheduling noise.
+  //
+  for (int i = 0; i < DECODE_ROUNDS && !EFI_ERROR (Status); ++i) {
+    if (outbuffer != NULL) {
+      FreePool(outbuffer);
+      outbuffer = NULL;
+    }
+
+    long long start = current_timestamp_us();
+    Status = OcDecodeMp3 (
+      buffer,
+      size,
+      &outbuffer,
+      &outsize,
+      &freq,
+      &bits,
+      &channels
+      );
+    long long took = current_timestamp_us() - start;
+    if (i == 0 || took < best_us) {
+      best_us = took;
+    }
+  }
 
   FreePool(buffer);
 
-  if (!EFI_ERROR (Status)) {
-    printf("Decode success %u\n", outsize);
-    UserWriteFile("test.bin", outbuffer, outsize);
-    FreePool(outbuffer);
-    return 0;
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_WARN, "%a: decode failure - %r\n", name, Status));
+    return 1;
+  }
+
+  //
+  // Decoded PCM is always 16-bit.
+  //
+  uint32_t hz = frequency_to_hz(freq);
+  uint64_t duration_us = hz != 0 && channels != 0
+    ? (uint64_t) outsize * 1000000ULL / (hz * channels * sizeof (int16_t)) : 0;
+  printf("%s: decode success %u, %u Hz %u ch, %llu ms audio in %lld us (%llux realtime)\n",
+    name, outsize, hz, channels, (unsigned long long) duration_us / 1000, best_us,
+    best_us > 0 ? (unsigned long long) (duration_us / best_us) : 0ULL);
+
+  if (output != NULL) {
+    UserWriteFile(output, outbuffer, outsize);
+  }
+
+  FreePool(outbuffer);
+  return 0;
+}
+
+int ENTRY_POINT(int argc, char** argv) {
+  if (argc <= 2) {
+    return decode_file(argc > 1 ? argv[1] : "test.mp3", "test.bin");
+  }
+
+  int ret = 0;
+  for (int i = 1; i < argc; ++i) {
+    if (decode_file(argv[i], NULL) != 0) {
+      ret = 1;
+    }
   }
 
-  DEBUG ((DEBUG_WARN, "Decode failure - %r\n", Status));
-  return 1;
+  return ret;
 }
 
 INT32 LLVMFuzzerTestOneInput(CONST UINT8 *Data, UINTN Size) {
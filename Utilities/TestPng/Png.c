@@ -0,0 +1,176 @@
+/** @file
+  Copyright (C) 2026, agent. All rights reserved.
+  SPDX-License-Identifier: BSD-3-Clause
+**/
+
+#include <Uefi.h>
+
+#include <Protocol/GraphicsOutput.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/OcPngLib.h>
+
+#include <string.h>
+#include <sys/time.h>
+#include <stdio.h>
+#include <stdint.h>
+
+#include <UserFile.h>
+
+#define BENCHMARK_ROUNDS 10
+
+static long long current_timestamp_us(void) {
+  struct timeval te;
+  gettimeofday(&te, NULL);
+  return te.tv_sec * 1000000LL + te.tv_usec;
+}
+
+/**
+  Previous OpenCanopy path: lodepng RGBA decoding and a separate premultiply pass.
+**/
+static EFI_STATUS DecodeReference(void *Buffer, uint32_t Size, EFI_GRAPHICS_OUTPUT_BLT_PIXEL **Pixels, UINT32 *Width, UINT32 *Height) {
+  EFI_STATUS Status = OcDecodePng(Buffer, Size, (VOID **) Pixels, Width, Height, NULL);
+  if (EFI_ERROR(Status)) {
+    return Status;
+  }
+
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL *Walker = *Pixels;
+  for (UINTN Index = 0; Index < (UINTN) *Width * *Height; ++Index, ++Walker) {
+    UINT8 Tmp        = (UINT8) ((Walker->Blue * Walker->Reserved) / 0xFF);
+    Walker->Blue     = (UINT8) ((Walker->Red * Walker->Reserved) / 0xFF);
+    Walker->Green    = (UINT8) ((Walker->Green * Walker->Reserved) / 0xFF);
+    Walker->Red      = Tmp;
+  }
+
+  return EFI_SUCCESS;
+}
+
+static long long reference_time;
+static long long fast_time;
+static uint64_t  total_pixels;
+static uint32_t  total_images;
+static uint32_t  mismatches;
+
+static void BenchmarkPng(const char *Name, uint8_t *Buffer, uint32_t Size) {
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL *Reference = NULL;
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL *Fast      = NULL;
+  UINT32     RefWidth, RefHeight, Width, Height;
+  EFI_STATUS RefStatus, Status;
+  long long  start, ref_us, fast_us;
+
+  start = current_timestamp_us();
+  for (int i = 0; i < BENCHMARK_ROUNDS; ++i) {
+    if (Reference != NULL) {
+      FreePool(Reference);
+      Reference = NULL;
+    }
+    RefStatus = DecodeReference(Buffer, Size, &Reference, &RefWidth, &RefHeight);
+  }
+  ref_us = current_timestamp_us() - start;
+
+  start = current_timestamp_us();
+  for (int i = 0; i < BENCHMARK_ROUNDS; ++i) {
+    if (Fast != NULL) {
+      FreePool(Fast);
+      Fast = NULL;
+    }
+    Status = OcDecodePngPremultiplied(Buffer, Size, (VOID **) &Fast, &Width, &Height);
+  }
+  fast_us = current_timestamp_us() - start;
+
+  if (EFI_ERROR(RefStatus) != EFI_ERROR(Status)
+    || (!EFI_ERROR(Status) && (RefWidth != Width || RefHeight != Height
+      || memcmp(Reference, Fast, (size_t) Width * Height * sizeof (*Fast)) != 0))) {
+    printf("%s: MISMATCH between decoders\n", Name);
+    ++mismatches;
+  } else if (!EFI_ERROR(Status)) {
+    printf("%s: %ux%u, lodepng %lld us, direct %lld us\n", Name, Width, Height,
+      ref_us / BENCHMARK_ROUNDS, fast_us / BENCHMARK_ROUNDS);
+    reference_time += ref_us;
+    fast_time      += fast_us;
+    total_pixels   += (uint64_t) Width * Height;
+    ++total_images;
+  } else {
+    printf("%s: decoding failure\n", Name);
+  }
+
+  if (Reference != NULL) {
+    FreePool(Reference);
+  }
+  if (Fast != NULL) {
+    FreePool(Fast);
+  }
+}
+
+static void BenchmarkIcns(const char *Name, uint8_t *Buffer, uint32_t Size) {
+  uint32_t Offset = 8;
+
+  //
+  // Benchmark every PNG record of the icon.
+  //
+  while (Offset + 8 <= Size) {
+    uint32_t Length = SwapBytes32(ReadUnaligned32((UINT32 *) &Buffer[Offset + 4]));
+    if (Length < 8 || Length > Size - Offset) {
+      break;
+    }
+
+    if (Length > 16 && memcmp(&Buffer[Offset + 9], "PNG", 3) == 0) {
+      char RecordName[512];
+      snprintf(RecordName, sizeof (RecordName), "%s:%.4s", Name, (char *) &Buffer[Offset]);
+      BenchmarkPng(RecordName, &Buffer[Offset + 8], Length - 8);
+    }
+
+    Offset += Length;
+  }
+}
+
+int ENTRY_POINT(int argc, char** argv) {
+  if (argc < 2) {
+    printf("Usage: %s <image.png|image.icns> [...]\n", argv[0]);
+    return -1;
+  }
+
+  for (int i = 1; i < argc; ++i) {
+    uint32_t size;
+    uint8_t  *buffer;
+    if ((buffer = UserReadFile(argv[i], &size)) == NULL) {
+      printf("%s: read fail\n", argv[i]);
+      continue;
+    }
+
+    if (size > 8 && memcmp(buffer, "icns", 4) == 0) {
+      BenchmarkIcns(argv[i], buffer, size);
+    } else {
+      BenchmarkPng(argv[i], buffer, size);
+    }
+
+    FreePool(buffer);
+  }
+
+  printf(
+    "Decoded %u images, %llu pixels, lodepng %lld us, direct %lld us, %u mismatches\n",
+    total_images,
+    (unsigned long long) total_pixels,
+    reference_time / BENCHMARK_ROUNDS,
+    fast_time / BENCHMARK_ROUNDS,
+    mismatches
+    );
+
+  return mismatches != 0;
+}
+
+INT32 LLVMFuzzerTestOneInput(CONST UINT8 *Data, UINTN Size) {
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL *Pixels;
+  UINT32                        Width;
+  UINT32                        Height;
+
+  if (Size > 0) {
+    if (!EFI_ERROR(OcDecodePngPremultiplied((VOID *) Data, Size, (VOID **) &Pixels, &Width, &Height))) {
+      FreePool(Pixels);
+    }
+  }
+  return 0;
+}
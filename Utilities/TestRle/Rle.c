@@ -0,0 +1,371 @@
+/** @file
+  Copyright (C) 2026, agent. All rights reserved.
+  SPDX-License-Identifier: BSD-3-Clause
+**/
+
+#include <Uefi.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/OcCompressionLib.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <stdio.h>
+#include <stdint.h>
+
+#include <UserFile.h>
+
+#define BENCHMARK_ROUNDS  1000
+#define RANDOM_ROUNDS     50000
+#define RANDOM_MAX_PIXELS 1024
+
+static long long current_timestamp_us(void) {
+  struct timeval te;
+  gettimeofday(&te, NULL);
+  return te.tv_sec * 1000000LL + te.tv_usec;
+}
+
+/**
+  Previous byte by byte implementation, decoding one channel at a time
+  with a separate mask pass.
+**/
+static UINT32 DecompressMaskedRLE24Reference(UINT8 *Dst, UINT32 DstLen, UINT8 *Src, UINT32 SrcLen, UINT8 *Mask, UINT32 MaskLen, BOOLEAN Premultiply) {
+  UINT8  *SrcEnd;
+  UINT8  *SrcLast;
+  UINT8  *DstCur;
+  UINT8  *DstEnd;
+  UINT8  ControlValue;
+  UINT8  DstValue;
+  UINT8  RunIndex;
+
+  if (SrcLen < 2 || MaskLen != DstLen / sizeof (UINT32)) {
+    return 0;
+  }
+
+  SrcEnd  = Src + SrcLen;
+  SrcLast = SrcEnd - 1;
+
+  for (RunIndex = 0; RunIndex < 3 && Src < SrcLast; ++RunIndex) {
+    DstCur = Dst + 2 - RunIndex;
+    DstEnd = DstCur + MaskLen * sizeof (UINT32);
+
+    while (Src < SrcLast && DstCur < DstEnd) {
+      ControlValue = *Src++;
+      if (ControlValue & BIT7) {
+        ControlValue -= 125;
+        DstValue      = *Src++;
+
+        if ((UINT32) (DstEnd - DstCur) < ControlValue * sizeof (UINT32)) {
+          return 0;
+        }
+
+        while (ControlValue > 0) {
+          *DstCur = DstValue;
+          DstCur += sizeof (UINT32);
+          --ControlValue;
+        }
+      } else {
+        ++ControlValue;
+
+        if ((UINT32) (SrcEnd - Src) < ControlValue || (UINT32) (DstEnd - DstCur) < ControlValue * sizeof (UINT32)) {
+          return 0;
+        }
+
+        while (ControlValue > 0) {
+          *DstCur = *Src++;
+          DstCur += sizeof (UINT32);
+          --ControlValue;
+        }
+      }
+    }
+
+    if (DstCur != DstEnd) {
+      return 0;
+    }
+  }
+
+  if (Premultiply) {
+    DstCur = Dst;
+    SrcEnd = Mask + MaskLen;
+    while (Mask < SrcEnd) {
+      DstValue  = *Mask++;
+      DstCur[0] = (UINT8) ((DstCur[0] * DstValue) / 0xFF);
+      DstCur[1] = (UINT8) ((DstCur[1] * DstValue) / 0xFF);
+      DstCur[2] = (UINT8) ((DstCur[2] * DstValue) / 0xFF);
+      DstCur[3] = DstValue;
+      DstCur   += sizeof (UINT32);
+    }
+  } else {
+    DstCur = Dst + 3;
+    SrcEnd = Mask + MaskLen;
+    while (Mask < SrcEnd) {
+      *DstCur = *Mask++;
+      DstCur += sizeof (UINT32);
+    }
+  }
+
+  return MaskLen * sizeof (UINT32);
+}
+
+/**
+  Run both decoders over the same input and destination contents.
+  Destination contents are only compared on success, as the reference
+  leaves partially decoded data on failure.
+**/
+static int CompareDecoders(UINT8 *Src, UINT32 SrcLen, UINT8 *Mask, UINT32 MaskLen, UINT32 DstLen, BOOLEAN Premultiply, UINT8 Fill, UINT32 *Decoded) {
+  UINT8  *Reference;
+  UINT8  *Fast;
+  UINT32 RefResult;
+  UINT32 Result;
+  int    Mismatch;
+
+  Reference = AllocatePool(DstLen + 1);
+  Fast      = AllocatePool(DstLen + 1);
+  if (Reference == NULL || Fast == NULL) {
+    abort();
+  }
+
+  for (UINT32 Index = 0; Index < DstLen + 1; ++Index) {
+    Reference[Index] = Fast[Index] = (UINT8) (Fill + Index * 37);
+  }
+
+  RefResult = DecompressMaskedRLE24Reference(Reference, DstLen, Src, SrcLen, Mask, MaskLen, Premultiply);
+  Result    = DecompressMaskedRLE24(Fast, DstLen, Src, SrcLen, Mask, MaskLen, Premultiply);
+
+  Mismatch = RefResult != Result
+    || (Result != 0 && memcmp(Reference, Fast, DstLen + 1) != 0);
+
+  if (Decoded != NULL) {
+    *Decoded = Result;
+  }
+
+  FreePool(Reference);
+  FreePool(Fast);
+  return Mismatch;
+}
+
+/**
+  Encode random image channel as RLE24, occasionally overflowing it.
+**/
+static UINT32 EncodeRandomChannel(UINT8 *Src, UINT32 Pixels) {
+  UINT32  Size = 0;
+  UINT32  Count;
+  BOOLEAN Repeat;
+
+  while (Pixels > 0) {
+    Repeat = rand() % 2 == 0;
+    Count  = Repeat ? 3 + rand() % 128 : 1 + rand() % 128;
+    if (Count > Pixels && rand() % 16 != 0) {
+      Count  = Pixels;
+      Repeat = Repeat && Count >= 3;
+    }
+
+    if (Repeat) {
+      Src[Size++] = (UINT8) (Count + 125);
+      Src[Size++] = (UINT8) (rand() % 4 * 85);
+    } else {
+      Src[Size++] = (UINT8) (Count - 1);
+      for (UINT32 Index = 0; Index < Count; ++Index) {
+        Src[Size++] = (UINT8) rand();
+      }
+    }
+
+    if (Count >= Pixels) {
+      break;
+    }
+    Pixels -= Count;
+  }
+
+  return Size;
+}
+
+static uint32_t RunRandom(void) {
+  UINT8    *Src;
+  UINT8    *Mask;
+  UINT32   Pixels;
+  UINT32   SrcLen;
+  UINT32   DstLen;
+  UINT32   Result;
+  uint32_t Mismatches = 0;
+  uint32_t Decoded    = 0;
+
+  Src  = AllocatePool(3 * RANDOM_MAX_PIXELS * 3);
+  Mask = AllocatePool(RANDOM_MAX_PIXELS);
+  if (Src == NULL || Mask == NULL) {
+    abort();
+  }
+
+  srand(0x52314C45);
+
+  for (uint32_t Round = 0; Round < RANDOM_ROUNDS; ++Round) {
+    Pixels = rand() % RANDOM_MAX_PIXELS;
+    SrcLen = 0;
+    for (UINT32 Channel = 0; Channel < 3; ++Channel) {
+      SrcLen += EncodeRandomChannel(&Src[SrcLen], Pixels);
+    }
+
+    for (UINT32 Index = 0; Index < Pixels; ++Index) {
+      Mask[Index] = (UINT8) (rand() % 3 == 0 ? rand() : (rand() % 2) * 0xFF);
+    }
+
+    //
+    // Mutate some of the streams to cover truncation and corruption.
+    //
+    switch (rand() % 8) {
+      case 0:
+        SrcLen = SrcLen > 0 ? (UINT32) rand() % SrcLen : 0;
+        break;
+      case 1:
+        if (SrcLen > 0) {
+          Src[rand() % SrcLen] = (UINT8) rand();
+        }
+        break;
+      default:
+        break;
+    }
+
+    DstLen = Pixels * sizeof (UINT32) + (rand() % 16 == 0 ? rand() % 8 : 0);
+
+    if (CompareDecoders(Src, SrcLen, Mask, Pixels, DstLen, (BOOLEAN) (Round & 1U), (UINT8) Round, &Result) != 0) {
+      printf("Round %u: MISMATCH for %u pixels, %u bytes\n", Round, Pixels, SrcLen);
+      ++Mismatches;
+    } else if (Result != 0) {
+      ++Decoded;
+    }
+  }
+
+  printf("Compared %u random streams, %u decoded, %u mismatches\n", RANDOM_ROUNDS, Decoded, Mismatches);
+
+  FreePool(Src);
+  FreePool(Mask);
+  return Mismatches;
+}
+
+static uint32_t BenchmarkIcns(const char *Name, uint8_t *Buffer, uint32_t Size) {
+  uint32_t  Offset = 8;
+  uint8_t   *IT32 = NULL;
+  uint32_t  IT32Size = 0;
+  uint8_t   *T8MK = NULL;
+  uint32_t  T8MKSize = 0;
+  UINT8     *Pixels;
+  UINT32    DstLen;
+  long long start, ref_us, fast_us;
+
+  while (Offset + 8 <= Size) {
+    uint32_t Length = SwapBytes32(ReadUnaligned32((UINT32 *) &Buffer[Offset + 4]));
+    if (Length < 8 || Length > Size - Offset) {
+      break;
+    }
+
+    if (memcmp(&Buffer[Offset], "it32", 4) == 0 && Length > 12) {
+      IT32     = &Buffer[Offset + 12];
+      IT32Size = Length - 12;
+    } else if (memcmp(&Buffer[Offset], "t8mk", 4) == 0) {
+      T8MK     = &Buffer[Offset + 8];
+      T8MKSize = Length - 8;
+    }
+
+    Offset += Length;
+  }
+
+  if (IT32 == NULL || T8MK == NULL) {
+    printf("%s: no it32/t8mk records\n", Name);
+    return 0;
+  }
+
+  DstLen = T8MKSize * sizeof (UINT32);
+  Pixels = AllocatePool(DstLen);
+  if (Pixels == NULL) {
+    abort();
+  }
+
+  start = current_timestamp_us();
+  for (int i = 0; i < BENCHMARK_ROUNDS; ++i) {
+    DecompressMaskedRLE24Reference(Pixels, DstLen, IT32, IT32Size, T8MK, T8MKSize, TRUE);
+  }
+  ref_us = current_timestamp_us() - start;
+
+  start = current_timestamp_us();
+  for (int i = 0; i < BENCHMARK_ROUNDS; ++i) {
+    DecompressMaskedRLE24(Pixels, DstLen, IT32, IT32Size, T8MK, T8MKSize, TRUE);
+  }
+  fast_us = current_timestamp_us() - start;
+
+  FreePool(Pixels);
+
+  if (CompareDecoders(IT32, IT32Size, T8MK, T8MKSize, DstLen, TRUE, 0, NULL) != 0) {
+    printf("%s: MISMATCH between decoders\n", Name);
+    return 1;
+  }
+
+  printf("%s: %u pixels, reference %lld ns, one pass %lld ns\n", Name, T8MKSize,
+    ref_us * 1000 / BENCHMARK_ROUNDS, fast_us * 1000 / BENCHMARK_ROUNDS);
+  return 0;
+}
+
+int ENTRY_POINT(int argc, char** argv) {
+  uint32_t Mismatches;
+
+  //
+  // Premultiplication must match (C * A) / 255 for all the inputs.
+  //
+  for (UINT32 Alpha = 0; Alpha <= 0xFF; ++Alpha) {
+    for (UINT32 Color = 0; Color <= 0xFF; ++Color) {
+      UINT8 Mask[1] = { (UINT8) Alpha };
+      UINT8 Src[6]  = { 0x80, (UINT8) Color, 0x80, (UINT8) (0xFF - Color), 0x80, (UINT8) (Color ^ 0x5A) };
+      if (CompareDecoders(Src, sizeof (Src), Mask, 1, sizeof (UINT32), TRUE, 0, NULL) != 0) {
+        abort();
+      }
+    }
+  }
+
+  Mismatches = RunRandom();
+
+  for (int i = 1; i < argc; ++i) {
+    uint32_t size;
+    uint8_t  *buffer;
+    if ((buffer = UserReadFile(argv[i], &size)) == NULL) {
+      printf("%s: read fail\n", argv[i]);
+      continue;
+    }
+
+    Mismatches += BenchmarkIcns(argv[i], buffer, size);
+    FreePool(buffer);
+  }
+
+  return Mismatches != 0;
+}
+
+INT32 LLVMFuzzerTestOneInput(CONST UINT8 *Data, UINTN Size) {
+  UINT32  MaskLen;
+  UINT8   *Copy;
+
+  if (Size < 3 || Size > BASE_1MB) {
+    return 0;
+  }
+
+  //
+  // First two bytes choose mask size and mode, the mask follows the stream.
+  //
+  MaskLen = ReadUnaligned16((UINT16 *) Data) % 2048;
+  if (MaskLen > Size - 2) {
+    MaskLen = (UINT32) (Size - 2);
+  }
+
+  Copy = AllocateCopyPool(Size - 2, Data + 2);
+  if (Copy == NULL) {
+    return 0;
+  }
+
+  if (CompareDecoders(Copy, (UINT32) (Size - 2 - MaskLen), Copy + Size - 2 - MaskLen, MaskLen,
+    MaskLen * sizeof (UINT32), (BOOLEAN) (Data[1] >> 7U), Data[0], NULL) != 0) {
+    abort();
+  }
+
+  FreePool(Copy);
+  return 0;
+}
@@ -28,6 +28,7 @@
 #include <stdio.h>
 #include <stdbool.h>
 #include <stdlib.h>
+#include <string.h>
 
 STATIC GUID SystemUUID = {0x5BC82C38, 0x4DB6, 0x4883, {0x85, 0x2E, 0xE7, 0x8D, 0x78, 0x0A, 0x6F, 0xE6}};
 STATIC UINT8 BoardType = 0xA; // Motherboard (BaseBoardTypeMotherBoard)
@@ -69,7 +70,253 @@ bool doDump = false;
 SMBIOS_TABLE_ENTRY_POINT        gSmbios;
 SMBIOS_TABLE_3_0_ENTRY_POINT    gSmbios3;
 
+//
+// Synthetic server table layout, memory devices are grouped by arrays.
+//
+#define SERVER_DEVICES_PER_ARRAY   16
+#define SERVER_MAX_MEMORY_DEVICES  2048
+#define SERVER_ARRAY_HANDLE        0x1000
+#define SERVER_ARRAY_MAPPED_HANDLE 0x2000
+#define SERVER_DEVICE_HANDLE       0x3000
+#define SERVER_DEVICE_MAPPED_HANDLE 0x4000
+
+STATIC
+UINT64
+GetTimeUs (
+  VOID
+  )
+{
+  struct timeval  Time;
+
+  gettimeofday (&Time, NULL);
+  return Time.tv_sec * 1000000ULL + Time.tv_usec;
+}
+
+STATIC
+VOID *
+AppendStructure (
+  IN OUT UINT8        **Walker,
+  IN     UINT8        Type,
+  IN     UINT8        Length,
+  IN     UINT16       Handle,
+  IN     CONST CHAR8  *String1  OPTIONAL,
+  IN     CONST CHAR8  *String2  OPTIONAL
+  )
+{
+  SMBIOS_STRUCTURE  *Hdr;
+  UINTN             Size;
+
+  Hdr = (SMBIOS_STRUCTURE *) *Walker;
+  ZeroMem (Hdr, Length);
+  Hdr->Type   = Type;
+  Hdr->Length = Length;
+  Hdr->Handle = Handle;
+  *Walker    += Length;
+
+  if (String1 != NULL) {
+    Size = AsciiStrSize (String1);
+    CopyMem (*Walker, String1, Size);
+    *Walker += Size;
+  }
+
+  if (String2 != NULL) {
+    Size = AsciiStrSize (String2);
+    CopyMem (*Walker, String2, Size);
+    *Walker += Size;
+  }
+
+  //
+  // Empty string set still needs double terminator.
+  //
+  if (String1 == NULL && String2 == NULL) {
+    **Walker = 0;
+    ++*Walker;
+  }
+
+  **Walker = 0;
+  ++*Walker;
+
+  return Hdr;
+}
+
+/**
+  Build memory tables similar to multi-socket servers with hundreds of DIMM slots.
+**/
+STATIC
+UINT8 *
+BuildServerTable (
+  IN  UINT32  NumDevices,
+  OUT UINT32  *TableSize
+  )
+{
+  UINT8                 *Table;
+  UINT8                 *Walker;
+  UINT32                NumArrays;
+  UINT32                Index;
+  UINT32                ArrayIndex;
+  CHAR8                 Locator[32];
+  CHAR8                 Bank[32];
+  SMBIOS_TABLE_TYPE16   *Type16;
+  SMBIOS_TABLE_TYPE17   *Type17;
+  SMBIOS_TABLE_TYPE19   *Type19;
+  SMBIOS_TABLE_TYPE20   *Type20;
+
+  NumArrays = (NumDevices + SERVER_DEVICES_PER_ARRAY - 1) / SERVER_DEVICES_PER_ARRAY;
+
+  //
+  // Each structure is followed by a string set ending with an extra terminator.
+  //
+  Table = AllocateZeroPool (
+    NumArrays * (sizeof (SMBIOS_TABLE_TYPE16) + sizeof (SMBIOS_TABLE_TYPE19) + 2 * 2)
+    + NumDevices * (sizeof (SMBIOS_TABLE_TYPE17) + sizeof (Locator) + sizeof (Bank) + 1)
+    + NumDevices * (sizeof (SMBIOS_TABLE_TYPE20) + 2)
+    + sizeof (SMBIOS_STRUCTURE) + 2
+    );
+  if (Table == NULL) {
+    return NULL;
+  }
+
+  Walker = Table;
+
+  for (ArrayIndex = 0; ArrayIndex < NumArrays; ++ArrayIndex) {
+    Type16 = AppendStructure (&Walker, SMBIOS_TYPE_PHYSICAL_MEMORY_ARRAY, sizeof (*Type16),
+      (UINT16) (SERVER_ARRAY_HANDLE + ArrayIndex), NULL, NULL);
+    Type16->Location              = MemoryArrayLocationSystemBoard;
+    Type16->Use                   = MemoryArrayUseSystemMemory;
+    Type16->MemoryErrorCorrection = MemoryErrorCorrectionMultiBitEcc;
+    Type16->MaximumCapacity       = 0x80000000;
+    Type16->MemoryErrorInformationHandle = 0xFFFE;
+    Type16->NumberOfMemoryDevices = SERVER_DEVICES_PER_ARRAY;
+
+    Type19 = AppendStructure (&Walker, SMBIOS_TYPE_MEMORY_ARRAY_MAPPED_ADDRESS, sizeof (*Type19),
+      (UINT16) (SERVER_ARRAY_MAPPED_HANDLE + ArrayIndex), NULL, NULL);
+    Type19->StartingAddress   = 0xFFFFFFFF;
+    Type19->EndingAddress     = 0xFFFFFFFF;
+    Type19->MemoryArrayHandle = (UINT16) (SERVER_ARRAY_HANDLE + ArrayIndex);
+    Type19->PartitionWidth    = SERVER_DEVICES_PER_ARRAY;
+    Type19->ExtendedStartingAddress = LShiftU64 (ArrayIndex * SERVER_DEVICES_PER_ARRAY, 34);
+    Type19->ExtendedEndingAddress   = LShiftU64 ((ArrayIndex + 1) * SERVER_DEVICES_PER_ARRAY, 34) - 1;
+  }
+
+  for (Index = 0; Index < NumDevices; ++Index) {
+    ArrayIndex = Index / SERVER_DEVICES_PER_ARRAY;
+    snprintf (Locator, sizeof (Locator), "CPU%u_DIMM_%c%u", ArrayIndex / 4,
+      'A' + (ArrayIndex % 4) * 4 + (Index % SERVER_DEVICES_PER_ARRAY) / 4, Index % 4);
+    snprintf (Bank, sizeof (Bank), "NODE %u", ArrayIndex);
+
+    Type17 = AppendStructure (&Walker, SMBIOS_TYPE_MEMORY_DEVICE, sizeof (*Type17),
+      (UINT16) (SERVER_DEVICE_HANDLE + Index), Locator, Bank);
+    Type17->MemoryArrayHandle = (UINT16) (SERVER_ARRAY_HANDLE + ArrayIndex);
+    Type17->MemoryErrorInformationHandle = 0xFFFE;
+    Type17->TotalWidth        = 72;
+    Type17->DataWidth         = 64;
+    Type17->Size              = 0x4000;
+    Type17->FormFactor        = MemoryFormFactorDimm;
+    Type17->DeviceLocator     = 1;
+    Type17->BankLocator       = 2;
+    Type17->MemoryType        = MemoryTypeDdr4;
+    Type17->Speed             = 2933;
+
+    Type20 = AppendStructure (&Walker, SMBIOS_TYPE_MEMORY_DEVICE_MAPPED_ADDRESS, sizeof (*Type20),
+      (UINT16) (SERVER_DEVICE_MAPPED_HANDLE + Index), NULL, NULL);
+    Type20->StartingAddress   = 0xFFFFFFFF;
+    Type20->EndingAddress     = 0xFFFFFFFF;
+    Type20->MemoryDeviceHandle = (UINT16) (SERVER_DEVICE_HANDLE + Index);
+    Type20->MemoryArrayMappedAddressHandle = (UINT16) (SERVER_ARRAY_MAPPED_HANDLE + ArrayIndex);
+    Type20->PartitionRowPosition = 0xFF;
+    Type20->ExtendedStartingAddress = LShiftU64 (Index, 34);
+    Type20->ExtendedEndingAddress   = LShiftU64 (Index + 1, 34) - 1;
+  }
+
+  AppendStructure (&Walker, SMBIOS_TYPE_END_OF_TABLE, sizeof (SMBIOS_STRUCTURE), 0xFEFF, NULL, NULL);
+
+  *TableSize = (UINT32) (Walker - Table);
+  return Table;
+}
+
+STATIC
+int
+BenchmarkServerTable (
+  IN UINT32  NumDevices,
+  IN UINT32  Iterations
+  )
+{
+  EFI_STATUS       Status;
+  UINT8            *Table;
+  UINT32           TableSize;
+  UINT32           Index;
+  UINT64           Start;
+  UINT64           Elapsed;
+  UINT64           Best;
+  UINT64           Total;
+  OC_CPU_INFO      CpuInfo;
+  OC_SMBIOS_TABLE  SmbiosTable;
+
+  if (NumDevices == 0 || NumDevices > SERVER_MAX_MEMORY_DEVICES || Iterations == 0) {
+    printf ("Expected 1-%u memory devices and non-zero iterations\n", SERVER_MAX_MEMORY_DEVICES);
+    return -1;
+  }
+
+  Table = BuildServerTable (NumDevices, &TableSize);
+  if (Table == NULL) {
+    printf ("Failed to build server table\n");
+    return -1;
+  }
+
+  OcCpuScanProcessor (&CpuInfo);
+
+  Best  = MAX_UINT64;
+  Total = 0;
+
+  for (Index = 0; Index < Iterations; ++Index) {
+    //
+    // OcSmbiosCreate installs the patched tables, restore the original ones.
+    //
+    gBS->InstallConfigurationTable (&gEfiSmbiosTableGuid, NULL);
+    gSmbios3.TableMaximumSize = TableSize;
+    gSmbios3.TableAddress     = (uintptr_t) Table;
+    gSmbios3.EntryPointLength = sizeof (SMBIOS_TABLE_3_0_ENTRY_POINT);
+    gBS->InstallConfigurationTable (&gEfiSmbios3TableGuid, &gSmbios3);
+
+    Start  = GetTimeUs ();
+    Status = OcSmbiosTablePrepare (&SmbiosTable);
+    if (!EFI_ERROR (Status)) {
+      Status = OcSmbiosCreate (&SmbiosTable, &SmbiosData, OcSmbiosUpdateCreate, &CpuInfo);
+      OcSmbiosTableFree (&SmbiosTable);
+    }
+    Elapsed = GetTimeUs () - Start;
+
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "Failed to patch server table - %r\n", Status));
+      FreePool (Table);
+      return -1;
+    }
+
+    Best   = MIN (Best, Elapsed);
+    Total += Elapsed;
+  }
+
+  printf (
+    "Patched %u memory devices (%u bytes) in %llu us average, %llu us best over %u iterations\n",
+    NumDevices,
+    TableSize,
+    (unsigned long long) (Total / Iterations),
+    (unsigned long long) Best,
+    Iterations
+    );
+
+  FreePool (Table);
+  return 0;
+}
+
 int ENTRY_POINT(int argc, char** argv) {
+  if (argc > 1 && strcmp (argv[1], "--server") == 0) {
+    return BenchmarkServerTable (
+      argc > 2 ? (UINT32) atoi (argv[2]) : 384,
+      argc > 3 ? (UINT32) atoi (argv[3]) : 16
+      );
+  }
+
   PcdGet32 (PcdFixedDebugPrintErrorLevel) |= DEBUG_INFO;
   PcdGet32 (PcdDebugPrintErrorLevel)      |= DEBUG_INFO;
 
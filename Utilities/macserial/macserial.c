@@ -6,12 +6,15 @@
 //
 
 #include <limits.h>
+#include <pthread.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
 #include <string.h>
+#include <sys/time.h>
 #include <time.h>
+#include <unistd.h>
 
 #ifdef __APPLE__
 #include <CoreFoundation/CoreFoundation.h>
@@ -46,6 +49,45 @@ static CFTypeRef get_ioreg_entry(const char *path, CFStringRef name, CFTypeID ty
 }
 #endif
 
+// Finalizer from splitmix64, see https://prng.di.unimi.it/splitmix64.c
+static uint64_t random_mix64(uint64_t z) {
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+// Every generated pair gets its own stream, so that the result only depends on
+// the seed and the pair index, but not on the thread generating it.
+static void random_init(RANDOMSTATE *rng, uint64_t seed, uint64_t stream) {
+  rng->state = random_mix64(seed + (stream + 1) * 0x9E3779B97F4A7C15ULL);
+}
+
+// NULL rng means system randomness.
+static uint32_t random_value(RANDOMSTATE *rng) {
+  if (!rng)
+    return pseudo_random();
+
+  rng->state += 0x9E3779B97F4A7C15ULL;
+  return (uint32_t)(random_mix64(rng->state) >> 32);
+}
+
+static uint32_t random_between(RANDOMSTATE *rng, uint32_t from, uint32_t to) {
+  if (!rng)
+    return pseudo_random_between(from, to);
+
+  uint32_t upper_bound = to + 1 - from;
+  if (upper_bound < 2)
+    return from;
+
+  uint32_t min = (uint32_t)(0x100000000ULL % upper_bound);
+  uint32_t r;
+  do {
+    r = random_value(rng);
+  } while (r < min);
+
+  return from + r % upper_bound;
+}
+
 // Apple uses various conversion tables (e.g. AppleBase34) for value encoding.
 static int32_t alpha_to_value(char c, int32_t *conv, const char *blacklist) {
   if (c < 'A' || c > 'Z')
@@ -141,7 +183,7 @@ static int32_t get_current_model(void) {
   return -1;
 }
 
-static uint32_t get_production_year(AppleModel model, bool print) {
+static uint32_t get_production_year(AppleModel model, bool print, RANDOMSTATE *rng) {
   uint32_t *years = &AppleModelYear[model][0];
   uint32_t num = 0;
 
@@ -157,7 +199,7 @@ static uint32_t get_production_year(AppleModel model, bool print) {
   if (ApplePreferredModelYear[model] > 0)
     return ApplePreferredModelYear[model];
 
-  return years[pseudo_random() % num];
+  return years[random_value(rng) % num];
 }
 
 static const char *get_model_code(AppleModel model, bool print) {
@@ -423,7 +465,7 @@ static bool get_serial_info(const char *serial, SERIALINFO *info, bool print) {
   return true;
 }
 
-static bool get_serial(SERIALINFO *info) {
+static bool get_serial(SERIALINFO *info, RANDOMSTATE *rng) {
   if (info->modelIndex < 0 && info->model[0] == '\0') {
     printf("ERROR: Unable to determine model!\n");
     return false;
@@ -450,12 +492,12 @@ static bool get_serial(SERIALINFO *info) {
     if (info->modelIndex < 0)
       info->decodedYear = country_len == COUNTRY_OLD_LEN ? SERIAL_YEAR_OLD_MAX : SERIAL_YEAR_NEW_MID;
     else
-      info->decodedYear = (int32_t)get_production_year((AppleModel)info->modelIndex, false);
+      info->decodedYear = (int32_t)get_production_year((AppleModel)info->modelIndex, false, rng);
   }
 
   // Last week is too rare to care
   if (info->decodedWeek < 0)
-    info->decodedWeek = (int32_t)pseudo_random_between(SERIAL_WEEK_MIN, SERIAL_WEEK_MAX-1);
+    info->decodedWeek = (int32_t)random_between(rng, SERIAL_WEEK_MIN, SERIAL_WEEK_MAX-1);
 
   if (country_len == COUNTRY_OLD_LEN) {
     if (info->decodedYear < SERIAL_YEAR_OLD_MIN || info->decodedYear > SERIAL_YEAR_OLD_MAX) {
@@ -482,7 +524,7 @@ static bool get_serial(SERIALINFO *info) {
   }
 
   if (info->decodedLine < 0)
-    info->decodedLine = (int32_t)pseudo_random_between(SERIAL_LINE_MIN, SERIAL_LINE_MAX);
+    info->decodedLine = (int32_t)random_between(rng, SERIAL_LINE_MIN, SERIAL_LINE_MAX);
 
   int32_t rmin = line_to_rmin(info->decodedLine);
 
@@ -502,7 +544,7 @@ static bool get_serial(SERIALINFO *info) {
   return true;
 }
 
-static void get_mlb(SERIALINFO *info, char *dst, size_t sz) {
+static void get_mlb(SERIALINFO *info, char *dst, size_t sz, RANDOMSTATE *rng) {
   // This is a direct reverse from CCC, rework it later...
   if (info->modelIndex < 0) {
     printf("WARN: Unknown model, assuming default!\n");
@@ -570,21 +612,302 @@ static void get_mlb(SERIALINFO *info, char *dst, size_t sz) {
       // The loop is not present in CCC, but it throws an exception here,
       // and effectively generates nothing. The logic is crazy :/.
       // Also, it was likely meant to be written as pseudo_random() % 0x8000.
-      while (!get_ascii7(pseudo_random_between(0, 0x7FFE) * 0x73BA1C, code, sizeof(code)));
+      while (!get_ascii7(random_between(rng, 0, 0x7FFE) * 0x73BA1C, code, sizeof(code)));
       const char *board = get_board_code(info->modelIndex, false);
-      char suffix = AppleBase34Reverse[pseudo_random() % 34];
+      char suffix = AppleBase34Reverse[random_value(rng) % 34];
       snprintf(dst, sz, "%s%d%02d0%s%s%c", info->country, year, week, code, board, suffix);
     } else {
-      const char *part1 = MLBBlock1[pseudo_random() % ARRAY_SIZE(MLBBlock1)];
-      const char *part2 = MLBBlock2[pseudo_random() % ARRAY_SIZE(MLBBlock2)];
+      const char *part1 = MLBBlock1[random_value(rng) % ARRAY_SIZE(MLBBlock1)];
+      const char *part2 = MLBBlock2[random_value(rng) % ARRAY_SIZE(MLBBlock2)];
       const char *board = get_board_code(info->modelIndex, false);
-      const char *part3 = MLBBlock3[pseudo_random() % ARRAY_SIZE(MLBBlock3)];
+      const char *part3 = MLBBlock3[random_value(rng) % ARRAY_SIZE(MLBBlock3)];
 
       snprintf(dst, sz, "%s%d%02d%s%s%s%s", info->country, year, week, part1, part2, board, part3);
     }
   } while (!verify_mlb_checksum(dst, strlen(dst)));
 }
 
+// Candidates are generated in chunks by the workers and consumed strictly in order
+// by the writer, this keeps seeded output identical regardless of the job count.
+#define BULK_CHUNK_SIZE 256
+#define BULK_CHUNKS_PER_JOB 4
+// Give up when most of the candidates turn out to be duplicates (e.g. fully fixed serial).
+#define BULK_MAX_ATTEMPT_FACTOR 64
+
+// Large enough for any combination of SERIALINFO components, so that
+// concatenating them can never truncate. Valid serials are shorter.
+#define BULK_SERIAL_SIZE (sizeof(((SERIALINFO *)0)->country) + sizeof(((SERIALINFO *)0)->year) \
+  + sizeof(((SERIALINFO *)0)->week) + sizeof(((SERIALINFO *)0)->line) + sizeof(((SERIALINFO *)0)->model))
+
+typedef struct {
+  char serial[BULK_SERIAL_SIZE];
+  char mlb[MLB_MAX_SIZE];
+  bool valid;
+} BULKCANDIDATE;
+
+typedef struct {
+  uint64_t number;
+  bool ready;
+  BULKCANDIDATE candidates[BULK_CHUNK_SIZE];
+} BULKCHUNK;
+
+typedef struct {
+  pthread_mutex_t lock;
+  pthread_cond_t produced;
+  pthread_cond_t consumed;
+  const SERIALINFO *info;
+  uint64_t seed;
+  BULKCHUNK *chunks;
+  uint32_t num_chunks;
+  uint64_t next_chunk;
+  uint64_t done_chunks;
+  bool stop;
+} BULKCONTEXT;
+
+typedef struct {
+  uint64_t *slots;
+  uint64_t mask;
+} BULKHASHSET;
+
+static uint64_t get_current_time_us(void) {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return (uint64_t)tv.tv_sec * 1000000ULL + (uint64_t)tv.tv_usec;
+}
+
+// FNV-1a, zero is reserved for empty hash set slots.
+static uint64_t bulk_hash(const char *str) {
+  uint64_t hash = 0xCBF29CE484222325ULL;
+  while (*str) {
+    hash ^= (uint8_t)*str++;
+    hash *= 0x100000001B3ULL;
+  }
+  return hash != 0 ? hash : 1;
+}
+
+static bool bulk_set_init(BULKHASHSET *set, uint32_t count) {
+  uint64_t size = 1024;
+  while (size < (uint64_t)count * 2)
+    size <<= 1;
+  set->slots = calloc((size_t)size, sizeof(set->slots[0]));
+  set->mask = size - 1;
+  return set->slots != NULL;
+}
+
+static uint64_t *bulk_set_find(BULKHASHSET *set, uint64_t hash) {
+  uint64_t i = hash & set->mask;
+  while (set->slots[i] != 0 && set->slots[i] != hash)
+    i = (i + 1) & set->mask;
+  return &set->slots[i];
+}
+
+static void bulk_generate(BULKCONTEXT *ctx, uint64_t index, BULKCANDIDATE *cand) {
+  RANDOMSTATE rng;
+  random_init(&rng, ctx->seed, index);
+
+  SERIALINFO tmp = *ctx->info;
+  cand->valid = get_serial(&tmp, &rng);
+  if (cand->valid) {
+    snprintf(cand->serial, sizeof(cand->serial), "%s%s%s%s%s", tmp.country, tmp.year, tmp.week, tmp.line, tmp.model);
+    get_mlb(&tmp, cand->mlb, sizeof(cand->mlb), &rng);
+    cand->valid = strncmp(cand->mlb, "FAIL", 4) != 0;
+  }
+}
+
+static void *bulk_worker(void *arg) {
+  BULKCONTEXT *ctx = arg;
+
+  pthread_mutex_lock(&ctx->lock);
+  while (!ctx->stop) {
+    if (ctx->next_chunk >= ctx->done_chunks + ctx->num_chunks) {
+      pthread_cond_wait(&ctx->consumed, &ctx->lock);
+      continue;
+    }
+
+    uint64_t number = ctx->next_chunk++;
+    BULKCHUNK *chunk = &ctx->chunks[number % ctx->num_chunks];
+    pthread_mutex_unlock(&ctx->lock);
+
+    for (uint32_t i = 0; i < BULK_CHUNK_SIZE; i++)
+      bulk_generate(ctx, number * BULK_CHUNK_SIZE + i, &chunk->candidates[i]);
+
+    pthread_mutex_lock(&ctx->lock);
+    chunk->number = number;
+    chunk->ready = true;
+    pthread_cond_broadcast(&ctx->produced);
+  }
+  pthread_mutex_unlock(&ctx->lock);
+
+  return NULL;
+}
+
+static int generate_bulk(SERIALINFO *info, uint32_t limit, BULKOPTIONS *opts) {
+  // Report configuration errors once instead of per candidate.
+  SERIALINFO tmp = *info;
+  RANDOMSTATE rng;
+  char mlb[MLB_MAX_SIZE];
+  random_init(&rng, 0, 0);
+  if (!get_serial(&tmp, &rng))
+    return EXIT_FAILURE;
+  get_mlb(&tmp, mlb, sizeof(mlb), &rng);
+  info->modelIndex = tmp.modelIndex;
+
+  uint32_t jobs = opts->jobs;
+  if (jobs == 0) {
+#ifdef _SC_NPROCESSORS_ONLN
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    jobs = cpus > 0 ? (uint32_t)cpus : 1;
+#else
+    jobs = 4;
+#endif
+  }
+
+  uint64_t seed = opts->seed;
+  if (!opts->seeded)
+    seed = ((uint64_t)pseudo_random() << 32U) | pseudo_random();
+
+  FILE *out = stdout;
+  if (opts->output && strcmp(opts->output, "-") != 0) {
+    out = fopen(opts->output, "w");
+    if (!out) {
+      printf("ERROR: Cannot open %s for writing!\n", opts->output);
+      return EXIT_FAILURE;
+    }
+  }
+
+  BULKHASHSET serials;
+  BULKCONTEXT ctx = {
+    .info       = info,
+    .seed       = seed,
+    .num_chunks = jobs * BULK_CHUNKS_PER_JOB
+  };
+  pthread_t *threads = calloc(jobs, sizeof(threads[0]));
+  ctx.chunks = calloc(ctx.num_chunks, sizeof(ctx.chunks[0]));
+  bool set_ok = bulk_set_init(&serials, limit);
+  if (!threads || !ctx.chunks || !set_ok) {
+    printf("ERROR: Cannot allocate memory for %u pairs!\n", limit);
+    free(threads);
+    free(ctx.chunks);
+    free(serials.slots);
+    if (out != stdout)
+      fclose(out);
+    return EXIT_FAILURE;
+  }
+
+  pthread_mutex_init(&ctx.lock, NULL);
+  pthread_cond_init(&ctx.produced, NULL);
+  pthread_cond_init(&ctx.consumed, NULL);
+
+  uint64_t start = get_current_time_us();
+
+  uint32_t num_threads = 0;
+  for (uint32_t i = 0; i < jobs; i++) {
+    if (pthread_create(&threads[num_threads], NULL, bulk_worker, &ctx) == 0)
+      num_threads++;
+  }
+
+  const char *model = ApplePlatformData[info->modelIndex].productName;
+  uint64_t max_attempts = (uint64_t)limit * BULK_MAX_ATTEMPT_FACTOR + BULK_CHUNK_SIZE;
+  uint64_t attempts = 0, duplicates = 0, invalid = 0;
+  uint32_t generated = 0;
+
+  if (opts->format == BULK_FORMAT_JSON)
+    fprintf(out, "[\n");
+  else
+    fprintf(out, "serial,mlb,model\n");
+
+  for (uint64_t number = 0; num_threads > 0 && generated < limit && attempts < max_attempts; number++) {
+    BULKCHUNK *chunk = &ctx.chunks[number % ctx.num_chunks];
+
+    pthread_mutex_lock(&ctx.lock);
+    while (!chunk->ready || chunk->number != number)
+      pthread_cond_wait(&ctx.produced, &ctx.lock);
+    pthread_mutex_unlock(&ctx.lock);
+
+    for (uint32_t i = 0; i < BULK_CHUNK_SIZE && generated < limit; i++) {
+      BULKCANDIDATE *cand = &chunk->candidates[i];
+      attempts++;
+
+      if (!cand->valid) {
+        invalid++;
+        continue;
+      }
+
+      // MLB space is much smaller (few thousands per model), so only serials are unique.
+      uint64_t hash = bulk_hash(cand->serial);
+      uint64_t *slot = bulk_set_find(&serials, hash);
+      if (*slot != 0) {
+        duplicates++;
+        continue;
+      }
+      *slot = hash;
+
+      if (opts->format == BULK_FORMAT_JSON)
+        fprintf(out, "%s  {\"serial\": \"%s\", \"mlb\": \"%s\", \"model\": \"%s\"}",
+          generated > 0 ? ",\n" : "", cand->serial, cand->mlb, model);
+      else
+        fprintf(out, "%s,%s,\"%s\"\n", cand->serial, cand->mlb, model);
+
+      generated++;
+    }
+
+    pthread_mutex_lock(&ctx.lock);
+    chunk->ready = false;
+    ctx.done_chunks++;
+    pthread_cond_broadcast(&ctx.consumed);
+    pthread_mutex_unlock(&ctx.lock);
+  }
+
+  pthread_mutex_lock(&ctx.lock);
+  ctx.stop = true;
+  pthread_cond_broadcast(&ctx.consumed);
+  pthread_mutex_unlock(&ctx.lock);
+
+  for (uint32_t i = 0; i < num_threads; i++)
+    pthread_join(threads[i], NULL);
+
+  if (opts->format == BULK_FORMAT_JSON)
+    fprintf(out, "%s]\n", generated > 0 ? "\n" : "");
+
+  bool write_ok = !ferror(out);
+  if (out != stdout)
+    write_ok = fclose(out) == 0 && write_ok;
+  else
+    write_ok = fflush(out) == 0 && write_ok;
+
+  uint64_t elapsed = get_current_time_us() - start;
+  double seconds = elapsed > 0 ? (double)elapsed / 1000000.0 : 0.000001;
+
+  fprintf(stderr, "Generated %u unique pairs (%llu candidates, %llu duplicates, %llu invalid) "
+    "in %.3f s with %u threads, %.0f pairs/s, seed 0x%016llX\n",
+    generated, (unsigned long long)attempts, (unsigned long long)duplicates, (unsigned long long)invalid,
+    seconds, num_threads, (double)generated / seconds, (unsigned long long)seed);
+
+  pthread_cond_destroy(&ctx.consumed);
+  pthread_cond_destroy(&ctx.produced);
+  pthread_mutex_destroy(&ctx.lock);
+  free(threads);
+  free(ctx.chunks);
+  free(serials.slots);
+
+  if (num_threads == 0) {
+    fprintf(stderr, "ERROR: Cannot start generation threads!\n");
+    return EXIT_FAILURE;
+  }
+
+  if (!write_ok) {
+    fprintf(stderr, "ERROR: Cannot write generated pairs!\n");
+    return EXIT_FAILURE;
+  }
+
+  if (generated < limit) {
+    fprintf(stderr, "ERROR: Only %u out of %u unique pairs could be generated!\n", generated, limit);
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+
 static void get_system_info(void) {
 #ifdef __APPLE__
   CFDataRef model    = get_ioreg_entry("IODeviceTree:/", CFSTR("model"), CFDataGetTypeID());
@@ -695,7 +1018,8 @@ static int usage(const char *app) {
     " --list           (-l)  list known mac models\n"
     " --list-products  (-lp) list known product codes\n"
     " --mlb <serial>         generate MLB based on serial\n"
-    " --sys            (-s)  get system info\n\n"
+    " --sys            (-s)  get system info\n"
+    " --bulk           (-b)  generate --num unique pairs on all cores\n\n"
     "Tuning options:\n"
     " --model <model>  (-m)  mac model used for generation\n"
     " --num <num>      (-n)  number of generated pairs\n"
@@ -704,7 +1028,12 @@ static int usage(const char *app) {
     " --country <loc>  (-c)  country location used for generation\n"
     " --copy <copy>    (-o)  production copy index\n"
     " --line <line>    (-e)  production line\n"
-    " --platform <ppp> (-p)  platform code used for generation\n\n", app);
+    " --platform <ppp> (-p)  platform code used for generation\n\n"
+    "Bulk options:\n"
+    " --format <fmt>   (-f)  output format, csv (default) or json\n"
+    " --output <file>        output file, - for stdout (default)\n"
+    " --jobs <num>     (-j)  number of threads, all cores by default\n"
+    " --seed <num>           seed for reproducible generation\n\n", app);
 
   return EXIT_FAILURE;
 }
@@ -720,6 +1049,9 @@ int main(int argc, char *argv[]) {
     .decodedLine = -1
   };
   int32_t limit = 10;
+  BULKOPTIONS bulk = {
+    .format = BULK_FORMAT_CSV
+  };
 
   for (int i = 1; i < argc; i++) {
     if (!strcmp(argv[i], "-h") || !strcmp(argv[i], "--help")) {
@@ -755,6 +1087,33 @@ int main(int argc, char *argv[]) {
       passed_serial = argv[i];
     } else if (!strcmp(argv[i], "-s") || !strcmp(argv[i], "--sys")) {
       mode = MODE_SYSTEM_INFO;
+    } else if (!strcmp(argv[i], "-b") || !strcmp(argv[i], "--bulk")) {
+      mode = MODE_GENERATE_BULK;
+    } else if (!strcmp(argv[i], "-f") || !strcmp(argv[i], "--format")) {
+      if (++i == argc) return usage(argv[0]);
+      if (!strcmp(argv[i], "csv")) {
+        bulk.format = BULK_FORMAT_CSV;
+      } else if (!strcmp(argv[i], "json")) {
+        bulk.format = BULK_FORMAT_JSON;
+      } else {
+        printf("Unsupported output format %s!\n", argv[i]);
+        return EXIT_FAILURE;
+      }
+    } else if (!strcmp(argv[i], "--output")) {
+      if (++i == argc) return usage(argv[0]);
+      bulk.output = argv[i];
+    } else if (!strcmp(argv[i], "-j") || !strcmp(argv[i], "--jobs")) {
+      if (++i == argc) return usage(argv[0]);
+      int32_t jobs = atoi(argv[i]);
+      if (jobs <= 0 || jobs > 1024) {
+        printf("Jobs %d is out of valid range [1, 1024]!\n", jobs);
+        return EXIT_FAILURE;
+      }
+      bulk.jobs = (uint32_t)jobs;
+    } else if (!strcmp(argv[i], "--seed")) {
+      if (++i == argc) return usage(argv[0]);
+      bulk.seed = strtoull(argv[i], NULL, 0);
+      bulk.seeded = true;
     } else if (!strcmp(argv[i], "-m") || !strcmp(argv[i], "--model")) {
       if (mode == MODE_SYSTEM_INFO) mode = MODE_GENERATE_CURRENT;
       if (++i == argc) return usage(argv[0]);
@@ -854,7 +1213,7 @@ int main(int argc, char *argv[]) {
     for (int32_t j = 0; j < APPLE_MODEL_MAX; j++) {
       printf("%14s: %s\n", "Model", ApplePlatformData[j].productName);
       printf("%14s: ", "Prod years");
-      get_production_year((AppleModel)j, true);
+      get_production_year((AppleModel)j, true, NULL);
       printf("%14s: %s\n", "Base Serial", ApplePlatformData[j].serialNumber);
       printf("%14s: ", "Model codes");
       get_model_code((AppleModel)j, true);
@@ -875,7 +1234,7 @@ int main(int argc, char *argv[]) {
   } else if (mode == MODE_GENERATE_MLB) {
     if (get_serial_info(passed_serial, &info, false)) {
       char mlb[MLB_MAX_SIZE];
-      get_mlb(&info, mlb, MLB_MAX_SIZE);
+      get_mlb(&info, mlb, MLB_MAX_SIZE, NULL);
       printf("%s\n", mlb);
     }
   } else if (mode == MODE_GENERATE_CURRENT) {
@@ -883,20 +1242,24 @@ int main(int argc, char *argv[]) {
       info.modelIndex = get_current_model();
     for (int32_t i = 0; i < limit; i++) {
       SERIALINFO tmp = info;
-      if (get_serial(&tmp)) {
+      if (get_serial(&tmp, NULL)) {
         char mlb[MLB_MAX_SIZE];
-        get_mlb(&tmp, mlb, MLB_MAX_SIZE);
+        get_mlb(&tmp, mlb, MLB_MAX_SIZE, NULL);
         printf("%s%s%s%s%s | %s\n", tmp.country, tmp.year, tmp.week, tmp.line, tmp.model, mlb);
       }
     }
+  } else if (mode == MODE_GENERATE_BULK) {
+    if (info.modelIndex < 0)
+      info.modelIndex = get_current_model();
+    return generate_bulk(&info, (uint32_t)limit, &bulk);
   } else if (mode == MODE_GENERATE_ALL) {
     for (int32_t i = 0; i < APPLE_MODEL_MAX; i++) {
       info.modelIndex = i;
       for (int32_t j = 0; j < limit; j++) {
         SERIALINFO tmp = info;
-        if (get_serial(&tmp)) {
+        if (get_serial(&tmp, NULL)) {
           char mlb[MLB_MAX_SIZE];
-          get_mlb(&tmp, mlb, MLB_MAX_SIZE);
+          get_mlb(&tmp, mlb, MLB_MAX_SIZE, NULL);
           printf("%14s | %s%s%s%s%s | %s\n", ApplePlatformData[info.modelIndex].productName,
             tmp.country, tmp.year, tmp.week, tmp.line, tmp.model, mlb);
         }
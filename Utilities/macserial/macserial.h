@@ -11,7 +11,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 
-#define PROGRAM_VERSION "2.1.7"
+#define PROGRAM_VERSION "2.1.8"
 
 #define ARRAY_SIZE(arr) (sizeof(arr) / sizeof((arr)[0]))
 
@@ -86,7 +86,25 @@ typedef enum {
   MODE_GENERATE_MLB,
   MODE_GENERATE_CURRENT,
   MODE_GENERATE_ALL,
-  MODE_GENERATE_DERIVATIVES
+  MODE_GENERATE_DERIVATIVES,
+  MODE_GENERATE_BULK
 } PROGRAMMODE;
 
+typedef struct {
+  uint64_t state;
+} RANDOMSTATE;
+
+typedef enum {
+  BULK_FORMAT_CSV,
+  BULK_FORMAT_JSON
+} BULKFORMAT;
+
+typedef struct {
+  BULKFORMAT format;
+  const char *output;
+  uint32_t jobs;
+  uint64_t seed;
+  bool seeded;
+} BULKOPTIONS;
+
 #endif // GENSERIAL_H
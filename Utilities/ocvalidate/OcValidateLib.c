@@ -434,7 +434,8 @@ FindArrayDuplication (
   IN  VOID               *First,
   IN  UINTN              Number,
   IN  UINTN              Size,
-  IN  DUPLICATION_CHECK  DupChecker
+  IN  DUPLICATION_CHECK  DupChecker,
+  IN  DUPLICATION_HASH   DupHasher  OPTIONAL
   )
 {
   UINT32        ErrorCount;
@@ -442,9 +443,76 @@ FindArrayDuplication (
   UINTN         Index2;
   CONST UINT8   *PrimaryEntry;
   CONST UINT8   *SecondaryEntry;
+  UINT32        *Hashes;
+  UINTN         *NextSameHash;
+  UINTN         *Table;
+  UINTN         TableSize;
+  UINTN         Slot;
 
   ErrorCount = 0;
 
+  if (DupHasher != NULL && Number > 1) {
+    TableSize = 1;
+    while (TableSize < Number * 2) {
+      TableSize <<= 1;
+    }
+
+    Hashes       = AllocatePool (Number * sizeof (*Hashes));
+    NextSameHash = AllocatePool (Number * sizeof (*NextSameHash));
+    Table        = AllocatePool (TableSize * sizeof (*Table));
+
+    if (Hashes != NULL && NextSameHash != NULL && Table != NULL) {
+      SetMem (Table, TableSize * sizeof (*Table), 0xFF);
+
+      //
+      // Chain each entry to the next entry with the same hash. Walking backwards
+      // keeps every chain in ascending order, so that the diagnostics are printed
+      // in the same order as with pairwise comparison.
+      //
+      for (Index = Number; Index > 0; --Index) {
+        Hashes[Index - 1] = DupHasher ((UINT8 *) First + Size * (Index - 1));
+
+        Slot = Hashes[Index - 1] & (TableSize - 1);
+        while (Table[Slot] != MAX_UINTN && Hashes[Table[Slot]] != Hashes[Index - 1]) {
+          Slot = (Slot + 1) & (TableSize - 1);
+        }
+
+        NextSameHash[Index - 1] = Table[Slot];
+        Table[Slot]             = Index - 1;
+      }
+
+      for (Index = 0; Index < Number; ++Index) {
+        for (Index2 = NextSameHash[Index]; Index2 != MAX_UINTN; Index2 = NextSameHash[Index2]) {
+          PrimaryEntry   = (UINT8 *) First + Size * Index;
+          SecondaryEntry = (UINT8 *) First + Size * Index2;
+          if (DupChecker (PrimaryEntry, SecondaryEntry)) {
+            DEBUG ((DEBUG_WARN, "at Index %u and %u!\n", Index, Index2));
+            ++ErrorCount;
+          }
+        }
+      }
+
+      FreePool (Hashes);
+      FreePool (NextSameHash);
+      FreePool (Table);
+
+      return ErrorCount;
+    }
+
+    //
+    // Fall back to pairwise comparison on allocation failure.
+    //
+    if (Hashes != NULL) {
+      FreePool (Hashes);
+    }
+    if (NextSameHash != NULL) {
+      FreePool (NextSameHash);
+    }
+    if (Table != NULL) {
+      FreePool (Table);
+    }
+  }
+
   for (Index = 0; Index < Number; ++Index) {
     for (Index2 = Index + 1; Index2 < Number; ++Index2) {
       //
@@ -466,6 +534,34 @@ FindArrayDuplication (
   return ErrorCount;
 }
 
+UINT32
+StringHash (
+  IN  CONST CHAR8  *String,
+  IN  UINT32       Seed
+  )
+{
+  UINT32  Hash;
+
+  //
+  // FNV-1a.
+  //
+  Hash = Seed ^ 2166136261U;
+  while (*String != '\0') {
+    Hash = (Hash ^ (UINT8) *String) * 16777619U;
+    ++String;
+  }
+
+  return Hash;
+}
+
+UINT32
+StringEntryHash (
+  IN  CONST VOID  *Entry
+  )
+{
+  return StringHash (OC_BLOB_GET (*(CONST OC_STRING **) Entry), 0);
+}
+
 BOOLEAN
 StringIsDuplicated (
   IN  CONST CHAR8  *EntrySection,
@@ -196,13 +196,27 @@ BOOLEAN
   IN  CONST VOID  *SecondaryEntry
   );
 
+/**
+  Compute hash of the fields compared by DUPLICATION_CHECK.
+  Entries considered duplicated by DUPLICATION_CHECK must have equal hashes.
+**/
+typedef
+UINT32
+(*DUPLICATION_HASH) (
+  IN  CONST VOID  *Entry
+  );
+
 /**
   Check if one array has duplicated entries.
 
+  When DupHasher is provided, only entries with equal hashes are compared, which avoids
+  comparing every pair of entries. Duplications are reported in the same order either way.
+
   @param[in]  First       Pointer to the first object of the array to be checked, converted to a VOID*.
   @param[in]  Number      Number of elements in the array pointed to by First.
   @param[in]  Size        Size in bytes of each element in the array.
   @param[in]  DupChecker  Pointer to a comparator function which returns TRUE if duplication is found. See DUPLICATION_CHECK for function prototype.
+  @param[in]  DupHasher   Pointer to a hash function matching DupChecker, optional. See DUPLICATION_HASH for function prototype.
 
   @return     Number of duplications detected, which are counted to the total number of errors discovered.
 **/
@@ -211,7 +225,34 @@ FindArrayDuplication (
   IN  VOID               *First,
   IN  UINTN              Number,
   IN  UINTN              Size,
-  IN  DUPLICATION_CHECK  DupChecker
+  IN  DUPLICATION_CHECK  DupChecker,
+  IN  DUPLICATION_HASH   DupHasher  OPTIONAL
+  );
+
+/**
+  Compute hash of a string for use in DUPLICATION_HASH functions.
+
+  @param[in]  String      String to be hashed.
+  @param[in]  Seed        Previous hash to combine with, or 0.
+
+  @return     Hash of String.
+**/
+UINT32
+StringHash (
+  IN  CONST CHAR8  *String,
+  IN  UINT32       Seed
+  );
+
+/**
+  DUPLICATION_HASH function for arrays of OC_STRING pointers, such as OC_ASSOC keys.
+
+  @param[in]  Entry       Pointer to an OC_STRING pointer, converted to a VOID*.
+
+  @return     Hash of the string.
+**/
+UINT32
+StringEntryHash (
+  IN  CONST VOID  *Entry
   );
 
 /**
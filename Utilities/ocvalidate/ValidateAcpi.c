@@ -48,6 +48,26 @@ ACPIAddHasDuplication (
   return StringIsDuplicated ("ACPI->Add", ACPIAddPrimaryPathString, ACPIAddSecondaryPathString);
 }
 
+/**
+  Callback function to hash Path in ACPI->Add.
+
+  @param[in]  Entry           Entry to be hashed.
+
+  @return     Hash matching ACPIAddHasDuplication.
+**/
+STATIC
+UINT32
+ACPIAddHash (
+  IN  CONST VOID  *Entry
+  )
+{
+  CONST OC_ACPI_ADD_ENTRY    *ACPIAddEntry;
+
+  ACPIAddEntry = *(CONST OC_ACPI_ADD_ENTRY **) Entry;
+
+  return StringHash (OC_BLOB_GET (&ACPIAddEntry->Path), 0);
+}
+
 STATIC
 UINT32
 CheckACPIAdd (
@@ -93,7 +113,8 @@ CheckACPIAdd (
     UserAcpi->Add.Values,
     UserAcpi->Add.Count,
     sizeof (UserAcpi->Add.Values[0]),
-    ACPIAddHasDuplication
+    ACPIAddHasDuplication,
+    ACPIAddHash
     );
 
   return ErrorCount;
@@ -122,7 +122,8 @@ CheckDevicePropertiesAdd (
       PropertyMap->Keys,
       PropertyMap->Count,
       sizeof (PropertyMap->Keys[0]),
-      DevPropsAddHasDuplication
+      DevPropsAddHasDuplication,
+      StringEntryHash
       );
   }
 
@@ -133,7 +134,8 @@ CheckDevicePropertiesAdd (
     UserDevProp->Add.Keys,
     UserDevProp->Add.Count,
     sizeof (UserDevProp->Add.Keys[0]),
-    DevPropsAddHasDuplication
+    DevPropsAddHasDuplication,
+    StringEntryHash
     );
 
   return ErrorCount;
@@ -187,7 +189,8 @@ CheckDevicePropertiesDelete (
       UserDevProp->Delete.Values[DeviceIndex]->Values,
       UserDevProp->Delete.Values[DeviceIndex]->Count,
       sizeof (UserDevProp->Delete.Values[DeviceIndex]->Values[0]),
-      DevPropsDeleteHasDuplication
+      DevPropsDeleteHasDuplication,
+      StringEntryHash
       );
   }
 
@@ -198,7 +201,8 @@ CheckDevicePropertiesDelete (
     UserDevProp->Delete.Keys,
     UserDevProp->Delete.Count,
     sizeof (UserDevProp->Delete.Keys[0]),
-    DevPropsDeleteHasDuplication
+    DevPropsDeleteHasDuplication,
+    StringEntryHash
     );
 
   return ErrorCount;
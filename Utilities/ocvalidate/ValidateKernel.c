@@ -118,6 +118,46 @@ KernelForceHasDuplication (
   return StringIsDuplicated ("Kernel->Force", KernelForcePrimaryBundlePathString, KernelForceSecondaryBundlePathString);
 }
 
+/**
+  Callback function to hash BundlePath in Kernel->Add and Kernel->Force.
+
+  @param[in]  Entry           Entry to be hashed.
+
+  @return     Hash matching KernelAddHasDuplication and KernelForceHasDuplication.
+**/
+STATIC
+UINT32
+KernelBundlePathHash (
+  IN  CONST VOID  *Entry
+  )
+{
+  CONST OC_KERNEL_ADD_ENTRY          *KernelAddEntry;
+
+  KernelAddEntry = *(CONST OC_KERNEL_ADD_ENTRY **) Entry;
+
+  return StringHash (OC_BLOB_GET (&KernelAddEntry->BundlePath), 0);
+}
+
+/**
+  Callback function to hash Identifier in Kernel->Block.
+
+  @param[in]  Entry           Entry to be hashed.
+
+  @return     Hash matching KernelBlockHasDuplication.
+**/
+STATIC
+UINT32
+KernelBlockHash (
+  IN  CONST VOID  *Entry
+  )
+{
+  CONST OC_KERNEL_BLOCK_ENTRY        *KernelBlockEntry;
+
+  KernelBlockEntry = *(CONST OC_KERNEL_BLOCK_ENTRY **) Entry;
+
+  return StringHash (OC_BLOB_GET (&KernelBlockEntry->Identifier), 0);
+}
+
 STATIC
 UINT32
 CheckKernelAdd (
@@ -274,7 +314,8 @@ CheckKernelAdd (
     UserKernel->Add.Values,
     UserKernel->Add.Count,
     sizeof (UserKernel->Add.Values[0]),
-    KernelAddHasDuplication
+    KernelAddHasDuplication,
+    KernelBundlePathHash
     );
 
   return ErrorCount;
@@ -349,7 +390,8 @@ CheckKernelBlock (
     UserKernel->Block.Values,
     UserKernel->Block.Count,
     sizeof (UserKernel->Block.Values[0]),
-    KernelBlockHasDuplication
+    KernelBlockHasDuplication,
+    KernelBlockHash
     );
 
   return ErrorCount;
@@ -494,7 +536,8 @@ CheckKernelForce (
     UserKernel->Force.Values,
     UserKernel->Force.Count,
     sizeof (UserKernel->Force.Values[0]),
-    KernelForceHasDuplication
+    KernelForceHasDuplication,
+    KernelBundlePathHash
     );
 
   return ErrorCount;
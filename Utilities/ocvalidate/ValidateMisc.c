@@ -109,6 +109,32 @@ MiscToolsHasDuplication (
   return FALSE;
 }
 
+/**
+  Callback function to hash Arguments and Path in Misc->Entries and Misc->Tools.
+
+  @param[in]  Entry           Entry to be hashed.
+
+  @return     Hash matching MiscEntriesHasDuplication and MiscToolsHasDuplication.
+**/
+STATIC
+UINT32
+MiscToolsHash (
+  IN  CONST VOID  *Entry
+  )
+{
+  //
+  // NOTE: Entries and Tools share the same constructor.
+  //
+  CONST OC_MISC_TOOLS_ENTRY         *MiscToolsEntry;
+
+  MiscToolsEntry = *(CONST OC_MISC_TOOLS_ENTRY **) Entry;
+
+  return StringHash (
+    OC_BLOB_GET (&MiscToolsEntry->Path),
+    StringHash (OC_BLOB_GET (&MiscToolsEntry->Arguments), 0)
+    );
+}
+
 /**
   Validate if SecureBootModel has allowed value.
 
@@ -380,7 +406,8 @@ CheckMiscEntries (
     UserMisc->Entries.Values,
     UserMisc->Entries.Count,
     sizeof (UserMisc->Entries.Values[0]),
-    MiscEntriesHasDuplication
+    MiscEntriesHasDuplication,
+    MiscToolsHash
     );
 
   return ErrorCount;
@@ -542,7 +569,8 @@ CheckMiscTools (
     UserMisc->Tools.Values,
     UserMisc->Tools.Count,
     sizeof (UserMisc->Tools.Values[0]),
-    MiscToolsHasDuplication
+    MiscToolsHasDuplication,
+    MiscToolsHash
     );
 
   return ErrorCount;
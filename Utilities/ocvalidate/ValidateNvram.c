@@ -201,7 +201,8 @@ CheckNvramAdd (
       VariableMap->Keys,
       VariableMap->Count,
       sizeof (VariableMap->Keys[0]),
-      NvramAddHasDuplication
+      NvramAddHasDuplication,
+      StringEntryHash
       );
 
     //
@@ -217,7 +218,8 @@ CheckNvramAdd (
     UserNvram->Add.Keys,
     UserNvram->Add.Count,
     sizeof (UserNvram->Add.Keys[0]),
-    NvramAddHasDuplication
+    NvramAddHasDuplication,
+    StringEntryHash
     );
 
   return ErrorCount;
@@ -271,7 +273,8 @@ CheckNvramDelete (
       UserNvram->Delete.Values[GuidIndex]->Values,
       UserNvram->Delete.Values[GuidIndex]->Count,
       sizeof (UserNvram->Delete.Values[GuidIndex]->Values[0]),
-      NvramDeleteHasDuplication
+      NvramDeleteHasDuplication,
+      StringEntryHash
       );
   }
 
@@ -282,7 +285,8 @@ CheckNvramDelete (
     UserNvram->Delete.Keys,
     UserNvram->Delete.Count,
     sizeof (UserNvram->Delete.Keys[0]),
-    NvramDeleteHasDuplication
+    NvramDeleteHasDuplication,
+    StringEntryHash
     );
 
   return ErrorCount;
@@ -336,7 +340,8 @@ CheckNvramSchema (
       UserNvram->Legacy.Values[GuidIndex]->Values,
       UserNvram->Legacy.Values[GuidIndex]->Count,
       sizeof (UserNvram->Legacy.Values[GuidIndex]->Values[0]),
-      NvramLegacySchemaHasDuplication
+      NvramLegacySchemaHasDuplication,
+      StringEntryHash
       );
   }
 
@@ -347,7 +352,8 @@ CheckNvramSchema (
     UserNvram->Legacy.Keys,
     UserNvram->Legacy.Count,
     sizeof (UserNvram->Legacy.Keys[0]),
-    NvramLegacySchemaHasDuplication
+    NvramLegacySchemaHasDuplication,
+    StringEntryHash
     );
 
   return ErrorCount;
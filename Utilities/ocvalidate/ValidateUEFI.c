@@ -266,7 +266,8 @@ CheckUEFIDrivers (
     UserUefi->Drivers.Values,
     UserUefi->Drivers.Count,
     sizeof (UserUefi->Drivers.Values[0]),
-    UEFIDriverHasDuplication
+    UEFIDriverHasDuplication,
+    StringEntryHash
     );
 
   IsRequestBootVarRoutingEnabled = UserUefi->Quirks.RequestBootVarRouting;
@@ -517,7 +518,8 @@ CheckUEFIReservedMemory (
     UserUefi->ReservedMemory.Values,
     UserUefi->ReservedMemory.Count,
     sizeof (UserUefi->ReservedMemory.Values[0]),
-    UEFIReservedMemoryHasOverlap
+    UEFIReservedMemoryHasOverlap,
+    NULL
     );
 
   return ErrorCount;
@@ -20,6 +20,10 @@
 
 #include <UserFile.h>
 
+#include <pthread.h>
+#include <stdio.h>
+#include <unistd.h>
+
 UINT32
 CheckConfig (
   IN  OC_GLOBAL_CONFIG  *Config
@@ -60,41 +64,30 @@ CheckConfig (
   return ErrorCount;
 }
 
-int ENTRY_POINT(int argc, const char *argv[]) {
+STATIC
+EFI_STATUS
+ValidateConfigFile (
+  IN  CONST CHAR8  *ConfigFileName,
+  OUT UINT32       *ErrorCount,
+  OUT INT64        *ExecTime
+  )
+{
   UINT8              *ConfigFileBuffer;
   UINT32             ConfigFileSize;
-  CONST CHAR8        *ConfigFileName;
   INT64              ExecTimeStart;
   OC_GLOBAL_CONFIG   Config;
   EFI_STATUS         Status;
-  UINT32             ErrorCount;
-
-  ErrorCount = 0;
-
-  //
-  // Enable PCD debug logging.
-  //
-  PcdGet8  (PcdDebugPropertyMask)         |= DEBUG_PROPERTY_DEBUG_CODE_ENABLED;
-  PcdGet32 (PcdFixedDebugPrintErrorLevel) |= DEBUG_INFO;
-  PcdGet32 (PcdDebugPrintErrorLevel)      |= DEBUG_INFO;
 
-  //
-  // Print usage.
-  //
-  if (argc != 2 || (argc > 1 && AsciiStrCmp (argv[1], "--version") == 0)) {
-    DEBUG ((DEBUG_ERROR, "\nNOTE: This version of ocvalidate is only compatible with OpenCore version %a!\n\n", OPEN_CORE_VERSION));
-    DEBUG ((DEBUG_ERROR, "Usage: %a <path/to/config.plist>\n\n", argv[0]));
-    return -1;
-  }
+  *ErrorCount = 0;
+  *ExecTime   = 0;
 
   //
-  // Read config file (Only one single config is supported).
+  // Read config file.
   //
-  ConfigFileName   = argv[1];
   ConfigFileBuffer = UserReadFile (ConfigFileName, &ConfigFileSize);
   if (ConfigFileBuffer == NULL) {
     DEBUG ((DEBUG_ERROR, "Failed to read %a\n", ConfigFileName));
-    return -1;
+    return EFI_NOT_FOUND;
   }
 
   //
@@ -105,41 +98,450 @@ int ENTRY_POINT(int argc, const char *argv[]) {
   //
   // Initialise config structure to be checked, and exit on error.
   //
-  Status = OcConfigurationInit (&Config, ConfigFileBuffer, ConfigFileSize, &ErrorCount);
+  Status = OcConfigurationInit (&Config, ConfigFileBuffer, ConfigFileSize, ErrorCount);
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_ERROR, "Invalid config\n"));
-    return -1;
+    FreePool (ConfigFileBuffer);
+    return EFI_INVALID_PARAMETER;
   }
-  if (ErrorCount > 0) {
-    DEBUG ((DEBUG_ERROR, "Serialisation returns %u %a!\n", ErrorCount, ErrorCount > 1 ? "errors" : "error"));
+  if (*ErrorCount > 0) {
+    DEBUG ((DEBUG_ERROR, "Serialisation returns %u %a!\n", *ErrorCount, *ErrorCount > 1 ? "errors" : "error"));
   }
 
   //
   // Print a newline that splits errors between OcConfigurationInit and config checkers.
   //
   DEBUG ((DEBUG_ERROR, "\n"));
-  ErrorCount += CheckConfig (&Config);
+  *ErrorCount += CheckConfig (&Config);
 
   OcConfigurationFree (&Config);
   FreePool (ConfigFileBuffer);
 
-  if (ErrorCount == 0) {
+  *ExecTime = GetCurrentTimestamp () - ExecTimeStart;
+
+  if (*ErrorCount == 0) {
     DEBUG ((
       DEBUG_ERROR,
       "Completed validating %a in %llu ms. No issues found.\n",
       ConfigFileName,
-      GetCurrentTimestamp () - ExecTimeStart
+      *ExecTime
       ));
   } else {
     DEBUG ((
       DEBUG_ERROR,
       "Completed validating %a in %llu ms. Found %u %a requiring attention.\n",
       ConfigFileName,
-      GetCurrentTimestamp () - ExecTimeStart,
-      ErrorCount,
-      ErrorCount > 1 ? "issues" : "issue"
+      *ExecTime,
+      *ErrorCount,
+      *ErrorCount > 1 ? "issues" : "issue"
       ));
+  }
+
+  return EFI_SUCCESS;
+}
+
+//
+// Single config validation in batch mode.
+//
+typedef struct {
+  //
+  // Config file name.
+  //
+  CONST CHAR8  *FileName;
+  //
+  // Validation status.
+  //
+  EFI_STATUS   Status;
+  //
+  // Number of issues found.
+  //
+  UINT32       ErrorCount;
+  //
+  // Validation time in milliseconds.
+  //
+  INT64        ExecTime;
+  //
+  // Captured diagnostics.
+  //
+  CHAR8        *Log;
+  //
+  // Captured diagnostics size.
+  //
+  UINTN        LogSize;
+  //
+  // Captured diagnostics allocated size.
+  //
+  UINTN        LogAllocatedSize;
+} CONFIG_VALIDATION;
+
+//
+// Batch mode context shared between workers.
+//
+typedef struct {
+  //
+  // Validations to perform.
+  //
+  CONFIG_VALIDATION  *Validations;
+  //
+  // Number of validations.
+  //
+  UINT32             NumValidations;
+  //
+  // Next validation to pick.
+  //
+  UINT32             NextValidation;
+  //
+  // Lock for NextValidation and printing.
+  //
+  pthread_mutex_t    Lock;
+} CONFIG_BATCH;
+
+//
+// Validation performed by the current thread, diagnostics are captured when set.
+//
+STATIC __thread CONFIG_VALIDATION  *mCurrentValidation;
+
+STATIC EFI_SIMPLE_TEXT_OUTPUT_PROTOCOL  *mOriginalConOut;
+STATIC EFI_SIMPLE_TEXT_OUTPUT_PROTOCOL  mBatchConOut;
+
+STATIC
+EFI_STATUS
+EFIAPI
+BatchOutputString (
+  IN EFI_SIMPLE_TEXT_OUTPUT_PROTOCOL  *This,
+  IN CHAR16                           *String
+  )
+{
+  CONFIG_VALIDATION  *Validation;
+  UINTN              Length;
+  UINTN              NewSize;
+  CHAR8              *NewLog;
+
+  Validation = mCurrentValidation;
+  if (Validation == NULL) {
+    return mOriginalConOut->OutputString (mOriginalConOut, String);
+  }
+
+  Length = StrLen (String);
+  if (Validation->LogSize + Length >= Validation->LogAllocatedSize) {
+    NewSize = MAX (Validation->LogAllocatedSize * 2, Validation->LogSize + Length + SIZE_4KB);
+    NewLog  = ReallocatePool (Validation->LogAllocatedSize, NewSize, Validation->Log);
+    if (NewLog == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+    Validation->Log              = NewLog;
+    Validation->LogAllocatedSize = NewSize;
+  }
+
+  //
+  // Diagnostics are ASCII, see NullTextOutputString.
+  //
+  while (*String != L'\0') {
+    if (*String != L'\r') {
+      Validation->Log[Validation->LogSize++] = (CHAR8) *String;
+    }
+    ++String;
+  }
+
+  return EFI_SUCCESS;
+}
+
+STATIC
+VOID *
+BatchWorker (
+  IN VOID  *Argument
+  )
+{
+  CONFIG_BATCH       *Batch;
+  CONFIG_VALIDATION  *Validation;
+  UINT32             Index;
+
+  Batch = Argument;
+
+  while (TRUE) {
+    pthread_mutex_lock (&Batch->Lock);
+    Index = Batch->NextValidation++;
+    pthread_mutex_unlock (&Batch->Lock);
+
+    if (Index >= Batch->NumValidations) {
+      break;
+    }
+
+    Validation         = &Batch->Validations[Index];
+    mCurrentValidation = Validation;
+    Validation->Status = ValidateConfigFile (Validation->FileName, &Validation->ErrorCount, &Validation->ExecTime);
+    mCurrentValidation = NULL;
+
+    //
+    // Print diagnostics of each config together.
+    //
+    pthread_mutex_lock (&Batch->Lock);
+    if (Validation->LogSize > 0) {
+      fwrite (Validation->Log, 1, Validation->LogSize, stdout);
+    }
+    fputs ("\n", stdout);
+    fflush (stdout);
+    pthread_mutex_unlock (&Batch->Lock);
+  }
+
+  return NULL;
+}
+
+STATIC
+VOID
+WriteJsonString (
+  IN FILE         *File,
+  IN CONST CHAR8  *String
+  )
+{
+  fputc ('"', File);
+  while (*String != '\0') {
+    if (*String == '"' || *String == '\\') {
+      fprintf (File, "\\%c", *String);
+    } else if ((UINT8) *String < 0x20) {
+      fprintf (File, "\\u%04x", (UINT8) *String);
+    } else {
+      fputc (*String, File);
+    }
+    ++String;
+  }
+  fputc ('"', File);
+}
+
+STATIC
+EFI_STATUS
+WriteBatchSummary (
+  IN CONST CHAR8        *SummaryFileName,
+  IN CONFIG_VALIDATION  *Validations,
+  IN UINT32             NumValidations,
+  IN UINT32             NumJobs,
+  IN INT64              ExecTime
+  )
+{
+  FILE         *File;
+  UINT32       Index;
+  UINT32       NumFailed;
+  CONST CHAR8  *Result;
+
+  if (AsciiStrCmp (SummaryFileName, "-") == 0) {
+    File = stdout;
+  } else {
+    File = fopen (SummaryFileName, "w");
+    if (File == NULL) {
+      DEBUG ((DEBUG_ERROR, "Failed to write %a\n", SummaryFileName));
+      return EFI_DEVICE_ERROR;
+    }
+  }
+
+  NumFailed = 0;
+
+  fprintf (File, "{\n  \"version\": ");
+  WriteJsonString (File, OPEN_CORE_VERSION);
+  fprintf (File, ",\n  \"configs\": [\n");
+
+  for (Index = 0; Index < NumValidations; ++Index) {
+    if (Validations[Index].Status == EFI_NOT_FOUND) {
+      Result = "unreadable";
+    } else if (EFI_ERROR (Validations[Index].Status)) {
+      Result = "invalid";
+    } else if (Validations[Index].ErrorCount > 0) {
+      Result = "issues";
+    } else {
+      Result = "ok";
+    }
+
+    if (EFI_ERROR (Validations[Index].Status) || Validations[Index].ErrorCount > 0) {
+      ++NumFailed;
+    }
+
+    fprintf (File, "    {\"path\": ");
+    WriteJsonString (File, Validations[Index].FileName);
+    fprintf (
+      File,
+      ", \"result\": \"%s\", \"issues\": %u, \"time_ms\": %lld}%s\n",
+      Result,
+      Validations[Index].ErrorCount,
+      (long long) Validations[Index].ExecTime,
+      Index + 1 < NumValidations ? "," : ""
+      );
+  }
+
+  fprintf (
+    File,
+    "  ],\n  \"total\": %u,\n  \"failed\": %u,\n  \"jobs\": %u,\n  \"time_ms\": %lld\n}\n",
+    NumValidations,
+    NumFailed,
+    NumJobs,
+    (long long) ExecTime
+    );
+
+  if (File != stdout) {
+    fclose (File);
+  } else {
+    fflush (File);
+  }
+
+  return EFI_SUCCESS;
+}
+
+STATIC
+INT32
+ValidateConfigBatch (
+  IN CONST CHAR8  **FileNames,
+  IN UINT32       NumFileNames,
+  IN UINT32       NumJobs,
+  IN CONST CHAR8  *SummaryFileName  OPTIONAL
+  )
+{
+  CONFIG_BATCH       Batch;
+  pthread_t          *Threads;
+  UINT32             NumThreads;
+  UINT32             Index;
+  UINT32             NumFailed;
+  INT64              ExecTimeStart;
+  INT64              ExecTime;
+
+  if (NumJobs == 0) {
+#ifdef _SC_NPROCESSORS_ONLN
+    NumJobs = (UINT32) MAX (sysconf (_SC_NPROCESSORS_ONLN), 1);
+#else
+    NumJobs = 4;
+#endif
+  }
+  NumJobs = MIN (NumJobs, NumFileNames);
+
+  Batch.Validations = AllocateZeroPool (NumFileNames * sizeof (*Batch.Validations));
+  Threads           = AllocateZeroPool (NumJobs * sizeof (*Threads));
+  if (Batch.Validations == NULL || Threads == NULL) {
+    DEBUG ((DEBUG_ERROR, "Failed to allocate batch of %u configs\n", NumFileNames));
+    return -1;
+  }
+
+  for (Index = 0; Index < NumFileNames; ++Index) {
+    Batch.Validations[Index].FileName = FileNames[Index];
+  }
+  Batch.NumValidations = NumFileNames;
+  Batch.NextValidation = 0;
+  pthread_mutex_init (&Batch.Lock, NULL);
+
+  //
+  // Capture diagnostics per config to avoid interleaving between workers.
+  //
+  mOriginalConOut            = gST->ConOut;
+  CopyMem (&mBatchConOut, mOriginalConOut, sizeof (mBatchConOut));
+  mBatchConOut.OutputString  = BatchOutputString;
+  gST->ConOut                = &mBatchConOut;
+
+  ExecTimeStart = GetCurrentTimestamp ();
+
+  //
+  // The main thread works too if some workers fail to start.
+  //
+  NumThreads = 0;
+  for (Index = 0; Index < NumJobs; ++Index) {
+    if (pthread_create (&Threads[NumThreads], NULL, BatchWorker, &Batch) == 0) {
+      ++NumThreads;
+    }
+  }
+
+  if (NumThreads == 0) {
+    BatchWorker (&Batch);
+  }
+
+  for (Index = 0; Index < NumThreads; ++Index) {
+    pthread_join (Threads[Index], NULL);
+  }
+
+  ExecTime = GetCurrentTimestamp () - ExecTimeStart;
+
+  gST->ConOut = mOriginalConOut;
+  pthread_mutex_destroy (&Batch.Lock);
+
+  NumFailed = 0;
+  for (Index = 0; Index < NumFileNames; ++Index) {
+    if (EFI_ERROR (Batch.Validations[Index].Status) || Batch.Validations[Index].ErrorCount > 0) {
+      ++NumFailed;
+    }
+  }
+
+  DEBUG ((
+    DEBUG_ERROR,
+    "Completed validating %u configs with %u jobs in %llu ms. %u %a requiring attention.\n",
+    NumFileNames,
+    MAX (NumThreads, 1),
+    ExecTime,
+    NumFailed,
+    NumFailed != 1 ? "configs are" : "config is"
+    ));
+
+  if (SummaryFileName != NULL) {
+    WriteBatchSummary (SummaryFileName, Batch.Validations, NumFileNames, MAX (NumThreads, 1), ExecTime);
+  }
+
+  for (Index = 0; Index < NumFileNames; ++Index) {
+    if (Batch.Validations[Index].Log != NULL) {
+      FreePool (Batch.Validations[Index].Log);
+    }
+  }
+  FreePool (Batch.Validations);
+  FreePool (Threads);
+
+  return NumFailed == 0 ? 0 : EXIT_FAILURE;
+}
+
+int ENTRY_POINT(int argc, const char *argv[]) {
+  EFI_STATUS         Status;
+  UINT32             ErrorCount;
+  INT64              ExecTime;
+  INT32              ArgIndex;
+  UINT32             NumJobs;
+  CONST CHAR8        *SummaryFileName;
+
+  //
+  // Enable PCD debug logging.
+  //
+  PcdGet8  (PcdDebugPropertyMask)         |= DEBUG_PROPERTY_DEBUG_CODE_ENABLED;
+  PcdGet32 (PcdFixedDebugPrintErrorLevel) |= DEBUG_INFO;
+  PcdGet32 (PcdDebugPrintErrorLevel)      |= DEBUG_INFO;
+
+  //
+  // Parse batch mode options.
+  //
+  NumJobs         = 0;
+  SummaryFileName = NULL;
+  for (ArgIndex = 1; ArgIndex + 1 < argc; ArgIndex += 2) {
+    if (AsciiStrCmp (argv[ArgIndex], "--jobs") == 0) {
+      NumJobs = (UINT32) AsciiStrDecimalToUintn (argv[ArgIndex + 1]);
+    } else if (AsciiStrCmp (argv[ArgIndex], "--json") == 0) {
+      SummaryFileName = argv[ArgIndex + 1];
+    } else {
+      break;
+    }
+  }
+
+  //
+  // Print usage.
+  //
+  if (ArgIndex >= argc || (argc > 1 && AsciiStrCmp (argv[1], "--version") == 0)) {
+    DEBUG ((DEBUG_ERROR, "\nNOTE: This version of ocvalidate is only compatible with OpenCore version %a!\n\n", OPEN_CORE_VERSION));
+    DEBUG ((DEBUG_ERROR, "Usage: %a <path/to/config.plist>\n", argv[0]));
+    DEBUG ((DEBUG_ERROR, "       %a [--jobs <N>] [--json <path/to/summary.json>] <path/to/config.plist> [...]\n\n", argv[0]));
+    return -1;
+  }
+
+  //
+  // Validate multiple configs concurrently when requested.
+  //
+  if (argc - ArgIndex > 1 || NumJobs > 0 || SummaryFileName != NULL) {
+    return ValidateConfigBatch (&argv[ArgIndex], (UINT32) (argc - ArgIndex), NumJobs, SummaryFileName);
+  }
+
+  Status = ValidateConfigFile (argv[ArgIndex], &ErrorCount, &ExecTime);
+  if (EFI_ERROR (Status)) {
+    return -1;
+  }
 
+  if (ErrorCount != 0) {
     return EXIT_FAILURE;
   }
 
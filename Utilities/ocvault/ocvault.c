@@ -0,0 +1,684 @@
+/** @file
+  Copyright (c) 2021, Acidanthera. All rights reserved.
+  SPDX-License-Identifier: BSD-3-Clause
+**/
+
+#include <Base.h>
+#include <Library/OcCryptoLib.h>
+
+#include <ctype.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <sys/mman.h>
+#include <sys/wait.h>
+#endif
+
+//
+// Matches create_vault.sh, which produces vault.plist with PlistBuddy.
+//
+#define VAULT_VERSION  1
+
+typedef struct {
+  //
+  // Path to the file, used for hashing.
+  //
+  CHAR8    *Path;
+  //
+  // Path relative to OC directory with backslash separators, used as vault key.
+  //
+  CHAR8    *Key;
+  //
+  // File size.
+  //
+  UINT64   Size;
+  //
+  // File SHA-256 hash.
+  //
+  UINT8    Hash[SHA256_DIGEST_SIZE];
+  //
+  // Set when hashing succeeded.
+  //
+  BOOLEAN  Hashed;
+} VAULT_FILE;
+
+typedef struct {
+  VAULT_FILE       *Files;
+  UINT32           NumFiles;
+  UINT32           AllocatedFiles;
+  UINT32           NextFile;
+  pthread_mutex_t  Lock;
+} VAULT_CONTEXT;
+
+STATIC
+UINT64
+GetCurrentTimestamp (
+  VOID
+  )
+{
+  struct timeval  Time;
+
+  gettimeofday (&Time, NULL);
+  return Time.tv_sec * 1000ULL + Time.tv_usec / 1000ULL;
+}
+
+STATIC
+BOOLEAN
+HasPrefixInsensitive (
+  IN CONST CHAR8  *String,
+  IN CONST CHAR8  *Prefix
+  )
+{
+  while (*Prefix != '\0') {
+    if (tolower ((UINT8) *String) != *Prefix) {
+      return FALSE;
+    }
+
+    ++String;
+    ++Prefix;
+  }
+
+  return TRUE;
+}
+
+/**
+  Mirror find filters in create_vault.sh: no vault files and no OpenCore.efi,
+  which is verified by other means. Hidden entries are skipped while walking.
+**/
+STATIC
+BOOLEAN
+IsExcludedFile (
+  IN CONST CHAR8  *Name
+  )
+{
+  if (HasPrefixInsensitive (Name, "vault.")) {
+    return TRUE;
+  }
+
+  return HasPrefixInsensitive (Name, "opencore.efi") && Name[sizeof ("opencore.efi") - 1] == '\0';
+}
+
+STATIC
+BOOLEAN
+AddFile (
+  IN OUT VAULT_CONTEXT  *Context,
+  IN     CONST CHAR8    *Path,
+  IN     CONST CHAR8    *RelativePath,
+  IN     UINT64         Size
+  )
+{
+  VAULT_FILE  *Files;
+  VAULT_FILE  *File;
+  UINT32      NewCount;
+  UINTN       Index;
+
+  if (Context->NumFiles == Context->AllocatedFiles) {
+    NewCount = Context->AllocatedFiles > 0 ? Context->AllocatedFiles * 2 : 256;
+    Files    = realloc (Context->Files, NewCount * sizeof (*Files));
+    if (Files == NULL) {
+      return FALSE;
+    }
+
+    Context->Files          = Files;
+    Context->AllocatedFiles = NewCount;
+  }
+
+  File = &Context->Files[Context->NumFiles];
+  ZeroMem (File, sizeof (*File));
+  File->Path = strdup (Path);
+  File->Key  = strdup (RelativePath);
+  File->Size = Size;
+  if (File->Path == NULL || File->Key == NULL) {
+    free (File->Path);
+    free (File->Key);
+    return FALSE;
+  }
+
+  for (Index = 0; File->Key[Index] != '\0'; ++Index) {
+    if (File->Key[Index] == '/') {
+      File->Key[Index] = '\\';
+    }
+  }
+
+  ++Context->NumFiles;
+  return TRUE;
+}
+
+STATIC
+BOOLEAN
+CollectFiles (
+  IN OUT VAULT_CONTEXT  *Context,
+  IN     CHAR8          *Path,
+  IN     UINTN          PathLength,
+  IN     UINTN          RootLength,
+  IN     UINTN          PathSize
+  )
+{
+  DIR            *Dir;
+  struct dirent  *Entry;
+  struct stat    Stat;
+  UINTN          NameLength;
+  BOOLEAN        Result;
+
+  Dir = opendir (Path);
+  if (Dir == NULL) {
+    printf ("Failed to open directory %s!\n", Path);
+    return FALSE;
+  }
+
+  Result = TRUE;
+
+  while (Result && (Entry = readdir (Dir)) != NULL) {
+    if (Entry->d_name[0] == '.') {
+      continue;
+    }
+
+    NameLength = strlen (Entry->d_name);
+    if (PathLength + 1 + NameLength + 1 > PathSize) {
+      printf ("Path %s/%s is too long!\n", Path, Entry->d_name);
+      Result = FALSE;
+      break;
+    }
+
+    Path[PathLength] = '/';
+    CopyMem (&Path[PathLength + 1], Entry->d_name, NameLength + 1);
+
+    //
+    // find -type f does not follow symlinks.
+    //
+#ifdef _WIN32
+    if (stat (Path, &Stat) != 0) {
+#else
+    if (lstat (Path, &Stat) != 0) {
+#endif
+      printf ("Failed to stat %s!\n", Path);
+      Result = FALSE;
+    } else if (S_ISDIR (Stat.st_mode)) {
+      Result = CollectFiles (Context, Path, PathLength + 1 + NameLength, RootLength, PathSize);
+    } else if (S_ISREG (Stat.st_mode)) {
+      if (!IsExcludedFile (Entry->d_name)) {
+        Result = AddFile (Context, Path, &Path[RootLength + 1], (UINT64) Stat.st_size);
+        if (!Result) {
+          printf ("Failed to allocate memory for %s!\n", Path);
+        }
+      }
+    }
+
+    Path[PathLength] = '\0';
+  }
+
+  closedir (Dir);
+  return Result;
+}
+
+STATIC
+BOOLEAN
+HashFile (
+  IN OUT VAULT_FILE  *File
+  )
+{
+  INT32    Fd;
+  UINT8    *Data;
+  BOOLEAN  Result;
+#ifdef _WIN32
+  UINTN    Offset;
+  INTN     ReadSize;
+#endif
+
+  if (File->Size == 0) {
+    Sha256 (File->Hash, (CONST UINT8 *) "", 0);
+    return TRUE;
+  }
+
+  if (File->Size != (UINTN) File->Size) {
+    return FALSE;
+  }
+
+#ifdef _WIN32
+  //
+  // Text mode would translate line endings and stop at Ctrl+Z.
+  //
+  Fd = open (File->Path, O_RDONLY | O_BINARY);
+#else
+  Fd = open (File->Path, O_RDONLY);
+#endif
+  if (Fd < 0) {
+    return FALSE;
+  }
+
+#ifdef _WIN32
+  Result = FALSE;
+  Data   = malloc ((UINTN) File->Size);
+  if (Data != NULL) {
+    //
+    // read may return less than requested, e.g. for network shares.
+    //
+    Offset = 0;
+    while (Offset < (UINTN) File->Size) {
+      ReadSize = read (Fd, Data + Offset, (UINTN) File->Size - Offset);
+      if (ReadSize <= 0) {
+        break;
+      }
+
+      Offset += (UINTN) ReadSize;
+    }
+
+    Result = Offset == (UINTN) File->Size;
+    if (Result) {
+      Sha256 (File->Hash, Data, (UINTN) File->Size);
+    }
+
+    free (Data);
+  }
+#else
+  //
+  // Map the file to avoid copying, page cache is shared between workers anyway.
+  //
+  Data = mmap (NULL, (UINTN) File->Size, PROT_READ, MAP_PRIVATE, Fd, 0);
+  Result = Data != MAP_FAILED;
+  if (Result) {
+    Sha256 (File->Hash, Data, (UINTN) File->Size);
+    munmap (Data, (UINTN) File->Size);
+  }
+#endif
+
+  close (Fd);
+  return Result;
+}
+
+STATIC
+VOID *
+HashWorker (
+  IN VOID  *Argument
+  )
+{
+  VAULT_CONTEXT  *Context;
+  UINT32         Index;
+
+  Context = Argument;
+
+  while (TRUE) {
+    pthread_mutex_lock (&Context->Lock);
+    Index = Context->NextFile;
+    if (Index < Context->NumFiles) {
+      ++Context->NextFile;
+    }
+    pthread_mutex_unlock (&Context->Lock);
+
+    if (Index >= Context->NumFiles) {
+      break;
+    }
+
+    Context->Files[Index].Hashed = HashFile (&Context->Files[Index]);
+  }
+
+  return NULL;
+}
+
+STATIC
+int
+CompareFiles (
+  IN CONST VOID  *First,
+  IN CONST VOID  *Second
+  )
+{
+  //
+  // CoreFoundation writes dictionary keys sorted.
+  //
+  return strcmp (((CONST VAULT_FILE *) First)->Key, ((CONST VAULT_FILE *) Second)->Key);
+}
+
+STATIC
+VOID
+WriteEscapedString (
+  IN FILE         *Out,
+  IN CONST CHAR8  *String
+  )
+{
+  while (*String != '\0') {
+    if (*String == '&') {
+      fputs ("&amp;", Out);
+    } else if (*String == '<') {
+      fputs ("&lt;", Out);
+    } else if (*String == '>') {
+      fputs ("&gt;", Out);
+    } else {
+      fputc (*String, Out);
+    }
+
+    ++String;
+  }
+}
+
+STATIC
+VOID
+WriteBase64 (
+  IN FILE         *Out,
+  IN CONST UINT8  *Data,
+  IN UINTN        Size
+  )
+{
+  STATIC CONST CHAR8  Alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  UINTN               Index;
+  UINT32              Triple;
+
+  for (Index = 0; Index < Size; Index += 3) {
+    Triple = (UINT32) Data[Index] << 16U;
+    if (Index + 1 < Size) {
+      Triple |= (UINT32) Data[Index + 1] << 8U;
+    }
+    if (Index + 2 < Size) {
+      Triple |= Data[Index + 2];
+    }
+
+    fputc (Alphabet[(Triple >> 18U) & 0x3FU], Out);
+    fputc (Alphabet[(Triple >> 12U) & 0x3FU], Out);
+    fputc (Index + 1 < Size ? Alphabet[(Triple >> 6U) & 0x3FU] : '=', Out);
+    fputc (Index + 2 < Size ? Alphabet[Triple & 0x3FU] : '=', Out);
+  }
+}
+
+/**
+  Write vault.plist in the exact format produced by PlistBuddy.
+**/
+STATIC
+BOOLEAN
+WriteVault (
+  IN CONST CHAR8    *VaultPath,
+  IN VAULT_CONTEXT  *Context
+  )
+{
+  FILE    *Out;
+  UINT32  Index;
+  BOOLEAN Result;
+
+  Out = fopen (VaultPath, "wb");
+  if (Out == NULL) {
+    return FALSE;
+  }
+
+  fputs (
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+    "<!DOCTYPE plist PUBLIC \"-//Apple//DTD PLIST 1.0//EN\" \"http://www.apple.com/DTDs/PropertyList-1.0.dtd\">\n"
+    "<plist version=\"1.0\">\n"
+    "<dict>\n",
+    Out
+    );
+
+  if (Context->NumFiles > 0) {
+    fputs ("\t<key>Files</key>\n\t<dict>\n", Out);
+    for (Index = 0; Index < Context->NumFiles; ++Index) {
+      fputs ("\t\t<key>", Out);
+      WriteEscapedString (Out, Context->Files[Index].Key);
+      fputs ("</key>\n\t\t<data>\n\t\t", Out);
+      WriteBase64 (Out, Context->Files[Index].Hash, sizeof (Context->Files[Index].Hash));
+      fputs ("\n\t\t</data>\n", Out);
+    }
+    fputs ("\t</dict>\n", Out);
+  }
+
+  fprintf (
+    Out,
+    "\t<key>Version</key>\n"
+    "\t<integer>%d</integer>\n"
+    "</dict>\n"
+    "</plist>\n",
+    VAULT_VERSION
+    );
+
+  Result = ferror (Out) == 0;
+  return fclose (Out) == 0 && Result;
+}
+
+STATIC
+BOOLEAN
+SignVault (
+  IN CONST CHAR8  *RsaTool,
+  IN CONST CHAR8  *VaultPath,
+  IN CONST CHAR8  *SignaturePath,
+  IN CONST CHAR8  *PublicKeyPath
+  )
+{
+  CONST CHAR8  *Arguments[6];
+
+  Arguments[0] = RsaTool;
+  Arguments[1] = "-sign";
+  Arguments[2] = VaultPath;
+  Arguments[3] = SignaturePath;
+  Arguments[4] = PublicKeyPath;
+  Arguments[5] = NULL;
+
+#ifdef _WIN32
+  return _spawnvp (_P_WAIT, RsaTool, Arguments) == 0;
+#else
+  pid_t  Pid;
+  int    Status;
+
+  Pid = fork ();
+  if (Pid < 0) {
+    return FALSE;
+  }
+
+  if (Pid == 0) {
+    execvp (RsaTool, (char * CONST *) Arguments);
+    _exit (127);
+  }
+
+  if (waitpid (Pid, &Status, 0) != Pid) {
+    return FALSE;
+  }
+
+  return WIFEXITED (Status) && WEXITSTATUS (Status) == 0;
+#endif
+}
+
+STATIC
+int
+Usage (
+  IN CONST CHAR8  *Name
+  )
+{
+  printf (
+    "Usage: %s [--jobs <N>] [--sign <vault.pub> [--rsatool <path/to/RsaTool>]] path/to/EFI/OC\n",
+    Name
+    );
+  return EXIT_FAILURE;
+}
+
+int
+ENTRY_POINT (
+  int   argc,
+  char  *argv[]
+  )
+{
+  VAULT_CONTEXT  Context;
+  CONST CHAR8    *OcPath;
+  CONST CHAR8    *PublicKeyPath;
+  CONST CHAR8    *RsaTool;
+  CONST CHAR8    *Separator;
+  CHAR8          Path[4096];
+  CHAR8          VaultPath[4096];
+  CHAR8          SignaturePath[4096];
+  UINTN          PathLength;
+  UINT32         NumJobs;
+  UINT32         NumThreads;
+  UINT32         Index;
+  UINT64         StartTime;
+  UINT64         TotalSize;
+  pthread_t      *Threads;
+  int            Arg;
+  BOOLEAN        Result;
+
+  OcPath        = NULL;
+  PublicKeyPath = NULL;
+  RsaTool       = NULL;
+  NumJobs       = 0;
+
+  for (Arg = 1; Arg < argc; ++Arg) {
+    if (strcmp (argv[Arg], "--jobs") == 0 && Arg + 1 < argc) {
+      NumJobs = (UINT32) atoi (argv[++Arg]);
+      if (NumJobs == 0) {
+        return Usage (argv[0]);
+      }
+    } else if (strcmp (argv[Arg], "--sign") == 0 && Arg + 1 < argc) {
+      PublicKeyPath = argv[++Arg];
+    } else if (strcmp (argv[Arg], "--rsatool") == 0 && Arg + 1 < argc) {
+      RsaTool = argv[++Arg];
+    } else if (OcPath == NULL && argv[Arg][0] != '-') {
+      OcPath = argv[Arg];
+    } else {
+      return Usage (argv[0]);
+    }
+  }
+
+  if (OcPath == NULL) {
+    return Usage (argv[0]);
+  }
+
+  PathLength = strlen (OcPath);
+  while (PathLength > 1 && OcPath[PathLength - 1] == '/') {
+    --PathLength;
+  }
+
+  if (PathLength + sizeof ("/vault.plist") > sizeof (Path)) {
+    printf ("Path %s is too long!\n", OcPath);
+    return EXIT_FAILURE;
+  }
+
+  CopyMem (Path, OcPath, PathLength);
+  Path[PathLength] = '\0';
+  snprintf (VaultPath, sizeof (VaultPath), "%s/vault.plist", Path);
+  snprintf (SignaturePath, sizeof (SignaturePath), "%s/vault.sig", Path);
+
+  if (NumJobs == 0) {
+#ifdef _SC_NPROCESSORS_ONLN
+    NumJobs = (UINT32) MAX (sysconf (_SC_NPROCESSORS_ONLN), 1);
+#else
+    NumJobs = 4;
+#endif
+  }
+
+  printf ("Chose %s for hashing...\n", Path);
+
+  remove (VaultPath);
+  remove (SignaturePath);
+
+  ZeroMem (&Context, sizeof (Context));
+  pthread_mutex_init (&Context.Lock, NULL);
+
+  StartTime = GetCurrentTimestamp ();
+  printf ("Hashing files in %s...\n", Path);
+
+  Result = CollectFiles (&Context, Path, PathLength, PathLength, sizeof (Path));
+
+  Threads = NULL;
+  if (Result && Context.NumFiles > 0) {
+    NumJobs = MIN (NumJobs, Context.NumFiles);
+    Threads = calloc (NumJobs, sizeof (*Threads));
+    Result  = Threads != NULL;
+  }
+
+  NumThreads = 0;
+  if (Result && Context.NumFiles > 0) {
+    for (Index = 0; Index < NumJobs; ++Index) {
+      if (pthread_create (&Threads[NumThreads], NULL, HashWorker, &Context) == 0) {
+        ++NumThreads;
+      }
+    }
+
+    //
+    // Hash remaining files on this thread, in case no worker could be started.
+    //
+    HashWorker (&Context);
+
+    for (Index = 0; Index < NumThreads; ++Index) {
+      pthread_join (Threads[Index], NULL);
+    }
+  }
+
+  TotalSize = 0;
+  for (Index = 0; Result && Index < Context.NumFiles; ++Index) {
+    if (!Context.Files[Index].Hashed) {
+      printf ("Failed to hash %s!\n", Context.Files[Index].Path);
+      Result = FALSE;
+    }
+
+    TotalSize += Context.Files[Index].Size;
+  }
+
+  if (Result) {
+    qsort (Context.Files, Context.NumFiles, sizeof (*Context.Files), CompareFiles);
+
+    for (Index = 0; Index < Context.NumFiles; ++Index) {
+      printf ("%s: ", Context.Files[Index].Key);
+      for (PathLength = 0; PathLength < SHA256_DIGEST_SIZE; ++PathLength) {
+        printf ("%02x", Context.Files[Index].Hash[PathLength]);
+      }
+      printf ("\n");
+    }
+
+    Result = WriteVault (VaultPath, &Context);
+    if (!Result) {
+      printf ("Failed to write %s!\n", VaultPath);
+    }
+  }
+
+  if (Result) {
+    printf (
+      "Hashed %u files (%llu bytes) in %llu ms with %u threads\n",
+      Context.NumFiles,
+      (unsigned long long) TotalSize,
+      (unsigned long long) (GetCurrentTimestamp () - StartTime),
+      MAX (NumThreads, 1)
+      );
+  }
+
+  if (Result && PublicKeyPath != NULL) {
+    //
+    // Prefer RsaTool next to this binary, as sign.command does. When run
+    // from PATH there is no directory to look in, so rely on PATH as well.
+    //
+    Separator = RsaTool == NULL ? strrchr (argv[0], '/') : NULL;
+    if (Separator != NULL) {
+      snprintf (Path, sizeof (Path), "%.*s/RsaTool", (int) (Separator - argv[0]), argv[0]);
+      RsaTool = Path;
+    } else if (RsaTool == NULL) {
+      RsaTool = "RsaTool";
+    }
+
+    printf ("Signing %s...\n", VaultPath);
+    Result = SignVault (RsaTool, VaultPath, SignaturePath, PublicKeyPath);
+    if (!Result) {
+      printf ("Failed to sign %s with %s!\n", VaultPath, RsaTool);
+    }
+  }
+
+  for (Index = 0; Index < Context.NumFiles; ++Index) {
+    free (Context.Files[Index].Path);
+    free (Context.Files[Index].Key);
+  }
+
+  free (Context.Files);
+  free (Threads);
+  pthread_mutex_destroy (&Context.Lock);
+
+  if (!Result) {
+    remove (VaultPath);
+    remove (SignaturePath);
+    printf ("Fatal error: vault creation failed!\n");
+    return EXIT_FAILURE;
+  }
+
+  printf ("All done!\n");
+  return EXIT_SUCCESS;
+}